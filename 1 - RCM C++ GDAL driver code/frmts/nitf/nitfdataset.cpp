@@ -44,6 +44,7 @@
 #endif
 #include <algorithm>
 #include <memory>
+#include <new>
 #include <string>
 #include <vector>
 
@@ -102,6 +103,8 @@ NITFDataset::NITFDataset() :
     panJPEGBlockOffset(nullptr),
     pabyJPEGBlock(nullptr),
     nQLevel(0),
+    nInterleavedBlockXOff(-1),
+    nInterleavedBlockYOff(-1),
     nIMIndex(0),
     papszTextMDToWrite(nullptr),
     papszCgmMDToWrite(nullptr),
@@ -3817,6 +3820,216 @@ CPLErr NITFDataset::ReadJPEGBlock( int iBlockX, int iBlockY )
     return eErr;
 }
 
+/************************************************************************/
+/*                      CanReadInterleavedBlocks()                      */
+/*                                                                      */
+/*      Uncompressed pixel or row interleaved images store a block of   */
+/*      every band in one region of the file. NITFReadImageBlock()      */
+/*      reads that whole region for each band, so the bands read it     */
+/*      once through ReadInterleavedBlock() instead.                    */
+/************************************************************************/
+
+bool NITFDataset::CanReadInterleavedBlocks()
+
+{
+    return psImage != nullptr &&
+           eAccess == GA_ReadOnly &&
+           psImage->nBands > 1 &&
+           (psImage->chIMODE == 'P' || psImage->chIMODE == 'R') &&
+           EQUAL(psImage->szIC, "NC") &&
+           psImage->nBitsPerSample == psImage->nWordSize * 8 &&
+           psImage->panBlockStart != nullptr;
+}
+
+/************************************************************************/
+/*                        ReadInterleavedBlock()                        */
+/*                                                                      */
+/*      Read the block of all the bands into abyInterleavedBlock,       */
+/*      unless it is already there. In scanline access the "block" is  */
+/*      line nBlockYOff. *pbMissing is set for blocks that are not      */
+/*      stored, or not laid out as expected, which the bands then read  */
+/*      on their own.                                                   */
+/************************************************************************/
+
+CPLErr NITFDataset::ReadInterleavedBlock( int nBlockXOff, int nBlockYOff,
+                                          bool bScanline, bool *pbMissing )
+
+{
+    *pbMissing = false;
+    if( nInterleavedBlockXOff == nBlockXOff &&
+        nInterleavedBlockYOff == nBlockYOff )
+        return CE_None;
+
+    const int nBlocks = psImage->nBlocksPerRow * psImage->nBlocksPerColumn;
+    const int iBlock =
+        bScanline ? 0 : nBlockXOff + nBlockYOff * psImage->nBlocksPerRow;
+    const int nLines = bScanline ? 1 : psImage->nBlockHeight;
+
+/* -------------------------------------------------------------------- */
+/*      Position of every band relative to the first one.               */
+/* -------------------------------------------------------------------- */
+    const GUIntBig nStart = psImage->panBlockStart[iBlock];
+    if( nStart == UINT_MAX )
+    {
+        *pbMissing = true;
+        return CE_None;
+    }
+
+    anInterleavedBandOffset.resize(psImage->nBands);
+    GUIntBig nLastOffset = 0;
+    for( int iBand = 0; iBand < psImage->nBands; iBand++ )
+    {
+        const GUIntBig nBandStart =
+            psImage->panBlockStart[iBlock + static_cast<size_t>(iBand) * nBlocks];
+        if( nBandStart == UINT_MAX || nBandStart < nStart ||
+            nBandStart - nStart >= psImage->nLineOffset )
+        {
+            *pbMissing = true;
+            return CE_None;
+        }
+        anInterleavedBandOffset[iBand] = nBandStart - nStart;
+        nLastOffset = std::max(nLastOffset, nBandStart - nStart);
+    }
+
+    const GUIntBig nSize =
+        nLastOffset +
+        psImage->nLineOffset * (nLines - 1) +
+        psImage->nPixelOffset * (psImage->nBlockWidth - 1) +
+        psImage->nWordSize;
+    if( static_cast<size_t>(nSize) != nSize )
+    {
+        *pbMissing = true;
+        return CE_None;
+    }
+
+/* -------------------------------------------------------------------- */
+/*      Read it.                                                        */
+/* -------------------------------------------------------------------- */
+    nInterleavedBlockXOff = -1;
+    nInterleavedBlockYOff = -1;
+
+    try
+    {
+        abyInterleavedBlock.resize(static_cast<size_t>(nSize));
+    }
+    catch( const std::bad_alloc& )
+    {
+        CPLError( CE_Failure, CPLE_OutOfMemory,
+                  "Cannot allocate " CPL_FRMT_GUIB " bytes.", nSize );
+        return CE_Failure;
+    }
+
+    const GUIntBig nOffset = nStart +
+        (bScanline ? psImage->nLineOffset * nBlockYOff : 0);
+    if( VSIFSeekL( psImage->psFile->fp, nOffset, SEEK_SET ) != 0 ||
+        VSIFReadL( abyInterleavedBlock.data(), 1, static_cast<size_t>(nSize),
+                   psImage->psFile->fp ) != static_cast<size_t>(nSize) )
+    {
+        CPLError( CE_Failure, CPLE_FileIO,
+                  "Unable to read " CPL_FRMT_GUIB " byte block from "
+                  CPL_FRMT_GUIB ".", nSize, nOffset );
+        return CE_Failure;
+    }
+
+    nInterleavedBlockXOff = nBlockXOff;
+    nInterleavedBlockYOff = nBlockYOff;
+    return CE_None;
+}
+
+/************************************************************************/
+/*                        CopyInterleavedBlock()                        */
+/*                                                                      */
+/*      Copy nImageBandCount consecutive bands of abyInterleavedBlock,  */
+/*      from nImageBand (1 based), pixel interleaved into pDst, in the  */
+/*      byte order of the host as NITFReadImageBlock() returns them.    */
+/************************************************************************/
+
+void NITFDataset::CopyInterleavedBlock( int nImageBand, int nImageBandCount,
+                                        int nLines, void *pDst )
+
+{
+    const int nWordSize = psImage->nWordSize;
+    GDALDataType eWordType = GDT_Byte;
+    if( nWordSize == 2 )
+        eWordType = GDT_UInt16;
+    else if( nWordSize == 4 )
+        eWordType = GDT_UInt32;
+    else if( nWordSize == 8 )
+        eWordType = GDT_Float64;
+
+    const int nPixelSpace = nWordSize * nImageBandCount;
+    GByte *pabyDst = static_cast<GByte *>(pDst);
+    for( int iLine = 0; iLine < nLines; iLine++ )
+    {
+        for( int i = 0; i < nImageBandCount; i++ )
+        {
+            GDALCopyWords( abyInterleavedBlock.data() +
+                               anInterleavedBandOffset[nImageBand - 1 + i] +
+                               psImage->nLineOffset * iLine,
+                           eWordType, static_cast<int>(psImage->nPixelOffset),
+                           pabyDst + static_cast<size_t>(iLine) *
+                               psImage->nBlockWidth * nPixelSpace + i * nWordSize,
+                           eWordType, nPixelSpace, psImage->nBlockWidth );
+        }
+    }
+
+#ifdef CPL_LSB
+    // NITF samples are big endian, complex ones as two words.
+    const size_t nWords =
+        static_cast<size_t>(psImage->nBlockWidth) * nLines * nImageBandCount;
+    if( nWordSize > 1 && EQUAL(psImage->szPVType, "C") )
+        GDALSwapWords( pDst, nWordSize / 2, static_cast<int>(2 * nWords),
+                       nWordSize / 2 );
+    else if( nWordSize > 1 )
+        GDALSwapWords( pDst, nWordSize, static_cast<int>(nWords), nWordSize );
+#endif
+}
+
+/************************************************************************/
+/*                       FillCacheForOtherBands()                       */
+/*                                                                      */
+/*      Copy the interleaved block into the block cache of the other    */
+/*      bands of the dataset that do not hold it yet, as GTiff does     */
+/*      for pixel interleaved files, so that a multi-band read decodes  */
+/*      each block once. Only done when the cache can hold a block of   */
+/*      every band.                                                     */
+/************************************************************************/
+
+void NITFDataset::FillCacheForOtherBands( NITFRasterBand *poSkipBand,
+                                          int nBlockXOff, int nBlockYOff )
+
+{
+    const GIntBig nBlockBytes =
+        static_cast<GIntBig>(psImage->nBlockWidth) * psImage->nBlockHeight *
+        psImage->nWordSize;
+    if( GDALGetCacheMax64() < nBlockBytes * psImage->nBands )
+        return;
+
+    for( int iBand = 1; iBand <= nBands; iBand++ )
+    {
+        NITFRasterBand *poBand =
+            dynamic_cast<NITFRasterBand *>( GetRasterBand(iBand) );
+        if( poBand == nullptr || poBand == poSkipBand )
+            continue;
+
+        GDALRasterBlock *poBlock =
+            poBand->TryGetLockedBlockRef( nBlockXOff, nBlockYOff );
+        if( poBlock != nullptr )
+        {
+            poBlock->DropLock();
+            continue;
+        }
+
+        poBlock = poBand->GetLockedBlockRef( nBlockXOff, nBlockYOff, TRUE );
+        if( poBlock == nullptr )
+            continue;
+
+        CopyInterleavedBlock( poBand->nImageBand, poBand->nImageBandCount,
+                              poBand->nBlockYSize, poBlock->GetDataRef() );
+        poBlock->DropLock();
+    }
+}
+
 /************************************************************************/
 /*                            GetFileList()                             */
 /************************************************************************/
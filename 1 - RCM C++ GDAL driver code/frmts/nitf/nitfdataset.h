@@ -36,6 +36,7 @@
 #include "ogr_spatialref.h"
 #include "gdal_proxy.h"
 #include <map>
+#include <vector>
 
 CPLErr NITFSetColorInterpretation( NITFImage *psImage,
                                    int nBand,
@@ -105,6 +106,21 @@ class NITFDataset final: public GDALPamDataset
     int          ScanJPEGQLevel( GUIntBig *pnDataStart, bool *pbError );
     CPLErr       ScanJPEGBlocks();
     CPLErr       ReadJPEGBlock( int, int );
+
+    // Last block of an uncompressed pixel or row interleaved (IMODE=P/R)
+    // image, read once for all the bands, as stored in the file.
+    std::vector<GByte> abyInterleavedBlock;
+    int          nInterleavedBlockXOff;
+    int          nInterleavedBlockYOff;
+    std::vector<GUIntBig> anInterleavedBandOffset;
+
+    bool         CanReadInterleavedBlocks();
+    CPLErr       ReadInterleavedBlock( int nBlockXOff, int nBlockYOff,
+                                       bool bScanline, bool *pbMissing );
+    void         CopyInterleavedBlock( int nImageBand, int nImageBandCount,
+                                       int nLines, void *pDst );
+    void         FillCacheForOtherBands( NITFRasterBand *poSkipBand,
+                                         int nBlockXOff, int nBlockYOff );
     void         CheckGeoSDEInfo();
     char**       AddFile(char **papszFileList, const char* EXTENSION, const char* extension);
 
@@ -196,6 +212,14 @@ class NITFRasterBand: public GDALPamRasterBand
 
     int          bScanlineAccess;
 
+  protected:
+    // Bands of the image held by this band, 2 for an I/Q complex band
+    int          nImageBand;
+    int          nImageBandCount;
+
+    int          ReadFromInterleavedBlock( int nBlockXOff, int nBlockYOff,
+                                           void *pImage, CPLErr *peErr );
+
   public:
                    NITFRasterBand( NITFDataset *, int );
     virtual ~NITFRasterBand();
@@ -209,6 +233,11 @@ class NITFRasterBand: public GDALPamRasterBand
     virtual CPLErr SetColorTable( GDALColorTable * ) override;
     virtual double GetNoDataValue( int *pbSuccess = nullptr ) override;
 
+    virtual CPLVirtualMem *GetVirtualMemAuto( GDALRWFlag eRWFlag,
+                                              int *pnPixelSpace,
+                                              GIntBig *pnLineSpace,
+                                              char **papszOptions ) override;
+
     void Unpack(GByte* pData);
 };
 
@@ -366,15 +395,24 @@ class NITFWrapperRasterBand final: public NITFProxyPamRasterBand
 /************************************************************************/
 
 /* This class is used to wrap 2 bands (I and Q) as a complex raster band */
+/* Blocks are read from the I and Q bands straight into a scratch       */
+/* buffer and interleaved there, or taken from the block of all bands   */
+/* of a pixel or row interleaved image. Writes, and reads in update     */
+/* mode or of differently blocked bands, go through poIntermediateDS,   */
+/* which is only built for them and then owns the I and Q bands.        */
 class NITFComplexRasterBand : public NITFRasterBand
 {
+	GDALRasterBand* poBandI;
+	GDALRasterBand* poBandQ;
 	NITFDataset* poIntermediateDS;
 	int nBandMap[2];
 	GDALDataType underlyingDataType;
 	int complexDataTypeSize;
 	int underlyingDataTypeSize;
+	GByte* pabyIQBlock;     /* one block of I followed by one block of Q */
 
 private:
+	NITFDataset* GetIntermediateDS();
 	CPLErr IBlockIO(int nBlockXOff, int nBlockYOff,
 		void * pImage, GDALRWFlag rwFlag);
 
@@ -387,4 +425,10 @@ public:
 
 	virtual CPLErr IReadBlock(int, int, void *);
 	virtual CPLErr IWriteBlock(int, int, void *);
+
+	/* Planar access for the readers that want I and Q apart */
+	GDALRasterBand* GetIBand() { return poBandI; }
+	GDALRasterBand* GetQBand() { return poBandQ; }
+	GDALDataType GetIQDataType() const { return underlyingDataType; }
+	CPLErr ReadPlanarBlock(int nBlockXOff, int nBlockYOff, void *pI, void *pQ);
 };
\ No newline at end of file
@@ -0,0 +1,148 @@
+/************************************************************************/
+/*                            nitfiq_bench                              */
+/************************************************************************/
+/* Compares the reads of a NITFComplexRasterBand, which read the I and  */
+/* Q blocks directly and interleave them with NITFInterleaveIQ(), with  */
+/* the former path: a two-band RasterIO of the I and Q bands into the   */
+/* interleaved buffer, through their block cache, as the intermediate   */
+/* dataset did. Every block of the band is read by both paths, compared */
+/* over its valid region, and each path is timed over the whole band,   */
+/* after a first pass that warms the OS file cache.                     */
+/*                                                                      */
+/* Not part of the driver build. It needs the NITFComplexRasterBand     */
+/* class, so link it against the libgdal built from this tree, from     */
+/* frmts/nitf of the GDAL source tree:                                  */
+/*                                                                      */
+/*   g++ -O2 -I../../port -I../../gcore -I../vrt nitfiq_bench.cpp \     */
+/*       -o nitfiq_bench -lgdal                                         */
+/*   ./nitfiq_bench image.ntf [band]                                    */
+/*                                                                      */
+/* image.ntf is a SAR NITF whose I and Q bands are exposed as complex.  */
+/************************************************************************/
+
+#include "cpl_port.h"
+#include "gdal_priv.h"
+#include "nitfdataset.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include <vector>
+
+/*** Function to read one block through the I and Q bands, as the intermediate dataset did ***/
+static CPLErr ReadBlockTwoBands(NITFComplexRasterBand *poBand, int nBlockXOff, int nBlockYOff,
+	GByte *pabyBlock)
+{
+	int nBlockXSize, nBlockYSize;
+	poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+	const int nXOff = nBlockXOff * nBlockXSize;
+	const int nYOff = nBlockYOff * nBlockYSize;
+	const int nXSize = std::min(nBlockXSize, poBand->GetXSize() - nXOff);
+	const int nYSize = std::min(nBlockYSize, poBand->GetYSize() - nYOff);
+
+	const GDALDataType eIQType = poBand->GetIQDataType();
+	const int nWordSize = GDALGetDataTypeSizeBytes(eIQType);
+	memset(pabyBlock, 0, static_cast<size_t>(nBlockXSize) * nBlockYSize * 2 * nWordSize);
+
+	CPLErr eErr = poBand->GetIBand()->RasterIO(GF_Read, nXOff, nYOff, nXSize, nYSize,
+		pabyBlock, nXSize, nYSize, eIQType, 2 * nWordSize,
+		static_cast<GSpacing>(2) * nWordSize * nBlockXSize, NULL);
+	if (eErr == CE_None)
+		eErr = poBand->GetQBand()->RasterIO(GF_Read, nXOff, nYOff, nXSize, nYSize,
+			pabyBlock + nWordSize, nXSize, nYSize, eIQType, 2 * nWordSize,
+			static_cast<GSpacing>(2) * nWordSize * nBlockXSize, NULL);
+	return eErr;
+}
+
+/*** Function to time one pass of a path over every block, in seconds, -1 on error ***/
+static double TimePass(NITFComplexRasterBand *poBand, bool bTwoBands, GByte *pabyBlock)
+{
+	int nBlockXSize, nBlockYSize;
+	poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+	const int nBlocksX = (poBand->GetXSize() + nBlockXSize - 1) / nBlockXSize;
+	const int nBlocksY = (poBand->GetYSize() + nBlockYSize - 1) / nBlockYSize;
+
+	/* Start both paths with empty I and Q block caches */
+	poBand->GetIBand()->FlushCache();
+	poBand->GetQBand()->FlushCache();
+
+	const std::chrono::steady_clock::time_point oStart = std::chrono::steady_clock::now();
+	for (int j = 0; j < nBlocksY; j++) {
+		for (int i = 0; i < nBlocksX; i++) {
+			const CPLErr eErr = bTwoBands ? ReadBlockTwoBands(poBand, i, j, pabyBlock)
+				: poBand->ReadBlock(i, j, pabyBlock);
+			if (eErr != CE_None)
+				return -1.0;
+		}
+	}
+	return std::chrono::duration<double>(std::chrono::steady_clock::now() - oStart).count();
+}
+
+int main(int argc, char **argv)
+{
+	if (argc < 2) {
+		fprintf(stderr, "Usage: nitfiq_bench image.ntf [band]\n");
+		return 1;
+	}
+
+	GDALAllRegister();
+	GDALDataset *poDS = static_cast<GDALDataset *>(GDALOpen(argv[1], GA_ReadOnly));
+	if (poDS == NULL)
+		return 1;
+
+	const int nBand = argc > 2 ? atoi(argv[2]) : 1;
+	NITFComplexRasterBand *poBand = nBand >= 1 && nBand <= poDS->GetRasterCount()
+		? dynamic_cast<NITFComplexRasterBand *>(poDS->GetRasterBand(nBand)) : NULL;
+	if (poBand == NULL) {
+		fprintf(stderr, "Band %d is not a NITF I/Q complex band.\n", nBand);
+		GDALClose(poDS);
+		return 1;
+	}
+
+	int nBlockXSize, nBlockYSize;
+	poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+	const int nWordSize = GDALGetDataTypeSizeBytes(poBand->GetIQDataType());
+	const size_t nBlockBytes = static_cast<size_t>(nBlockXSize) * nBlockYSize * 2 * nWordSize;
+	std::vector<GByte> abyDirect(nBlockBytes), abyTwoBands(nBlockBytes);
+
+	/* Equality over the valid region of every block */
+	const int nBlocksX = (poBand->GetXSize() + nBlockXSize - 1) / nBlockXSize;
+	const int nBlocksY = (poBand->GetYSize() + nBlockYSize - 1) / nBlockYSize;
+	int nMismatches = 0;
+	for (int j = 0; j < nBlocksY; j++) {
+		for (int i = 0; i < nBlocksX; i++) {
+			if (poBand->ReadBlock(i, j, abyDirect.data()) != CE_None
+				|| ReadBlockTwoBands(poBand, i, j, abyTwoBands.data()) != CE_None) {
+				GDALClose(poDS);
+				return 1;
+			}
+
+			const int nXSize = std::min(nBlockXSize, poBand->GetXSize() - i * nBlockXSize);
+			const int nYSize = std::min(nBlockYSize, poBand->GetYSize() - j * nBlockYSize);
+			const size_t nLineBytes = static_cast<size_t>(nBlockXSize) * 2 * nWordSize;
+			for (int k = 0; k < nYSize; k++) {
+				if (memcmp(abyDirect.data() + k * nLineBytes, abyTwoBands.data() + k * nLineBytes,
+					static_cast<size_t>(nXSize) * 2 * nWordSize) != 0) {
+					nMismatches++;
+					break;
+				}
+			}
+		}
+	}
+	printf("%d x %d blocks of %d x %d %s, %d block(s) differ\n", nBlocksX, nBlocksY,
+		nBlockXSize, nBlockYSize, GDALGetDataTypeName(poBand->GetRasterDataType()), nMismatches);
+
+	/* The comparison above warmed the OS file cache for both timings */
+	const double dfTwoBands = TimePass(poBand, true, abyTwoBands.data());
+	const double dfDirect = TimePass(poBand, false, abyDirect.data());
+	if (dfTwoBands >= 0.0 && dfDirect >= 0.0) {
+		const double dfMBytes = static_cast<double>(nBlockBytes) * nBlocksX * nBlocksY / 1e6;
+		printf("two-band RasterIO: %8.1f MB/s\n", dfMBytes / dfTwoBands);
+		printf("direct + interleave: %6.1f MB/s (x%.2f)\n", dfMBytes / dfDirect, dfTwoBands / dfDirect);
+	}
+
+	GDALClose(poDS);
+	return nMismatches == 0 ? 0 : 2;
+}
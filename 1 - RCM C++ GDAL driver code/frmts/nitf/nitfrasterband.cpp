@@ -47,6 +47,7 @@
 #include "cpl_error.h"
 #include "cpl_progress.h"
 #include "cpl_string.h"
+#include "cpl_virtualmem.h"
 #include "cpl_vsi.h"
 #include "gdal.h"
 #include "gdal_pam.h"
@@ -371,7 +372,9 @@ NITFRasterBand::NITFRasterBand( NITFDataset *poDSIn, int nBandIn ) :
     psImage(poDSIn->psImage),
     poColorTable(nullptr),
     pUnpackData(nullptr),
-    bScanlineAccess(FALSE)
+    bScanlineAccess(FALSE),
+    nImageBand(nBandIn),
+    nImageBandCount(1)
 {
     NITFBandInfo *psBandInfo = poDSIn->psImage->pasBandInfo + nBandIn - 1;
 
@@ -521,6 +524,13 @@ CPLErr NITFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
         return eErr;
     }
 
+/* -------------------------------------------------------------------- */
+/*      Pixel or row interleaved blocks are read once for all bands.    */
+/* -------------------------------------------------------------------- */
+    CPLErr eErr = CE_None;
+    if( ReadFromInterleavedBlock( nBlockXOff, nBlockYOff, pImage, &eErr ) )
+        return eErr;
+
 /* -------------------------------------------------------------------- */
 /*      Read the line/block                                             */
 /* -------------------------------------------------------------------- */
@@ -563,6 +573,38 @@ CPLErr NITFRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
     return CE_None;
 }
 
+/************************************************************************/
+/*                      ReadFromInterleavedBlock()                      */
+/*                                                                      */
+/*      Serve the block from the interleaved block of the dataset,      */
+/*      read once for all the bands, and fill the block cache of the    */
+/*      other bands with it. Returns FALSE, and nothing is read, when   */
+/*      the image is not interleaved or the block is not stored.        */
+/************************************************************************/
+
+int NITFRasterBand::ReadFromInterleavedBlock( int nBlockXOff, int nBlockYOff,
+                                              void *pImage, CPLErr *peErr )
+
+{
+    NITFDataset *poGDS = reinterpret_cast<NITFDataset *>( poDS );
+    if( !poGDS->CanReadInterleavedBlocks() )
+        return FALSE;
+
+    bool bMissing = false;
+    *peErr = poGDS->ReadInterleavedBlock( nBlockXOff, nBlockYOff,
+                                          CPL_TO_BOOL(bScanlineAccess),
+                                          &bMissing );
+    if( *peErr != CE_None )
+        return TRUE;
+    if( bMissing )
+        return FALSE;
+
+    poGDS->CopyInterleavedBlock( nImageBand, nImageBandCount, nBlockYSize,
+                                 pImage );
+    poGDS->FillCacheForOtherBands( this, nBlockXOff, nBlockYOff );
+    return TRUE;
+}
+
 /************************************************************************/
 /*                            IWriteBlock()                             */
 /************************************************************************/
@@ -593,6 +635,92 @@ CPLErr NITFRasterBand::IWriteBlock( int nBlockXOff, int nBlockYOff,
     return CE_Failure;
 }
 
+/************************************************************************/
+/*                         GetVirtualMemAuto()                          */
+/************************************************************************/
+/* Maps the file for uncompressed images with whole rows per block      */
+/* stored one after the other. NITF samples are big endian: by default  */
+/* multi-byte samples are only mapped on big endian hosts, as the       */
+/* mapping must hold samples in the CPU byte order. With the            */
+/* BYTE_ORDER=MSB option they are mapped on any host, as stored, and    */
+/* the caller swaps them (numpy dtype '>i2' or '>f4' for instance).     */
+/* Other images use the default implementation.                         */
+/************************************************************************/
+
+CPLVirtualMem *NITFRasterBand::GetVirtualMemAuto( GDALRWFlag eRWFlag,
+                                                  int *pnPixelSpace,
+                                                  GIntBig *pnLineSpace,
+                                                  char **papszOptions )
+{
+    const char *pszImpl = CSLFetchNameValueDef(
+            papszOptions, "USE_DEFAULT_IMPLEMENTATION", "AUTO");
+    const bool bForceDefault =
+        EQUAL(pszImpl, "YES") || EQUAL(pszImpl, "ON") ||
+        EQUAL(pszImpl, "1") || EQUAL(pszImpl, "TRUE");
+
+/* -------------------------------------------------------------------- */
+/*      The file can only be mapped for uncompressed images with whole  */
+/*      rows per block, stored in the file one block after the other,   */
+/*      and samples in the CPU byte order unless the caller takes them  */
+/*      big endian.                                                     */
+/* -------------------------------------------------------------------- */
+    const bool bCallerSwaps = EQUAL(
+        CSLFetchNameValueDef(papszOptions, "BYTE_ORDER", "NATIVE"), "MSB");
+
+    bool bMappable =
+        !bForceDefault &&
+        EQUAL(psImage->szIC, "NC") &&
+        psImage->nBitsPerSample == psImage->nWordSize * 8 &&
+        psImage->nWordSize == GDALGetDataTypeSizeBytes(eDataType) &&
+        psImage->nBlocksPerRow == 1 &&
+        psImage->nBlockWidth >= nRasterXSize &&
+        (eRWFlag == GF_Read || eAccess == GA_Update) &&
+        VSIFGetNativeFileDescriptorL(psImage->psFile->fp) != nullptr &&
+        CPLIsVirtualMemFileMapAvailable();
+#ifdef CPL_LSB
+    if( psImage->nWordSize > 1 && !bCallerSwaps )
+        bMappable = false;
+#else
+    (void)bCallerSwaps;
+#endif
+
+    const int nBlocks = psImage->nBlocksPerRow * psImage->nBlocksPerColumn;
+    const GUIntBig *panBandBlockStart =
+        psImage->panBlockStart + static_cast<size_t>(nBand - 1) * nBlocks;
+    for( int iBlock = 0; bMappable && iBlock < nBlocks; iBlock++ )
+    {
+        if( panBandBlockStart[iBlock] == UINT_MAX ||
+            panBandBlockStart[iBlock] != panBandBlockStart[0] +
+                static_cast<GUIntBig>(iBlock) * psImage->nBlockHeight *
+                psImage->nLineOffset )
+            bMappable = false;
+    }
+
+    const GUIntBig nSize =
+        static_cast<GUIntBig>(nRasterYSize - 1) * psImage->nLineOffset +
+        static_cast<GUIntBig>(nRasterXSize - 1) * psImage->nPixelOffset +
+        psImage->nWordSize;
+    if( !bMappable || static_cast<size_t>(nSize) != nSize )
+        return GDALPamRasterBand::GetVirtualMemAuto(eRWFlag, pnPixelSpace,
+                                                    pnLineSpace, papszOptions);
+
+    FlushCache();
+
+    CPLVirtualMem *pVMem = CPLVirtualMemFileMapNew(
+        psImage->psFile->fp, panBandBlockStart[0], nSize,
+        (eRWFlag == GF_Write) ? VIRTUALMEM_READWRITE : VIRTUALMEM_READONLY,
+        nullptr, nullptr);
+    if( pVMem == nullptr )
+        return GDALPamRasterBand::GetVirtualMemAuto(eRWFlag, pnPixelSpace,
+                                                    pnLineSpace, papszOptions);
+
+    if( pnPixelSpace )
+        *pnPixelSpace = static_cast<int>(psImage->nPixelOffset);
+    if( pnLineSpace )
+        *pnLineSpace = static_cast<GIntBig>(psImage->nLineOffset);
+    return pVMem;
+}
+
 /************************************************************************/
 /*                           GetNoDataValue()                           */
 /************************************************************************/
@@ -1089,30 +1217,80 @@ GDALRasterBand * NITFWrapperRasterBand::GetOverview(int iOverview)
 
 // DRDC change since Adam Klein
 
+#if defined(__x86_64__) || defined(_M_X64)
+#define NITF_IQ_SSE2
+#include <emmintrin.h>
+#endif
+
+/************************************************************************/
+/*                          NITFInterleaveIQ()                          */
+/************************************************************************/
+/* pabyOut receives I[0] Q[0] I[1] Q[1] ... for nWords words of         */
+/* nWordSize bytes (2, 4 or 8). With SSE2, 16 bytes of I and of Q are   */
+/* interleaved per iteration by the unpack instructions.                */
+/* nitfiq_bench.cpp compares these reads with the former two-band       */
+/* RasterIO of the intermediate dataset.                                */
+/************************************************************************/
+
+static void NITFInterleaveIQ(const GByte *pabyI, const GByte *pabyQ,
+	GByte *pabyOut, size_t nWords, int nWordSize)
+{
+	const size_t nBytes = nWords * nWordSize;
+	size_t i = 0;
+
+#ifdef NITF_IQ_SSE2
+	for (; i + 16 <= nBytes; i += 16)
+	{
+		const __m128i xmmI = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pabyI + i));
+		const __m128i xmmQ = _mm_loadu_si128(reinterpret_cast<const __m128i *>(pabyQ + i));
+		__m128i xmmLow, xmmHigh;
+		switch (nWordSize)
+		{
+		case 2:
+			xmmLow = _mm_unpacklo_epi16(xmmI, xmmQ);
+			xmmHigh = _mm_unpackhi_epi16(xmmI, xmmQ);
+			break;
+		case 4:
+			xmmLow = _mm_unpacklo_epi32(xmmI, xmmQ);
+			xmmHigh = _mm_unpackhi_epi32(xmmI, xmmQ);
+			break;
+		default:
+			xmmLow = _mm_unpacklo_epi64(xmmI, xmmQ);
+			xmmHigh = _mm_unpackhi_epi64(xmmI, xmmQ);
+			break;
+		}
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pabyOut + 2 * i), xmmLow);
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(pabyOut + 2 * i + 16), xmmHigh);
+	}
+#endif
+
+	for (; i < nBytes; i += nWordSize)
+	{
+		memcpy(pabyOut + 2 * i, pabyI + i, nWordSize);
+		memcpy(pabyOut + 2 * i + nWordSize, pabyQ + i, nWordSize);
+	}
+}
+
 /************************************************************************/
 /*                      NITFComplexRasterBand()                         */
 /************************************************************************/
 
 NITFComplexRasterBand::NITFComplexRasterBand(NITFDataset * poDS,
-	GDALRasterBand* poBandI,
-	GDALRasterBand* poBandQ,
-	int nIBand, int nQBand) : NITFRasterBand(poDS, nIBand)
+	GDALRasterBand* poBandIIn,
+	GDALRasterBand* poBandQIn,
+	int nIBand, int nQBand) : NITFRasterBand(poDS, nIBand),
+	poBandI(poBandIIn),
+	poBandQ(poBandQIn),
+	poIntermediateDS(NULL),
+	pabyIQBlock(NULL)
 {
 
 	CPLAssert(poBandI->GetRasterDataType() == poBandQ->GetRasterDataType());
 	underlyingDataType = poBandI->GetRasterDataType();
 
-	//add the I and Q bands to an intermediate dataset
-	poIntermediateDS = new NITFDataset();
-	poIntermediateDS->nRasterXSize = poDS->nRasterXSize;
-	poIntermediateDS->nRasterYSize = poDS->nRasterYSize;
-	poIntermediateDS->eAccess = poDS->eAccess;
-
-	poIntermediateDS->SetBand(nIBand, poBandI);
-	poIntermediateDS->SetBand(nQBand, poBandQ);
-
 	nBandMap[0] = nIBand;
 	nBandMap[1] = nQBand;
+	nImageBandCount = 2;
 
 	//set the new datatype
 	switch (underlyingDataType)
@@ -1149,11 +1327,42 @@ NITFComplexRasterBand::NITFComplexRasterBand(NITFDataset * poDS,
 
 NITFComplexRasterBand::~NITFComplexRasterBand()
 {
-	delete poIntermediateDS;
+	/* The intermediate dataset owns the I and Q bands once built */
+	if (poIntermediateDS != NULL)
+	{
+		delete poIntermediateDS;
+	}
+	else
+	{
+		delete poBandI;
+		delete poBandQ;
+	}
+	CPLFree(pabyIQBlock);
 }
 
 /************************************************************************/
-/*                             IReadBlock()                             */
+/*                         GetIntermediateDS()                          */
+/************************************************************************/
+
+NITFDataset* NITFComplexRasterBand::GetIntermediateDS()
+{
+	//add the I and Q bands to an intermediate dataset
+	if (poIntermediateDS == NULL)
+	{
+		poIntermediateDS = new NITFDataset();
+		poIntermediateDS->nRasterXSize = poDS->GetRasterXSize();
+		poIntermediateDS->nRasterYSize = poDS->GetRasterYSize();
+		poIntermediateDS->eAccess = poDS->GetAccess();
+
+		poIntermediateDS->SetBand(nBandMap[0], poBandI);
+		poIntermediateDS->SetBand(nBandMap[1], poBandQ);
+	}
+
+	return poIntermediateDS;
+}
+
+/************************************************************************/
+/*                              IBlockIO()                              */
 /************************************************************************/
 
 CPLErr NITFComplexRasterBand::IBlockIO(int nBlockXOff, int nBlockYOff,
@@ -1195,7 +1404,7 @@ CPLErr NITFComplexRasterBand::IBlockIO(int nBlockXOff, int nBlockYOff,
 	}
 
 	//read/write both bands with interleaved pixels
-	return poIntermediateDS->RasterIO(rwFlag,
+	return GetIntermediateDS()->RasterIO(rwFlag,
 		nBlockXOff * nBlockXSize,
 		nBlockYOff * nBlockYSize,
 		nRequestXSize, nRequestYSize,
@@ -1214,7 +1423,56 @@ CPLErr NITFComplexRasterBand::IReadBlock(int nBlockXOff, int nBlockYOff,
 	void * pImage)
 
 {
-	return IBlockIO(nBlockXOff, nBlockYOff, pImage, GF_Read);
+	/* -------------------------------------------------------------------- */
+	/*      In update mode the I and Q blocks may be dirty in the cache,    */
+	/*      and bands blocked differently cannot be read block by block:    */
+	/*      read both through the intermediate dataset then.                */
+	/* -------------------------------------------------------------------- */
+	int nQBlockXSize, nQBlockYSize;
+	GetQBand()->GetBlockSize(&nQBlockXSize, &nQBlockYSize);
+	if (eAccess == GA_Update || nQBlockXSize != nBlockXSize || nQBlockYSize != nBlockYSize)
+		return IBlockIO(nBlockXOff, nBlockYOff, pImage, GF_Read);
+
+	/* Pixel or row interleaved I and Q: one read of the block for all */
+	/* the polarizations, which also fills their block cache           */
+	CPLErr eErr = CE_None;
+	if (nBandMap[1] == nBandMap[0] + 1 && ReadFromInterleavedBlock(nBlockXOff, nBlockYOff, pImage, &eErr))
+		return eErr;
+
+	const size_t nBlockPixels = static_cast<size_t>(nBlockXSize) * nBlockYSize;
+	if (pabyIQBlock == NULL)
+	{
+		pabyIQBlock = static_cast<GByte *>(VSI_MALLOC2_VERBOSE(nBlockPixels, complexDataTypeSize));
+		if (pabyIQBlock == NULL)
+			return CE_Failure;
+	}
+
+	GByte *pabyQ = pabyIQBlock + nBlockPixels * underlyingDataTypeSize;
+	eErr = ReadPlanarBlock(nBlockXOff, nBlockYOff, pabyIQBlock, pabyQ);
+	if (eErr == CE_None)
+		NITFInterleaveIQ(pabyIQBlock, pabyQ, static_cast<GByte *>(pImage),
+			nBlockPixels, underlyingDataTypeSize);
+
+	return eErr;
+}
+
+/************************************************************************/
+/*                          ReadPlanarBlock()                           */
+/************************************************************************/
+/* Read one block of I into pI and the same block of Q into pQ, each    */
+/* nBlockXSize * nBlockYSize values of GetIQDataType(), without going   */
+/* through the block cache of the I and Q bands.                        */
+/************************************************************************/
+
+CPLErr NITFComplexRasterBand::ReadPlanarBlock(int nBlockXOff, int nBlockYOff,
+	void *pI, void *pQ)
+
+{
+	CPLErr eErr = GetIBand()->ReadBlock(nBlockXOff, nBlockYOff, pI);
+	if (eErr == CE_None)
+		eErr = GetQBand()->ReadBlock(nBlockXOff, nBlockYOff, pQ);
+
+	return eErr;
 }
 
 /************************************************************************/
@@ -30,12 +30,18 @@
 #include <time.h>
 #include <stdio.h>
 #include <sstream>
+#include <algorithm>
+#include <chrono>
 //#include <conio.h>
 #include "cpl_minixml.h"
 #include "gdal_frmts.h"
+#include "gdal_alg.h"
+#include "gdal_alg_priv.h"
 #include "gdal_pam.h"
 #include "ogr_spatialref.h"
 #include "rcmdataset.h"
+#include "rcmpolarimetry.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal_io_error.h"
 
 CPL_CVSID("$Id: rcmdataset.cpp 99999 2018-03-05 18:40:40Z rcaron $");
@@ -105,6 +111,190 @@ static CPLString FormatCalibration(const char *pszCalibName, const char *pszFile
 	return ptr;
 }
 
+/*** Function to format a virtual geometry layer for unique identification for Layer Name ***/
+/*
+*  RCM_GEOM : { DOPPLER_CENTROID } : product.xml full path
+*/
+static CPLString FormatGeometry(const char *pszLayerName, const char *pszFilename)
+{
+	CPLString ptr;
+
+	// Always begin by the geometry layer name
+	ptr.append(szLayerGeometry);
+	ptr.append(szLayerSeparator);
+
+	if (pszLayerName != NULL)
+	{
+		ptr.append(pszLayerName);
+		ptr.append(szLayerSeparator);
+	}
+
+	if (pszFilename != NULL)
+	{
+		ptr.append(pszFilename);
+	}
+
+	/* return geometry format */
+	return ptr;
+}
+
+/*** Function to format a derived polarimetric product for unique identification for Layer Name ***/
+/*
+*  RCM_POL : { STOKES } : product.xml full path
+*/
+static CPLString FormatPolarimetry(const char *pszProductName, const char *pszFilename)
+{
+	CPLString ptr;
+
+	// Always begin by the polarimetry layer name
+	ptr.append(szLayerPolarimetry);
+	ptr.append(szLayerSeparator);
+
+	if (pszProductName != NULL)
+	{
+		ptr.append(pszProductName);
+		ptr.append(szLayerSeparator);
+	}
+
+	if (pszFilename != NULL)
+	{
+		ptr.append(pszFilename);
+	}
+
+	/* return polarimetry format */
+	return ptr;
+}
+
+/*** Derived polarimetric products, their input channels and output bands ***/
+static const struct
+{
+	ePolarimetricProduct eProduct;
+	const char *pszName;
+	const char *pszDescription;
+	const char *apszPoles[5];       /* NULL terminated, in processing order */
+	const char *apszBands[10];      /* NULL terminated */
+} asPolarimetricProducts[] =
+{
+	{ PolStokes, szSTOKES, "Compact polarimetry Stokes vector and degree of polarization",
+		{ "RH", "RV", NULL },
+		{ "S0", "S1", "S2", "S3", "DEGREE_OF_POLARIZATION", NULL } },
+	{ PolMChi, szMCHI, "Compact polarimetry m-chi decomposition (power)",
+		{ "RH", "RV", NULL },
+		{ "DOUBLE_BOUNCE", "VOLUME", "SURFACE", NULL } },
+	{ PolC3, szC3, "Quad polarization covariance matrix C3",
+		{ "HH", "HV", "VH", "VV", NULL },
+		{ "C11", "C12_real", "C12_imag", "C13_real", "C13_imag", "C22", "C23_real", "C23_imag", "C33", NULL } },
+	{ PolT3, szT3, "Quad polarization coherency matrix T3",
+		{ "HH", "HV", "VH", "VV", NULL },
+		{ "T11", "T12_real", "T12_imag", "T13_real", "T13_imag", "T22", "T23_real", "T23_imag", "T33", NULL } },
+	{ PolPauli, szPAULI, "Quad polarization Pauli RGB (power)",
+		{ "HH", "HV", "VH", "VV", NULL },
+		{ "DOUBLE_BOUNCE", "VOLUME", "SURFACE", NULL } },
+	{ PolHAAlpha, szHAALPHA, "Quad polarization Cloude-Pottier entropy, anisotropy and alpha",
+		{ "HH", "HV", "VH", "VV", NULL },
+		{ "ENTROPY", "ANISOTROPY", "ALPHA", NULL } },
+};
+
+/*** Rows of a block decomposed by one thread ***/
+typedef struct
+{
+	const double *padfT3;
+	size_t nPlane;
+	size_t nStart;
+	size_t nEnd;
+	double *padfHAAlpha;
+} RCMDecompositionJob;
+
+static void RCMDecompositionRows(void *pData)
+{
+	RCMDecompositionJob *psJob = static_cast<RCMDecompositionJob *>(pData);
+	RCMComputeHAAlpha(psJob->padfT3, psJob->nPlane, psJob->nStart, psJob->nEnd,
+		psJob->padfHAAlpha);
+}
+
+/*** Function to find the input channel index of a pole, -1 if not an input of the product ***/
+static int GetPolarimetricChannel(int iProduct, const char *pszPole)
+{
+	const char * const *papszPoles = asPolarimetricProducts[iProduct].apszPoles;
+	for (int i = 0; papszPoles[i] != NULL; i++)
+	{
+		if (EQUAL(papszPoles[i], pszPole))
+			return i;
+	}
+	return -1;
+}
+
+/*** Function to count the entries of a NULL terminated list of the product table ***/
+static int CountPolarimetricNames(const char * const *papszNames)
+{
+	int nCount = 0;
+	while (papszNames[nCount] != NULL)
+		nCount++;
+	return nCount;
+}
+
+/*** Virtual geometry layers, their subdataset name and description ***/
+static const struct
+{
+	eGeometryLayer eLayer;
+	const char *pszName;
+	const char *pszDescription;
+} asGeometryLayers[] =
+{
+	{ GeomDopplerCentroid, szDOPPLER_CENTROID, "Doppler centroid (Hz)" },
+	{ GeomSlantRange, szSLANT_RANGE, "Slant range (m)" },
+	{ GeomAzimuthTime, szAZIMUTH_TIME, "Zero Doppler azimuth time (s since 1970-01-01)" },
+	{ GeomLatLon, szLATLON, "Longitude and latitude from the rational functions (deg)" },
+	{ GeomBurstId, szBURST_ID, "ScanSAR burst number" },
+	{ GeomBeamId, szBEAM_ID, "ScanSAR beam index (1 based, in the BEAMS band metadata)" },
+	{ GeomIncidenceAngle, szINCIDENCE_ANGLE, "Incidence angle (deg)" },
+};
+
+/*** Function to check that product.xml holds what a geometry layer needs ***/
+static bool IsGeometryLayerAvailable(RCMDataset *poDS, eGeometryLayer eLayer)
+{
+	switch (eLayer)
+	{
+	case GeomDopplerCentroid:
+		return poDS->HasLineTimes() && poDS->HasSlantRange() &&
+			poDS->GetDopplerCentroidEstimates()->IsValid();
+	case GeomSlantRange:
+		return poDS->HasSlantRange();
+	case GeomAzimuthTime:
+		return poDS->HasLineTimes();
+	case GeomLatLon:
+		return poDS->GetRPCModel()->IsValid();
+	case GeomBurstId:
+	case GeomBeamId:
+		return poDS->GetBurstMap()->IsValid();
+	case GeomIncidenceAngle:
+		return poDS->GetIncidenceAngleRow() != NULL;
+	default:
+		return false;
+	}
+}
+
+/*** Function to add a subdataset after the last one already listed ***/
+static char **AddSubDataset(char **papszSubDatasets, const char *pszName, const char *pszDescription)
+{
+	/* The calibration subdatasets may leave gaps, use the highest index */
+	int nIndex = 0;
+	for (int i = 0; papszSubDatasets != NULL && papszSubDatasets[i] != NULL; i++)
+	{
+		int nCurrent = 0;
+		if (sscanf(papszSubDatasets[i], "SUBDATASET_%d_", &nCurrent) == 1 && nCurrent > nIndex)
+			nIndex = nCurrent;
+	}
+	nIndex++;
+
+	papszSubDatasets = CSLSetNameValue(papszSubDatasets,
+		CPLSPrintf("SUBDATASET_%d_NAME", nIndex), pszName);
+	papszSubDatasets = CSLSetNameValue(papszSubDatasets,
+		CPLSPrintf("SUBDATASET_%d_DESC", nIndex), pszDescription);
+
+	return papszSubDatasets;
+}
+
 /*** Function to concat 'metadata' with a folder separator with the filename 'product.xml'  ***/
 /*
 *  Should return either 'metadata\product.xml' or 'metadata/product.xml'
@@ -279,6 +469,57 @@ bool RCMRasterBand::IsExistNoiseLevels()
 	return false;
 }
 
+/************************************************************************/
+/*                           RCMPerfCounters                            */
+/************************************************************************/
+
+static GIntBig RCMPerfNow()
+{
+	return std::chrono::duration_cast<std::chrono::nanoseconds>(
+		std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+/* Adds the nanoseconds spent in its scope to a counter */
+class RCMPerfTimer {
+	std::atomic<GIntBig> &m_nCounter;
+	const GIntBig m_nStart;
+public:
+	explicit RCMPerfTimer(std::atomic<GIntBig> &nCounter) :
+		m_nCounter(nCounter), m_nStart(RCMPerfNow()) {}
+	~RCMPerfTimer() { RCMPerfCounters::Add(m_nCounter, RCMPerfNow() - m_nStart); }
+};
+
+void RCMPerfCounters::Reset()
+{
+	nBlocksRead = 0;
+	nBytesIn = 0;
+	nBytesOut = 0;
+	nIONanoseconds = 0;
+	nCalibrationNanoseconds = 0;
+}
+
+/************************************************************************/
+/*                         RCMGetThreadCount()                          */
+/************************************************************************/
+
+int RCMGetThreadCount(char **papszOptions)
+{
+	const char *pszThreads = CSLFetchNameValueDef(papszOptions, "NUM_THREADS",
+		CPLGetConfigOption("GDAL_NUM_THREADS", "1"));
+	const int nThreads = EQUAL(pszThreads, "ALL_CPUS") ? CPLGetNumCPUs() : atoi(pszThreads);
+	return std::max(1, std::min(nThreads, 128));
+}
+
+/************************************************************************/
+/*                           RCMGetJobRows()                            */
+/************************************************************************/
+
+void RCMGetJobRows(int nRows, int nJobs, int iJob, int *piStartRow, int *piEndRow)
+{
+	const int nRowsPerJob = (nRows + nJobs - 1) / nJobs;
+	*piStartRow = std::min(nRows, iJob * nRowsPerJob);
+	*piEndRow = std::min(nRows, (iJob + 1) * nRowsPerJob);
+}
 
 /************************************************************************/
 /*                            RCMRasterBand()                            */
@@ -337,6 +578,13 @@ CPLErr RCMRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 	GDALDataType bandFileType = poBandFile->GetRasterBand(1)->GetRasterDataType();
         int bandFileSize = GDALGetDataTypeSizeBytes(bandFileType);
 
+	/* Everything below is source I/O, the I+Q interleave included */
+	const GIntBig nRequestBytes = static_cast<GIntBig>(nRequestXSize) * nRequestYSize * dataTypeSize;
+	RCMPerfCounters::Add(oPerf.nBlocksRead, 1);
+	RCMPerfCounters::Add(oPerf.nBytesIn, nRequestBytes);
+	RCMPerfCounters::Add(oPerf.nBytesOut, nRequestBytes);
+	RCMPerfTimer oIOTimer(oPerf.nIONanoseconds);
+
 	//case: 2 bands representing I+Q -> one complex band
 	if (twoBandComplex && !this->isNITF)
 	{
@@ -401,6 +649,70 @@ CPLErr RCMRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 	}
 }
 
+/************************************************************************/
+/*                             AdviseRead()                             */
+/************************************************************************/
+/* Same window in the band file, both bands when IReadBlock()           */
+/* interleaves I and Q from the 2 bands of a GeoTIFF. In a NITF, poBand */
+/* is already the I/Q complex band of this polarization.                */
+/************************************************************************/
+
+CPLErr RCMRasterBand::AdviseRead(int nXOff, int nYOff, int nXSize, int nYSize,
+	int nBufXSize, int nBufYSize, GDALDataType eBufType, char **papszOptions)
+{
+	if (!this->isNITF && (twoBandComplex || poRCMDataset->IsComplexData()))
+	{
+		int anBands[2] = { 1, 2 };
+		return poBandFile->AdviseRead(nXOff, nYOff, nXSize, nYSize,
+			nBufXSize, nBufYSize,
+			poBandFile->GetRasterBand(1)->GetRasterDataType(),
+			std::min(2, poBandFile->GetRasterCount()), anBands, papszOptions);
+	}
+
+	return poBand->AdviseRead(nXOff, nYOff, nXSize, nYSize,
+		nBufXSize, nBufYSize, eBufType, papszOptions);
+}
+
+/************************************************************************/
+/*                         GetVirtualMemAuto()                          */
+/************************************************************************/
+/* When IReadBlock() passes the band file straight through, map it with */
+/* its own driver (uncompressed GeoTIFF strips, uncompressed NITF), so  */
+/* the whole polarization is seen without copies nor block cache. The   */
+/* options go to that driver: NITF needs BYTE_ORDER=MSB for multi-byte  */
+/* samples on little endian hosts. The I+Q interleaved bands use the    */
+/* default implementation.                                              */
+/************************************************************************/
+
+CPLVirtualMem *RCMRasterBand::GetVirtualMemAuto(GDALRWFlag eRWFlag,
+	int *pnPixelSpace, GIntBig *pnLineSpace, char **papszOptions)
+{
+	const char *pszImpl = CSLFetchNameValueDef(papszOptions, "USE_DEFAULT_IMPLEMENTATION", "AUTO");
+	const bool bForceDefault = EQUAL(pszImpl, "YES") || EQUAL(pszImpl, "ON") ||
+		EQUAL(pszImpl, "1") || EQUAL(pszImpl, "TRUE");
+
+	const bool bPassThrough = !twoBandComplex && !poRCMDataset->IsComplexData() &&
+		poBand->GetRasterDataType() == eDataType &&
+		poBand->GetXSize() == nRasterXSize && poBand->GetYSize() == nRasterYSize;
+
+	if (eRWFlag == GF_Read && bPassThrough && !bForceDefault) {
+		/* Only a real mapping of the band file, not its own paging */
+		char **papszMapOptions = CSLSetNameValue(CSLDuplicate(papszOptions),
+			"USE_DEFAULT_IMPLEMENTATION", "NO");
+		CPLVirtualMem *psVMem = poBand->GetVirtualMemAuto(GF_Read, pnPixelSpace, pnLineSpace,
+			papszMapOptions);
+		CSLDestroy(papszMapOptions);
+
+		if (psVMem != NULL) {
+			RCM_TRACE(RCM_TRACE_DEBUG, "GetVirtualMemAuto", "band %d mapped from %s",
+				nBand, poBandFile->GetDescription());
+			return psVMem;
+		}
+	}
+
+	return GDALPamRasterBand::GetVirtualMemAuto(eRWFlag, pnPixelSpace, pnLineSpace, papszOptions);
+}
+
 
 /************************************************************************/
 /*                            ReadLUT()                                 */
@@ -420,7 +732,11 @@ void RCMCalibRasterBand::ReadLUT() {
 	//itoa(poDS->GetRasterCount() + 1, bandNumber, 10);
 	sprintf(bandNumber, "%d", poDS->GetRasterCount()+1);
 
-	CPLXMLNode *psLUT = CPLParseXMLFile(m_pszLUTFile);
+	CPLXMLNode *psLUT;
+	{
+		RCMPerfTimer oParseTimer(m_oPerf.nXMLParseNanoseconds);
+		psLUT = CPLParseXMLFile(m_pszLUTFile);
+	}
 
 	this->m_nfOffset = CPLAtof(CPLGetXMLValue(psLUT, "=lut.offset", "0.0"));
 
@@ -473,10 +789,8 @@ void RCMCalibRasterBand::ReadLUT() {
 
 	}
 
-#ifdef _TRACE_RCM
-	write_to_file("RCM ReadLUT m_pszLUTFile=", m_pszLUTFile);
-	write_to_file("   m_nfTable=", lut_gains);
-#endif
+	RCM_TRACE(RCM_TRACE_INFO, "ReadLUT", "RCM m_pszLUTFile=%s size=%d", m_pszLUTFile, m_nTableSize);
+	RCM_TRACE(RCM_TRACE_DEBUG, "ReadLUT", "m_nfTable=%s", lut_gains);
 
 	poDS->SetMetadataItem(CPLString("LUT_GAINS_").append(bandNumber).c_str(), lut_gains);
 	// Can free this because the function SetMetadataItem takes a copy
@@ -492,6 +806,10 @@ void RCMCalibRasterBand::ReadLUT() {
 	else if (this->m_eCalib == eCalibration::Gamma) {
 		poDS->SetMetadataItem(CPLString("LUT_TYPE_").append(bandNumber).c_str(), "GAMMA");
 	}
+	else if (this->m_eCalib == eCalibration::Gamma0Ellipsoid) {
+		/* The LUT is the Sigma Nought one, the incidence angle does the rest */
+		poDS->SetMetadataItem(CPLString("LUT_TYPE_").append(bandNumber).c_str(), "SIGMA0");
+	}
 	sprintf(snum, "%d", this->m_nTableSize);
 	poDS->SetMetadataItem(CPLString("LUT_SIZE_").append(bandNumber).c_str(), snum);
 	sprintf(snum, "%f", this->m_nfOffset);
@@ -526,7 +844,11 @@ void RCMCalibRasterBand::ReadNoiseLevels() {
 	//itoa(poDS->GetRasterCount() + 1, bandNumber, 10);
 	sprintf(bandNumber, "%d", poDS->GetRasterCount()+1);
 
-	CPLXMLNode *psNoiseLevels = CPLParseXMLFile(this->m_pszNoiseLevelsFile);
+	CPLXMLNode *psNoiseLevels;
+	{
+		RCMPerfTimer oParseTimer(m_oPerf.nXMLParseNanoseconds);
+		psNoiseLevels = CPLParseXMLFile(this->m_pszNoiseLevelsFile);
+	}
 
 	// Load Beta Nought, Sigma Nought, Gamma noise levels
 	// Loop through all nodes with spaces
@@ -563,7 +885,7 @@ void RCMCalibRasterBand::ReadNoiseLevels() {
 				this->m_nTableNoiseLevelsSize = abs(this->stepSizeNoiseLevels) * abs(this->numberOfValuesNoiseLevels);
 
 				if ( (EQUAL(calibType, "Beta Nought") && this->m_eCalib == Beta0) ||
-					 (EQUAL(calibType, "Sigma Nought") && this->m_eCalib == Sigma0) ||
+					 (EQUAL(calibType, "Sigma Nought") && (this->m_eCalib == Sigma0 || this->m_eCalib == Gamma0Ellipsoid)) ||
 					 (EQUAL(calibType, "Gamma") && this->m_eCalib == Gamma) ) {
 					/* Allocate the right Noise Levels size according to the product range pixel */
 					this->m_nfTableNoiseLevels = InterpolateValues(papszNoiseLevelList, 
@@ -582,7 +904,7 @@ void RCMCalibRasterBand::ReadNoiseLevels() {
 		}
 	}
 
-#ifdef _TRACE_RCM
+#if RCM_TRACE_LEVEL >= RCM_TRACE_DEBUG
 	if (this->m_nfTableNoiseLevels != NULL) {
 		const size_t nLen = this->m_nTableNoiseLevelsSize * max_space_for_string; // 12 max + space + 11 reserved
 		char *noise_levels_values = static_cast<char *>(CPLMalloc(nLen));
@@ -594,8 +916,8 @@ void RCMCalibRasterBand::ReadNoiseLevels() {
 			sprintf(lut, "%e ", this->m_nfTableNoiseLevels[i]);
 			strcat(noise_levels_values, lut);
 		}
-		write_to_file("RCM ReadNoiseLevel m_pszLUTFile=", m_pszNoiseLevelsFile);
-		write_to_file("   m_nfTableNoiseLevels=", noise_levels_values);
+		RCM_TRACE(RCM_TRACE_DEBUG, "ReadNoiseLevels", "RCM m_pszNoiseLevelsFile=%s", m_pszNoiseLevelsFile);
+		RCM_TRACE(RCM_TRACE_DEBUG, "ReadNoiseLevels", "m_nfTableNoiseLevels=%s", noise_levels_values);
 
 		CPLFree(noise_levels_values);
 	}
@@ -603,6 +925,46 @@ void RCMCalibRasterBand::ReadNoiseLevels() {
 
 }
 
+/* Source bytes prefetched ahead of the current block row by READAHEAD=YES */
+#define RCM_READAHEAD_BYTES (16 << 20)
+
+/*** Source lines read ahead by the readahead thread ***/
+struct RCMReadaheadJob
+{
+	std::atomic<bool> bBusy{false};
+	std::atomic<int> nStartY{0};    /* source lines [nStartY, nEndY) wanted, set by the owner */
+	std::atomic<int> nEndY{0};
+	CPLString osSource;             /* description of m_poBandDataset */
+	GDALDataset *poDataset = NULL;  /* opened and used by the readahead thread only */
+	int nSrcBand = 1;
+	int nBands = 1;
+	int nXOff = 0;
+	int nXSize = 0;
+	int nDoneY = 0;                 /* readahead thread side, lines already read */
+	int nRows = 1;                  /* owner side, block rows read ahead */
+	std::vector<GByte> abyBuffer;
+};
+
+/************************************************************************/
+/*                     RCMGetProcessingBlockYSize()                     */
+/************************************************************************/
+/* Height of the blocks of the bands computed over a neighbourhood or   */
+/* by NUM_THREADS: at least RCM_PROCESSING_LINES lines, or fewer for    */
+/* very wide blocks, whatever the height of the source blocks. With     */
+/* one line strips a block per line would read and calibrate the filter */
+/* halo again for every line and leave a single row to the threads.    */
+/************************************************************************/
+
+#define RCM_PROCESSING_LINES 128
+#define RCM_PROCESSING_PIXELS (1 << 22)
+
+static int RCMGetProcessingBlockYSize(int nBlockXSize, int nBlockYSize, int nRasterYSize)
+{
+	const int nLines = std::max(1, std::min(RCM_PROCESSING_LINES,
+		RCM_PROCESSING_PIXELS / std::max(1, nBlockXSize)));
+	return std::max(nBlockYSize, std::min(nRasterYSize, nLines));
+}
+
 /************************************************************************/
 /*                        RCMCalibRasterBand()                          */
 /************************************************************************/
@@ -610,17 +972,21 @@ void RCMCalibRasterBand::ReadNoiseLevels() {
 RCMCalibRasterBand::RCMCalibRasterBand(
 	RCMDataset *poDataset, const char *pszPolarization, GDALDataType eType,
 	GDALDataset *poBandDataset, eCalibration eCalib,
-	const char *pszLUT, const char *pszNoiseLevels, GDALDataType eOriginalType) :
+	const char *pszLUT, const char *pszNoiseLevels, GDALDataType eOriginalType,
+	int nSrcBand) :
 	m_eCalib(eCalib),
 	m_poRCMDataset(poDataset),
 	m_poBandDataset(poBandDataset),
 	m_eType(eType),
 	m_eOriginalType(eOriginalType),
+	m_nSrcBand(nSrcBand),
 	m_nfTable(NULL),
 	m_nTableSize(0),
 	m_nfOffset(0),
 	m_pszLUTFile(VSIStrdup(pszLUT)),
-	m_pszNoiseLevelsFile(VSIStrdup(pszNoiseLevels))
+	m_pszNoiseLevelsFile(VSIStrdup(pszNoiseLevels)),
+	m_poReadaheadPool(NULL),
+	m_psReadahead(NULL)
 {
 	this->poDS = poDataset;
 
@@ -635,11 +1001,70 @@ RCMCalibRasterBand::RCMCalibRasterBand(
 	else
 		this->eDataType = GDT_Float32;
 
-	GDALRasterBand *poRasterBand = poBandDataset->GetRasterBand( 1 );
+	GDALRasterBand *poRasterBand = poBandDataset->GetRasterBand( m_nSrcBand );
 	poRasterBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
 
+	/* A multilooked block covers about one block of the source image */
+	if (poDataset->IsMultilooked()) {
+		nBlockXSize = MAX(1, nBlockXSize / poDataset->GetRangeLooks());
+		nBlockYSize = MAX(1, nBlockYSize / poDataset->GetAzimuthLooks());
+	}
+
+	/* Filtered blocks are read with a halo, which is only paid per block */
+	if (poDataset->GetSpeckleFilter() != SpeckleNone)
+		nBlockYSize = RCMGetProcessingBlockYSize(nBlockXSize, nBlockYSize, poDataset->GetRasterYSize());
+
 	ReadLUT();
 	ReadNoiseLevels();
+	PrepareCorrection();
+}
+
+/************************************************************************/
+/*                         PrepareCorrection()                          */
+/************************************************************************/
+/* Tables of the corrections applied after the LUT, so that one pass   */
+/* over the pixels gives the final value:                              */
+/*   value = (calibrated - 10^(noise/10)) / cos(incidence)             */
+/* The calibrated value is the Float32 of the plain subdataset and the */
+/* rest is computed in double, then rounded to Float32 once.           */
+/************************************************************************/
+
+void RCMCalibRasterBand::PrepareCorrection()
+{
+	const bool bGamma0 = this->m_eCalib == Gamma0Ellipsoid;
+	bool bNoise = m_poRCMDataset->GetNoiseSubtraction();
+
+	if (bNoise && !IsExistNoiseLevels()) {
+		const char msgError[] = "WARNING: NOISE_SUBTRACTION requested but no matching noise levels were found, the noise is not subtracted.";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Warning, CPLE_AppDefined, "%s", msgError);
+		bNoise = false;
+	}
+
+	if (!bGamma0 && !bNoise)
+		return;
+
+	/* Indexed like the LUT, by full resolution pixel */
+	const int nSize = m_poBandDataset->GetRasterXSize();
+	m_adfNoisePower.assign(nSize, 0.0);
+	m_adfIncidenceCosine.assign(nSize, 1.0);
+
+	if (bNoise) {
+		for (int i = 0; i < nSize; i++) {
+			const double dfNoise_dB = m_nfTableNoiseLevels[std::min(i, m_nTableNoiseLevelsSize - 1)];
+			m_adfNoisePower[i] = pow(10.0, dfNoise_dB / 10.0);
+		}
+	}
+
+	if (bGamma0) {
+		const double *padfAngles = m_poRCMDataset->GetIncidenceAngle();
+		const int nAngles = m_poRCMDataset->GetIncidenceAngleSize();
+		if (padfAngles != NULL && nAngles > 0) {
+			for (int i = 0; i < nSize; i++)
+				m_adfIncidenceCosine[i] = cos(padfAngles[std::min(i, nAngles - 1)] * (M_PI / 180.0));
+		}
+	}
 }
 
 double RCMCalibRasterBand::GetNoiseLevels(int pixel)
@@ -810,6 +1235,17 @@ double * RCMCalibRasterBand::CloneNoiseLevels()
 /************************************************************************/
 
 RCMCalibRasterBand::~RCMCalibRasterBand() {
+	/* The readahead thread must be done before the source is closed */
+	if (m_poReadaheadPool != NULL) {
+		m_poReadaheadPool->WaitCompletion();
+		delete m_poReadaheadPool;
+	}
+	if (m_psReadahead != NULL) {
+		if (m_psReadahead->poDataset != NULL)
+			GDALClose(m_psReadahead->poDataset);
+		delete m_psReadahead;
+	}
+
 	CPLFree(m_nfTable);
 	CPLFree(m_nfTableNoiseLevels);
 	CPLFree(m_pszLUTFile);
@@ -817,6 +1253,173 @@ RCMCalibRasterBand::~RCMCalibRasterBand() {
 	GDALClose(m_poBandDataset);
 }
 
+/************************************************************************/
+/*                         ReadComplexWindow()                          */
+/************************************************************************/
+/* Read a full resolution window of complex samples as pixel-interleaved*/
+/* I and Q floats, whether they are stored as one complex band or as 2  */
+/* separate bands.                                                      */
+/************************************************************************/
+
+CPLErr RCMCalibRasterBand::ReadComplexWindow(int nXOff, int nYOff,
+	int nXSize, int nYSize, float *pafIQ)
+{
+	RCMPerfCounters::Add(m_oPerf.nBytesIn,
+		static_cast<GIntBig>(nXSize) * nYSize * GDALGetDataTypeSizeBytes(m_eOriginalType));
+	RCMPerfTimer oIOTimer(m_oPerf.nIONanoseconds);
+
+	if (m_poBandDataset->GetRasterCount() == 2 &&
+		!GDALDataTypeIsComplex(m_poBandDataset->GetRasterBand(1)->GetRasterDataType())) {
+		/* I and Q are stored in 2 separate bands */
+		return m_poBandDataset->RasterIO(GF_Read,
+			nXOff, nYOff, nXSize, nYSize,
+			pafIQ, nXSize, nYSize,
+			GDT_Float32,
+			2, NULL, 2 * sizeof(float), 2 * sizeof(float) * nXSize, sizeof(float), NULL);
+	}
+
+	return m_poBandDataset->RasterIO(GF_Read,
+		nXOff, nYOff, nXSize, nYSize,
+		pafIQ, nXSize, nYSize,
+		GDT_CFloat32,
+		1, &m_nSrcBand, 2 * sizeof(float), 2 * sizeof(float) * nXSize, 0, NULL);
+}
+
+/************************************************************************/
+/*                    ReadCalibratedComplexWindow()                     */
+/************************************************************************/
+/* Read a full resolution window of complex samples calibrated in       */
+/* amplitude, z / A, so that |z / A|^2 is the calibrated power. The     */
+/* noise floor is a power and is not subtracted here.                   */
+/************************************************************************/
+
+CPLErr RCMCalibRasterBand::ReadCalibratedComplexWindow(int nXOff, int nYOff,
+	int nXSize, int nYSize, float *pafIQ)
+{
+	if (this->m_nfTable == NULL || !GDALDataTypeIsComplex(this->m_eOriginalType)) {
+		const char msgError[] = "ERROR: The RCM driver cannot calibrate complex samples without complex data and a valid LUT.";
+		write_to_file_error(msgError, "");
+		CPLError(CE_Failure, CPLE_AppDefined, "%s", msgError);
+		return CE_Failure;
+	}
+
+	CPLErr eErr = ReadComplexWindow(nXOff, nYOff, nXSize, nYSize, pafIQ);
+
+	if (eErr == CE_None) {
+		RCMPerfTimer oCalibrationTimer(m_oPerf.nCalibrationNanoseconds);
+		for (int i = 0; i < nYSize; i++) {
+			float *pafLine = pafIQ + 2 * static_cast<size_t>(i) * nXSize;
+			for (int j = 0; j < nXSize; j++) {
+				const float fScale = static_cast<float>(1.0 / m_nfTable[nXOff + j]);
+				pafLine[2 * j] *= fScale;
+				pafLine[2 * j + 1] *= fScale;
+			}
+		}
+	}
+
+	return eErr;
+}
+
+/************************************************************************/
+/*                       ReadCalibratedWindow()                         */
+/************************************************************************/
+/* Read a full resolution window of the source image and calibrate it   */
+/* to linear power. nXOff is a full resolution pixel offset, so it also */
+/* indexes the LUT. pafData receives nYSize lines of nLineSpace floats. */
+/************************************************************************/
+
+CPLErr RCMCalibRasterBand::ReadCalibratedWindow(int nXOff, int nYOff,
+	int nXSize, int nYSize, float *pafData, int nLineSpace)
+{
+	CPLErr eErr;
+
+	if (this->m_nfTable == NULL) {
+		const char msgError[] = "ERROR: The RCM driver cannot calibrate without a valid LUT.";
+		write_to_file_error(msgError, "");
+		CPLError(CE_Failure, CPLE_AppDefined, "%s", msgError);
+		return CE_Failure;
+	}
+
+	if (GDALDataTypeIsComplex(this->m_eOriginalType)) {
+		/* read in complex values as pixel-interleaved I and Q floats */
+		float *pafImageTmp = static_cast<float *>(CPLMalloc(2 * sizeof(float) * nXSize * nYSize));
+
+		eErr = ReadComplexWindow(nXOff, nYOff, nXSize, nYSize, pafImageTmp);
+
+		if (eErr == CE_None)
+			CalibrateWindow(nXOff, nXSize, nYSize, pafImageTmp, 2 * nXSize, pafData, nLineSpace);
+
+		CPLFree(pafImageTmp);
+	}
+	else {
+		/* Detected values are converted to Float32 by RasterIO straight in the output buffer */
+		{
+			RCMPerfCounters::Add(m_oPerf.nBytesIn, static_cast<GIntBig>(nXSize) * nYSize *
+				GDALGetDataTypeSizeBytes(m_poBandDataset->GetRasterBand(m_nSrcBand)->GetRasterDataType()));
+			RCMPerfTimer oIOTimer(m_oPerf.nIONanoseconds);
+			eErr = m_poBandDataset->RasterIO(GF_Read,
+				nXOff, nYOff, nXSize, nYSize,
+				pafData, nXSize, nYSize,
+				GDT_Float32,
+				1, &m_nSrcBand, sizeof(float), sizeof(float) * nLineSpace, 0, NULL);
+		}
+
+		if (eErr == CE_None)
+			CalibrateWindow(nXOff, nXSize, nYSize, pafData, nLineSpace, pafData, nLineSpace);
+	}
+
+	return eErr;
+}
+
+/************************************************************************/
+/*                          CalibrateWindow()                           */
+/************************************************************************/
+
+void RCMCalibRasterBand::CalibrateWindow(int nXOff, int nXSize, int nYSize,
+	const float *pafSource, int nSourceLineSpace, float *pafData, int nLineSpace)
+{
+	RCMPerfTimer oCalibrationTimer(m_oPerf.nCalibrationNanoseconds);
+
+	/* Noise subtraction and incidence angle, NULL if not corrected */
+	const bool bCorrect = !m_adfIncidenceCosine.empty();
+	const double *padfNoise = bCorrect ? m_adfNoisePower.data() + nXOff : NULL;
+	const double *padfCosine = bCorrect ? m_adfIncidenceCosine.data() + nXOff : NULL;
+
+	if (GDALDataTypeIsComplex(this->m_eOriginalType)) {
+		/* calibrate the complex values */
+		for (int i = 0; i < nYSize; i++) {
+			const float *pafLine = pafSource + static_cast<size_t>(i) * nSourceLineSpace;
+			float *pafOut = pafData + static_cast<size_t>(i) * nLineSpace;
+			for (int j = 0; j < nXSize; j++) {
+				// Formula for Complex Q+J
+				const float real = pafLine[2 * j];
+				const float img = pafLine[2 * j + 1];
+				const float digitalValue = (real * real) + (img * img);
+				const float lutValue = static_cast<float>(m_nfTable[nXOff + j]);
+				const float calibrated = digitalValue / (lutValue * lutValue);
+				pafOut[j] = bCorrect ? static_cast<float>((calibrated - padfNoise[j]) / padfCosine[j]) : calibrated;
+			}
+		}
+	}
+	else {
+		/* iterate over detected values */
+		const float B = static_cast<float>(this->m_nfOffset);
+		for (int i = 0; i < nYSize; i++) {
+			const float *pafLine = pafSource + static_cast<size_t>(i) * nSourceLineSpace;
+			float *pafOut = pafData + static_cast<size_t>(i) * nLineSpace;
+			for (int j = 0; j < nXSize; j++) {
+				/* For detected products, in order to convert the digital number of a given range sample to a calibrated value,
+				the digital value is first squared, then the offset(B) is added and the result is divided by the gains value(A)
+				corresponding to the range sample. RCM-SP-53-0419  Issue 2/5:  January 2, 2018  Page 7-56 */
+				const float digitalValue = pafLine[j];
+				const float A = static_cast<float>(m_nfTable[nXOff + j]);
+				const float calibrated = ((digitalValue * digitalValue) + B) / A;
+				pafOut[j] = bCorrect ? static_cast<float>((calibrated - padfNoise[j]) / padfCosine[j]) : calibrated;
+			}
+		}
+	}
+}
+
 /************************************************************************/
 /*                        IReadBlock()                                  */
 /************************************************************************/
@@ -824,7 +1427,6 @@ RCMCalibRasterBand::~RCMCalibRasterBand() {
 CPLErr RCMCalibRasterBand::IReadBlock(int nBlockXOff, int nBlockYOff,
 	void *pImage )
 {
-	CPLErr eErr;
 	int nRequestYSize;
 	int nRequestXSize;
 
@@ -859,247 +1461,698 @@ CPLErr RCMCalibRasterBand::IReadBlock(int nBlockXOff, int nBlockYOff,
 		nRequestXSize = nBlockXSize;
 	}
 
-	if (this->m_eOriginalType == GDT_CInt16) {
-		GInt16 *pnImageTmp;
-		/* read in complex values */
-		pnImageTmp = (GInt16 *)CPLMalloc(2 * nBlockXSize * nBlockYSize *
-			GDALGetDataTypeSize(GDT_Int16) / 8);
-
-		if (m_poBandDataset->GetRasterCount() == 2) {
-			eErr = m_poBandDataset->RasterIO(GF_Read,
-				nBlockXOff * nBlockXSize,
-				nBlockYOff * nBlockYSize,
-				nRequestXSize, nRequestYSize,
-				pnImageTmp, nRequestXSize, nRequestYSize,
-				this->m_eOriginalType,
-				2, NULL, 4, nBlockXSize * 4, 4, NULL);
+	RCM_TRACE(RCM_TRACE_DEBUG, "IReadBlock", "nBlockXOff=%d nBlockYOff=%d", nBlockXOff, nBlockYOff);
 
-			/*
-			eErr = m_poBandDataset->RasterIO(GF_Read,
-				nBlockXOff * nBlockXSize,
-				nBlockYOff * nBlockYSize,
-				nRequestXSize, nRequestYSize,
-				pnImageTmp, nRequestXSize, nRequestYSize,
-				GDT_Int32,
-				2, NULL, 4, nBlockXSize * 4, 2, NULL);
-			*/
-		}
-		else {
-			eErr =
-				m_poBandDataset->RasterIO(GF_Read,
-					nBlockXOff * nBlockXSize,
-					nBlockYOff * nBlockYSize,
-					nRequestXSize, nRequestYSize,
-					pnImageTmp, nRequestXSize, nRequestYSize,
-					this->m_eOriginalType,
-					1, NULL, 4, nBlockXSize * 4, 0, NULL);
+	RCMPerfCounters::Add(m_oPerf.nBlocksRead, 1);
+	RCMPerfCounters::Add(m_oPerf.nBytesOut, static_cast<GIntBig>(nRequestXSize) * nRequestYSize *
+		GDALGetDataTypeSizeBytes(eDataType));
 
-			/*
-			eErr =
-				m_poBandDataset->RasterIO(GF_Read,
-					nBlockXOff * nBlockXSize,
-					nBlockYOff * nBlockYSize,
-					nRequestXSize, nRequestYSize,
-					pnImageTmp, nRequestXSize, nRequestYSize,
-					GDT_UInt32,
-					1, NULL, 4, nBlockXSize * 4, 0, NULL);
-			*/
+	if (m_poRCMDataset->IsReadahead())
+		StartReadahead(nBlockYOff);
 
-#ifdef CPL_LSB
-			/* First, undo the 32bit swap. */
-			GDALSwapWords(pImage, 4, nBlockXSize * nBlockYSize, 4);
+	if (m_poRCMDataset->GetSpeckleFilter() != SpeckleNone) {
+		return ReadFilteredBlock(nBlockXOff, nBlockYOff, nRequestXSize, nRequestYSize,
+			static_cast<float *>(pImage));
+	}
 
-			/* Then apply 16 bit swap. */
-			GDALSwapWords(pImage, 2, nBlockXSize * nBlockYSize * 2, 2);
-#endif        
-		}
+	return ReadMultilookedWindow(nBlockXOff * nBlockXSize, nBlockYOff * nBlockYSize,
+		nRequestXSize, nRequestYSize, static_cast<float *>(pImage), nBlockXSize);
+}
 
-#ifdef _TRACE_RCM
-		char msgBlocks[256] = "";
-		sprintf(msgBlocks, "IReadBlock: nBlockXOff=%d and nBlockYOff=%d ", nBlockXOff, nBlockYOff);
-		write_to_file(msgBlocks, "");
-#endif
+/************************************************************************/
+/*                       ReadMultilookedWindow()                        */
+/************************************************************************/
 
-		/* calibrate the complex values */
-		for (int i = 0; i < nRequestYSize; i++) {
-			for (int j = 0; j < nRequestXSize; j++) {
-				/* calculate pixel offset in memory*/
-				int nPixOff = (2 * (i * nBlockXSize)) + (j * 2);
-				int nTruePixOff = (i * nBlockXSize) + j;
+CPLErr RCMCalibRasterBand::ReadMultilookedWindow(int nXOff, int nYOff,
+	int nXSize, int nYSize, float *pafData, int nLineSpace)
+{
+	const int nAzimuthLooks = m_poRCMDataset->GetAzimuthLooks();
+	const int nRangeLooks = m_poRCMDataset->GetRangeLooks();
 
-				// Formula for Complex Q+J
-				float real = (float)pnImageTmp[nPixOff];
-				float img = (float)pnImageTmp[nPixOff + 1];
-				float digitalValue = (real * real) + (img * img);
-				float lutValue = m_nfTable[nBlockXOff*nBlockXSize + j];
-				float calibValue = digitalValue / (lutValue * lutValue);
-
-#ifdef _TRACE_RCM
-				if (nBlockXOff*nBlockXSize + j >= 4961) {
-					char msgBlocks[2048] = "";
-					sprintf(msgBlocks, "IReadBlock: [%d,%d] real=%f img=%f digitalValue=%f lutValue[%d]=%f calibValue=%f", i, j, real, img, digitalValue, (nBlockXOff*nBlockXSize + j), lutValue, calibValue);
-					write_to_file(msgBlocks, "");
-				}
-#endif
+	if (!m_poRCMDataset->IsMultilooked()) {
+		return ReadCalibratedWindow(nXOff, nYOff, nXSize, nYSize, pafData, nLineSpace);
+	}
 
-				((float *)pImage)[nTruePixOff] = calibValue;
+	/* -------------------------------------------------------------------- */
+	/*      Multilook: calibrate the full resolution window covering this   */
+	/*      window, then average each nAzimuthLooks x nRangeLooks cell in   */
+	/*      the linear power domain.                                        */
+	/* -------------------------------------------------------------------- */
+	const int nSrcXSize = nXSize * nRangeLooks;
+	const int nSrcYSize = nYSize * nAzimuthLooks;
+
+	float *pafSrc = static_cast<float *>(CPLMalloc(sizeof(float) * nSrcXSize * nSrcYSize));
+
+	CPLErr eErr = ReadCalibratedWindow(nXOff * nRangeLooks, nYOff * nAzimuthLooks,
+		nSrcXSize, nSrcYSize, pafSrc, nSrcXSize);
+
+	if (eErr == CE_None)
+		MultilookWindow(pafSrc, nXSize, nYSize, pafData, nLineSpace);
+
+	CPLFree(pafSrc);
+
+	return eErr;
+}
+
+/************************************************************************/
+/*                          MultilookWindow()                           */
+/************************************************************************/
+
+void RCMCalibRasterBand::MultilookWindow(const float *pafSource, int nXSize, int nYSize,
+	float *pafData, int nLineSpace)
+{
+	RCMPerfTimer oCalibrationTimer(m_oPerf.nCalibrationNanoseconds);
+
+	const int nAzimuthLooks = m_poRCMDataset->GetAzimuthLooks();
+	const int nRangeLooks = m_poRCMDataset->GetRangeLooks();
+	const int nSrcXSize = nXSize * nRangeLooks;
+	const double dfScale = 1.0 / (static_cast<double>(nAzimuthLooks) * nRangeLooks);
+	std::vector<double> adfSum(nXSize);
+
+	for (int i = 0; i < nYSize; i++) {
+		std::fill(adfSum.begin(), adfSum.end(), 0.0);
+
+		for (int k = 0; k < nAzimuthLooks; k++) {
+			const float *pafLine = pafSource + static_cast<size_t>(i * nAzimuthLooks + k) * nSrcXSize;
+			for (int j = 0; j < nXSize; j++) {
+				const float *pafCell = pafLine + j * nRangeLooks;
+				for (int l = 0; l < nRangeLooks; l++) {
+					adfSum[j] += pafCell[l];
+				}
 			}
 		}
 
-		CPLFree(pnImageTmp);
+		float *pafOut = pafData + static_cast<size_t>(i) * nLineSpace;
+		for (int j = 0; j < nXSize; j++) {
+			pafOut[j] = static_cast<float>(adfSum[j] * dfScale);
+		}
 	}
+}
 
-	//If the underlying file is NITF CFloat32
-	else if (this->m_eOriginalType == GDT_CFloat32 || this->m_eOriginalType == GDT_CFloat64)
-	{
-		/* read in complex values */
-		float *pnImageTmp;
+/************************************************************************/
+/*                          GetSourceWindow()                           */
+/************************************************************************/
+/* Full resolution window of m_poBandDataset read for a window of the   */
+/* band, with the speckle filter halo, clipped to the source.           */
+/************************************************************************/
 
-		int dataTypeSize = GDALGetDataTypeSize(this->m_eOriginalType) / 8;
-		GDALDataType bandFileType = this->m_eOriginalType;
-		int bandFileSize = GDALGetDataTypeSize(bandFileType) / 8;
+void RCMCalibRasterBand::GetSourceWindow(int *pnXOff, int *pnYOff, int *pnXSize, int *pnYSize)
+{
+	const int r = m_poRCMDataset->GetSpeckleFilter() != SpeckleNone ?
+		m_poRCMDataset->GetSpeckleWindow() / 2 : 0;
+	const int nRangeLooks = m_poRCMDataset->GetRangeLooks();
+	const int nAzimuthLooks = m_poRCMDataset->GetAzimuthLooks();
+
+	const int nXStart = std::max(0, *pnXOff - r) * nRangeLooks;
+	const int nYStart = std::max(0, *pnYOff - r) * nAzimuthLooks;
+	const int nXEnd = std::min(nRasterXSize, *pnXOff + *pnXSize + r) * nRangeLooks;
+	const int nYEnd = std::min(nRasterYSize, *pnYOff + *pnYSize + r) * nAzimuthLooks;
+
+	*pnXOff = nXStart;
+	*pnYOff = nYStart;
+	*pnXSize = std::max(0, std::min(nXEnd, m_poBandDataset->GetRasterXSize()) - nXStart);
+	*pnYSize = std::max(0, std::min(nYEnd, m_poBandDataset->GetRasterYSize()) - nYStart);
+}
 
-		/* read the original image complex values in a temporary image space */
-		pnImageTmp = (float *)CPLMalloc(2 * nBlockXSize * nBlockYSize * bandFileSize);
+/* 2 when I and Q are stored in separate bands, as in ReadComplexWindow() */
+int RCMCalibRasterBand::GetSourceBandCount()
+{
+	return m_poBandDataset->GetRasterCount() == 2 &&
+		!GDALDataTypeIsComplex(m_poBandDataset->GetRasterBand(1)->GetRasterDataType()) ? 2 : 1;
+}
 
-		eErr =
-			//I and Q from each band are pixel-interleaved into this complex band
-			m_poBandDataset->RasterIO(GF_Read,
-				nBlockXOff * nBlockXSize,
-				nBlockYOff * nBlockYSize,
-				nRequestXSize, nRequestYSize,
-				pnImageTmp, nRequestXSize, nRequestYSize,
-				bandFileType,
-				2, NULL, dataTypeSize, nBlockXSize * dataTypeSize, bandFileSize, NULL);
+/************************************************************************/
+/*                             AdviseRead()                             */
+/************************************************************************/
 
-		/* calibrate the complex values */
-		for (int i = 0; i < nRequestYSize; i++) {
-			for (int j = 0; j < nRequestXSize; j++) {
-				/* calculate pixel offset in memory*/
-				int nPixOff = (2 * (i * nBlockXSize)) + (j * 2);
-				int nTruePixOff = (i * nBlockXSize) + j;
+CPLErr RCMCalibRasterBand::AdviseRead(int nXOff, int nYOff, int nXSize, int nYSize,
+	int /* nBufXSize */, int /* nBufYSize */, GDALDataType /* eBufType */,
+	char **papszOptions)
+{
+	/* The source is always read at full resolution, in its own type */
+	GetSourceWindow(&nXOff, &nYOff, &nXSize, &nYSize);
+	if (nXSize == 0 || nYSize == 0)
+		return CE_None;
 
-				// Formula for Complex Q+J
-				float real = (float)pnImageTmp[nPixOff];
-				float img = (float)pnImageTmp[nPixOff + 1];
-				float digitalValue = (real * real) + (img * img);
-				float lutValue = m_nfTable[nBlockXOff*nBlockXSize + j];
-				float calibValue = digitalValue / (lutValue * lutValue);
+	int anBands[2] = { m_nSrcBand, m_nSrcBand + 1 };
+	return m_poBandDataset->AdviseRead(nXOff, nYOff, nXSize, nYSize, nXSize, nYSize,
+		m_poBandDataset->GetRasterBand(m_nSrcBand)->GetRasterDataType(),
+		GetSourceBandCount(), anBands, papszOptions);
+}
 
-				((float *)pImage)[nTruePixOff] = calibValue;
-			}
-		}
+static void RCMReadaheadRows(void *pData)
+{
+	RCMReadaheadJob *psJob = static_cast<RCMReadaheadJob *>(pData);
 
-		CPLFree(pnImageTmp);
+	if (psJob->poDataset == NULL) {
+		CPLPushErrorHandler(CPLQuietErrorHandler);
+		psJob->poDataset = static_cast<GDALDataset *>(GDALOpenEx(psJob->osSource,
+			GDAL_OF_RASTER | GDAL_OF_READONLY, NULL, NULL, NULL));
+		CPLPopErrorHandler();
 	}
 
-	else if (this->m_eOriginalType == GDT_Float32) {
-		/* A Float32 is actual 4 bytes */
-		eErr = m_poBandDataset->RasterIO(GF_Read,
-			nBlockXOff * nBlockXSize,
-			nBlockYOff * nBlockYSize,
-			nRequestXSize, nRequestYSize,
-			pImage, nRequestXSize, nRequestYSize,
-			GDT_Float32,
-			1, NULL, 4, nBlockXSize * 4, 0, NULL);
+	if (psJob->poDataset == NULL ||
+		psJob->poDataset->GetRasterCount() < psJob->nSrcBand + psJob->nBands - 1) {
+		psJob->bBusy.store(false, std::memory_order_release);
+		return;
+	}
 
-		/* iterate over detected values */
-		for (int i = 0; i < nRequestYSize; i++) {
-			for (int j = 0; j < nRequestXSize; j++) {
-				int nPixOff = (i * nBlockXSize) + j;
+	/* One source block at a time, the data itself is dropped */
+	GDALRasterBand *poBand = psJob->poDataset->GetRasterBand(psJob->nSrcBand);
+	const GDALDataType eType = poBand->GetRasterDataType();
+	int nSrcBlockXSize, nSrcBlockYSize;
+	poBand->GetBlockSize(&nSrcBlockXSize, &nSrcBlockYSize);
+	psJob->abyBuffer.resize(static_cast<size_t>(nSrcBlockXSize) * nSrcBlockYSize *
+		psJob->nBands * GDALGetDataTypeSizeBytes(eType));
+
+	int anBands[2] = { psJob->nSrcBand, psJob->nSrcBand + 1 };
+	const int nXEnd = psJob->nXOff + psJob->nXSize;
+	CPLPushErrorHandler(CPLQuietErrorHandler);
+	for (;;) {
+		/* The window is re-read after each source block row, so the rows */
+		/* queued meanwhile are read in the same run, and the rows the    */
+		/* owner has already passed are skipped                           */
+		bool bError = false;
+		for (;;) {
+			const int nStartY = std::max(psJob->nDoneY, psJob->nStartY.load(std::memory_order_acquire));
+			const int nEndY = psJob->nEndY.load(std::memory_order_acquire);
+			if (nStartY >= nEndY || bError)
+				break;
 
-				/* For detected products, in order to convert the digital number of a given range sample to a calibrated value,
-				the digital value is first squared, then the offset(B) is added and the result is divided by the gains value(A)
-				corresponding to the range sample. RCM-SP-53-0419  Issue 2/5:  January 2, 2018  Page 7-56 */
-				float digitalValue = ((float *)pImage)[nPixOff];
-				float A = m_nfTable[nBlockXOff*nBlockXSize + j];
-				((float *)pImage)[nPixOff] = ((digitalValue * digitalValue) + this->m_nfOffset) / A;
+			const int nY = nStartY - nStartY % nSrcBlockYSize;
+			const int nYCount = std::min(nY + nSrcBlockYSize, poBand->GetYSize()) - nY;
+			for (int nX = psJob->nXOff - psJob->nXOff % nSrcBlockXSize; nX < nXEnd; nX += nSrcBlockXSize) {
+				const int nXStart = std::max(nX, psJob->nXOff);
+				const int nXCount = std::min(nX + nSrcBlockXSize, nXEnd) - nXStart;
+				if (psJob->poDataset->RasterIO(GF_Read, nXStart, nY, nXCount, nYCount,
+					psJob->abyBuffer.data(), nXCount, nYCount, eType,
+					psJob->nBands, anBands, 0, 0, 0, NULL) != CE_None) {
+					bError = true;
+					break;
+				}
 			}
+			psJob->nDoneY = nY + nYCount;
+
+			/* Only the caches below GDAL are meant to be warm */
+			psJob->poDataset->FlushCache();
 		}
+
+		/* Rows queued after the last check restart the loop, unless the */
+		/* owner has already submitted a new run                         */
+		psJob->bBusy.store(false, std::memory_order_release);
+		if (bError || psJob->nEndY.load(std::memory_order_acquire) <=
+			std::max(psJob->nDoneY, psJob->nStartY.load(std::memory_order_acquire)))
+			break;
+		bool bIdle = false;
+		if (!psJob->bBusy.compare_exchange_strong(bIdle, true, std::memory_order_acq_rel))
+			break;
 	}
+	CPLPopErrorHandler();
+}
 
-	else if (this->m_eOriginalType == GDT_Float64) {
-		/* A Float64 is actual 8 bytes */
-		eErr = m_poBandDataset->RasterIO(GF_Read,
-			nBlockXOff * nBlockXSize,
-			nBlockYOff * nBlockYSize,
-			nRequestXSize, nRequestYSize,
-			pImage, nRequestXSize, nRequestYSize,
-			GDT_Float64,
-			1, NULL, 8, nBlockXSize * 8, 0, NULL);
+/************************************************************************/
+/*                           StartReadahead()                           */
+/************************************************************************/
+/* Queue the block rows after nBlockYOff, as many as READAHEAD asks.    */
+/* A running read picks the new window up, otherwise a read is          */
+/* submitted.                                                           */
+/************************************************************************/
 
-		/* iterate over detected values */
-		for (int i = 0; i < nRequestYSize; i++) {
-			for (int j = 0; j < nRequestXSize; j++) {
-				int nPixOff = (i * nBlockXSize) + j;
+void RCMCalibRasterBand::StartReadahead(int nBlockYOff)
+{
+	const int nYOff = (nBlockYOff + 1) * nBlockYSize;
+	if (nYOff >= nRasterYSize)
+		return;
 
-				/* For detected products, in order to convert the digital number of a given range sample to a calibrated value,
-				the digital value is first squared, then the offset(B) is added and the result is divided by the gains value(A)
-				corresponding to the range sample. RCM-SP-53-0419  Issue 2/5:  January 2, 2018  Page 7-56 */
-				float digitalValue = ((float *)pImage)[nPixOff];
-				float A = m_nfTable[nBlockXOff*nBlockXSize + j];
-				((float *)pImage)[nPixOff] = ((digitalValue * digitalValue) + this->m_nfOffset) / A;
-			}
+	if (m_psReadahead == NULL) {
+		/* Source window of the first block row, for its width and size */
+		int nXOff = 0, nFirstYOff = 0;
+		int nXSize = nRasterXSize, nYSize = std::min(nBlockYSize, nRasterYSize);
+		GetSourceWindow(&nXOff, &nFirstYOff, &nXSize, &nYSize);
+
+		m_psReadahead = new RCMReadaheadJob();
+		m_psReadahead->osSource = m_poBandDataset->GetDescription();
+		m_psReadahead->nSrcBand = m_nSrcBand;
+		m_psReadahead->nBands = GetSourceBandCount();
+		m_psReadahead->nXOff = nXOff;
+		m_psReadahead->nXSize = nXSize;
+
+		/* READAHEAD=YES: block rows holding RCM_READAHEAD_BYTES of source */
+		m_psReadahead->nRows = m_poRCMDataset->GetReadaheadRows();
+		if (m_psReadahead->nRows < 0) {
+			const GIntBig nRowBytes = static_cast<GIntBig>(nXSize) * std::max(1, nYSize) *
+				m_psReadahead->nBands * GDALGetDataTypeSizeBytes(
+					m_poBandDataset->GetRasterBand(m_nSrcBand)->GetRasterDataType());
+			m_psReadahead->nRows = static_cast<int>(std::max(static_cast<GIntBig>(1),
+				std::min(static_cast<GIntBig>(nRasterYSize),
+					RCM_READAHEAD_BYTES / std::max(static_cast<GIntBig>(1), nRowBytes))));
+		}
+
+		m_poReadaheadPool = new CPLWorkerThreadPool();
+		if (!m_poReadaheadPool->Setup(1, NULL, NULL)) {
+			delete m_poReadaheadPool;
+			m_poReadaheadPool = NULL;
 		}
 	}
 
-	else if (this->m_eOriginalType == GDT_UInt16) {
-		GUInt16 *pnImageTmp;
-		/* read in detected values */
-		pnImageTmp = (GUInt16 *)CPLMalloc(nBlockXSize * nBlockYSize *
-			GDALGetDataTypeSize(GDT_UInt16) / 8);
-		eErr = m_poBandDataset->RasterIO(GF_Read,
-			nBlockXOff * nBlockXSize,
-			nBlockYOff * nBlockYSize,
-			nRequestXSize, nRequestYSize,
-			pnImageTmp, nRequestXSize, nRequestYSize,
-			GDT_UInt16,
-			1, NULL, 2, nBlockXSize * 2, 0, NULL);
+	if (m_poReadaheadPool == NULL || m_psReadahead->nXSize == 0)
+		return;
 
-		/* iterate over detected values */
-		for (int i = 0; i < nRequestYSize; i++) {
-			for (int j = 0; j < nRequestXSize; j++) {
-				int nPixOff = (i * nBlockXSize) + j;
+	int nXOff = 0, nSrcYOff = nYOff;
+	int nXSize = nRasterXSize;
+	int nYSize = static_cast<int>(std::min(static_cast<GIntBig>(nRasterYSize - nYOff),
+		static_cast<GIntBig>(m_psReadahead->nRows) * nBlockYSize));
+	GetSourceWindow(&nXOff, &nSrcYOff, &nXSize, &nYSize);
+	if (nYSize == 0)
+		return;
 
-				float digitalValue = (float)pnImageTmp[nPixOff];
-				float A = m_nfTable[nBlockXOff*nBlockXSize + j];
-				((float *)pImage)[nPixOff] = ((digitalValue *	digitalValue) +	this->m_nfOffset) / A;
-			}
+	/* The window only moves forward */
+	if (nSrcYOff > m_psReadahead->nStartY.load(std::memory_order_relaxed))
+		m_psReadahead->nStartY.store(nSrcYOff, std::memory_order_release);
+	if (nSrcYOff + nYSize > m_psReadahead->nEndY.load(std::memory_order_relaxed))
+		m_psReadahead->nEndY.store(nSrcYOff + nYSize, std::memory_order_release);
+
+	/* A running read will see the new window before it stops */
+	bool bIdle = false;
+	if (m_psReadahead->bBusy.compare_exchange_strong(bIdle, true, std::memory_order_acq_rel) &&
+		!m_poReadaheadPool->SubmitJob(RCMReadaheadRows, m_psReadahead))
+		m_psReadahead->bBusy.store(false, std::memory_order_release);
+}
+
+/*** Rows of a block filtered by one thread ***/
+typedef struct
+{
+	eSpeckleFilter eFilter;
+	int nWindow;
+	double dfENL;
+	const float *pafIn;
+	int nInXSize;
+	int nInYSize;
+	const double *padfSum;
+	const double *padfSum2;
+	int iStartRow;
+	int iEndRow;
+	float *pafOut;
+	int nOutLineSpace;
+} RCMSpeckleJob;
+
+static void RCMSpeckleRows(void *pData)
+{
+	RCMSpeckleJob *psJob = static_cast<RCMSpeckleJob *>(pData);
+	RCMSpeckleFilter(psJob->eFilter, psJob->nWindow, psJob->dfENL,
+		psJob->pafIn, psJob->nInXSize, psJob->nInYSize, psJob->padfSum, psJob->padfSum2,
+		psJob->iStartRow, psJob->iEndRow, psJob->pafOut, psJob->nOutLineSpace);
+}
+
+/************************************************************************/
+/*                         ReadFilteredBlock()                          */
+/************************************************************************/
+/* The block is read with a halo of half the filter window, clipped to  */
+/* the raster, and the edges of the raster are replicated into the      */
+/* halo. Everything is sized by the block, never by the scene.          */
+/************************************************************************/
+
+CPLErr RCMCalibRasterBand::ReadFilteredBlock(int nBlockXOff, int nBlockYOff,
+	int nRequestXSize, int nRequestYSize, float *pafData)
+{
+	const int nWindow = m_poRCMDataset->GetSpeckleWindow();
+	const int r = nWindow / 2;
+	const int nXOff = nBlockXOff * nBlockXSize;
+	const int nYOff = nBlockYOff * nBlockYSize;
+
+	/* Halo window clipped to the raster */
+	const int nReadXOff = std::max(0, nXOff - r);
+	const int nReadYOff = std::max(0, nYOff - r);
+	const int nReadXSize = std::min(nRasterXSize, nXOff + nRequestXSize + r) - nReadXOff;
+	const int nReadYSize = std::min(nRasterYSize, nYOff + nRequestYSize + r) - nReadYOff;
+
+	std::vector<float> afRead(static_cast<size_t>(nReadXSize) * nReadYSize);
+	CPLErr eErr = ReadMultilookedWindow(nReadXOff, nReadYOff, nReadXSize, nReadYSize,
+		afRead.data(), nReadXSize);
+	if (eErr != CE_None)
+		return eErr;
+
+	RCMPerfTimer oCalibrationTimer(m_oPerf.nCalibrationNanoseconds);
+
+	/* Tile with a full halo, replicating the raster edges */
+	const int nInXSize = nRequestXSize + 2 * r;
+	const int nInYSize = nRequestYSize + 2 * r;
+	std::vector<float> afIn(static_cast<size_t>(nInXSize) * nInYSize);
+	for (int i = 0; i < nInYSize; i++) {
+		const int nLine = std::max(0, std::min(nRasterYSize - 1, nYOff - r + i)) - nReadYOff;
+		const float *pafSrc = afRead.data() + static_cast<size_t>(nLine) * nReadXSize;
+		float *pafDst = afIn.data() + static_cast<size_t>(i) * nInXSize;
+		for (int j = 0; j < nInXSize; j++) {
+			const int nPixel = std::max(0, std::min(nRasterXSize - 1, nXOff - r + j)) - nReadXOff;
+			pafDst[j] = pafSrc[nPixel];
 		}
-		CPLFree(pnImageTmp);
-	} /* Ticket #2104: Support for ScanSAR products */
+	}
 
-	else if (this->m_eOriginalType == GDT_Byte) {
-		GByte *pnImageTmp;
-		pnImageTmp = (GByte *)CPLMalloc(nBlockXSize * nBlockYSize *
-			GDALGetDataTypeSize(GDT_Byte) / 8);
-		eErr = m_poBandDataset->RasterIO(GF_Read,
-			nBlockXOff * nBlockXSize,
-			nBlockYOff * nBlockYSize,
-			nRequestXSize, nRequestYSize,
-			pnImageTmp, nRequestXSize, nRequestYSize,
-			GDT_Byte,
-			1, NULL, 1, nBlockXSize, 0, NULL);
+	const size_t nTableSize = (static_cast<size_t>(nInXSize) + 1) * (nInYSize + 1);
+	std::vector<double> adfSum(nTableSize), adfSum2(nTableSize);
+	RCMBuildSummedAreaTables(afIn.data(), nInXSize, nInYSize, adfSum.data(), adfSum2.data(), NULL);
+
+	/* The rows of the block are shared by NUM_THREADS */
+	CPLWorkerThreadPool *poPool = m_poRCMDataset->GetWorkerThreadPool();
+	const int nJobs = poPool != NULL ?
+		std::min(m_poRCMDataset->GetWorkerThreadCount(), nRequestYSize) : 1;
+	std::vector<RCMSpeckleJob> asJobs(nJobs);
+	for (int iJob = 0; iJob < nJobs; iJob++) {
+		RCMSpeckleJob &sJob = asJobs[iJob];
+		sJob.eFilter = m_poRCMDataset->GetSpeckleFilter();
+		sJob.nWindow = nWindow;
+		sJob.dfENL = m_poRCMDataset->GetSpeckleENL();
+		sJob.pafIn = afIn.data();
+		sJob.nInXSize = nInXSize;
+		sJob.nInYSize = nInYSize;
+		sJob.padfSum = adfSum.data();
+		sJob.padfSum2 = adfSum2.data();
+		RCMGetJobRows(nRequestYSize, nJobs, iJob, &sJob.iStartRow, &sJob.iEndRow);
+		sJob.pafOut = pafData;
+		sJob.nOutLineSpace = nBlockXSize;
+
+		if (nJobs > 1)
+			poPool->SubmitJob(RCMSpeckleRows, &sJob);
+		else
+			RCMSpeckleRows(&sJob);
+	}
+	if (nJobs > 1)
+		poPool->WaitCompletion();
 
-		/* iterate over detected values */
-		for (int i = 0; i < nRequestYSize; i++) {
-			for (int j = 0; j < nRequestXSize; j++) {
-				int nPixOff = (i * nBlockXSize) + j;
+	return CE_None;
+}
+
+/************************************************************************/
+/*                         ComputeStatistics()                          */
+/************************************************************************/
+/* There are no overviews, so approximate statistics come from a        */
+/* deterministic sample of blocks: every column of blocks, that is      */
+/* every part of the range and of the LUT, gets the same number of      */
+/* blocks, spread over the azimuth with a per column phase. About       */
+/* RCM_APPROX_STATS_PIXELS pixels are read. The median and the 2 and 98 */
+/* percentiles are stored with the statistics, all kept in PAM.         */
+/************************************************************************/
+
+static const GIntBig RCM_APPROX_STATS_PIXELS = 1 << 20;
 
-				float digitalValue = (float)pnImageTmp[nPixOff];
-				float A = m_nfTable[nBlockXOff*nBlockXSize + j];
-				((float *)pImage)[nPixOff] = ((digitalValue * digitalValue) + this->m_nfOffset) / A;
+CPLErr RCMCalibRasterBand::ComputeStatistics(int bApproxOK, double *pdfMin, double *pdfMax,
+	double *pdfMean, double *pdfStdDev, GDALProgressFunc pfnProgress, void *pProgressData)
+{
+	if (!bApproxOK || eDataType != GDT_Float32) {
+		/* The order statistics only exist for the sampled statistics */
+		SetMetadataItem("STATISTICS_PERCENTILE_2", NULL);
+		SetMetadataItem("STATISTICS_MEDIAN", NULL);
+		SetMetadataItem("STATISTICS_PERCENTILE_98", NULL);
+		SetMetadataItem("STATISTICS_SAMPLED_BLOCKS", NULL);
+		return GDALPamRasterBand::ComputeStatistics(bApproxOK, pdfMin, pdfMax, pdfMean,
+			pdfStdDev, pfnProgress, pProgressData);
+	}
+
+	if (pfnProgress == NULL)
+		pfnProgress = GDALDummyProgress;
+
+	const int nBlocksPerRow = (nRasterXSize + nBlockXSize - 1) / nBlockXSize;
+	const int nBlocksPerColumn = (nRasterYSize + nBlockYSize - 1) / nBlockYSize;
+	const GIntBig nBlockPixels = static_cast<GIntBig>(nBlockXSize) * nBlockYSize;
+	const int nPerColumn = static_cast<int>(std::max(static_cast<GIntBig>(1), std::min(
+		static_cast<GIntBig>(nBlocksPerColumn),
+		(RCM_APPROX_STATS_PIXELS / nBlockPixels + nBlocksPerRow - 1) / nBlocksPerRow)));
+
+	int bGotNoData = FALSE;
+	const double dfNoData = GetNoDataValue(&bGotNoData);
+	const float fNoData = static_cast<float>(dfNoData);
+
+	std::vector<float> afValues;
+	afValues.reserve(static_cast<size_t>(std::min(RCM_APPROX_STATS_PIXELS * 2,
+		nBlockPixels * nPerColumn * nBlocksPerRow)));
+	double dfSum = 0.0;
+	GIntBig nSampleCount = 0;
+
+	for (int iXBlock = 0; iXBlock < nBlocksPerRow; iXBlock++) {
+		/* Golden ratio phase, so that neighbouring columns sample other lines */
+		const double dfPhase = fmod(0.5 + iXBlock * 0.6180339887498949, 1.0);
+
+		for (int i = 0; i < nPerColumn; i++) {
+			const int iYBlock = std::min(nBlocksPerColumn - 1,
+				static_cast<int>((i + dfPhase) * nBlocksPerColumn / nPerColumn));
+
+			GDALRasterBlock *poBlock = GetLockedBlockRef(iXBlock, iYBlock);
+			if (poBlock == NULL)
+				return CE_Failure;
+
+			const float *pafData = static_cast<const float *>(poBlock->GetDataRef());
+			const int nXCheck = std::min(nBlockXSize, nRasterXSize - iXBlock * nBlockXSize);
+			const int nYCheck = std::min(nBlockYSize, nRasterYSize - iYBlock * nBlockYSize);
+
+			for (int iY = 0; iY < nYCheck; iY++) {
+				const float *pafLine = pafData + static_cast<size_t>(iY) * nBlockXSize;
+				for (int iX = 0; iX < nXCheck; iX++) {
+					const float fValue = pafLine[iX];
+					if (CPLIsNan(fValue) || (bGotNoData && fValue == fNoData))
+						continue;
+					afValues.push_back(fValue);
+					dfSum += fValue;
+				}
 			}
+			nSampleCount += static_cast<GIntBig>(nXCheck) * nYCheck;
+
+			poBlock->DropLock();
+		}
+
+		if (!pfnProgress((iXBlock + 1) / static_cast<double>(nBlocksPerRow),
+			"Compute Statistics", pProgressData)) {
+			CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+			return CE_Failure;
 		}
-		CPLFree(pnImageTmp);
 	}
-	else {
-		CPLAssert(FALSE);
+
+	if (afValues.empty()) {
+		CPLError(CE_Failure, CPLE_AppDefined,
+			"Failed to compute statistics, no valid pixels found in sampling.");
+		return CE_Failure;
+	}
+
+	/* Two passes over the sample for an accurate standard deviation */
+	const size_t nCount = afValues.size();
+	const double dfMean = dfSum / nCount;
+	double dfM2 = 0.0;
+	for (size_t i = 0; i < nCount; i++)
+		dfM2 += (afValues[i] - dfMean) * (afValues[i] - dfMean);
+	const double dfStdDev = sqrt(dfM2 / nCount);
+
+	/* Order statistics, each nth_element narrows the next one */
+	const size_t n02 = static_cast<size_t>(0.02 * (nCount - 1));
+	const size_t n50 = static_cast<size_t>(0.50 * (nCount - 1));
+	const size_t n98 = static_cast<size_t>(0.98 * (nCount - 1));
+	std::nth_element(afValues.begin(), afValues.begin() + n50, afValues.end());
+	std::nth_element(afValues.begin(), afValues.begin() + n02, afValues.begin() + n50);
+	std::nth_element(afValues.begin() + n50, afValues.begin() + n98, afValues.end());
+	const double dfMin = *std::min_element(afValues.begin(), afValues.begin() + n02 + 1);
+	const double dfMax = *std::max_element(afValues.begin() + n98, afValues.end());
+
+	SetMetadataItem("STATISTICS_APPROXIMATE", "YES");
+	SetMetadataItem("STATISTICS_PERCENTILE_2", CPLSPrintf("%.9g", afValues[n02]));
+	SetMetadataItem("STATISTICS_MEDIAN", CPLSPrintf("%.9g", afValues[n50]));
+	SetMetadataItem("STATISTICS_PERCENTILE_98", CPLSPrintf("%.9g", afValues[n98]));
+	SetMetadataItem("STATISTICS_SAMPLED_BLOCKS", CPLSPrintf("%d", nPerColumn * nBlocksPerRow));
+	SetStatistics(dfMin, dfMax, dfMean, dfStdDev);
+	SetMetadataItem("STATISTICS_VALID_PERCENT",
+		CPLSPrintf("%.4g", 100.0 * nCount / nSampleCount));
+
+	if (pdfMin != NULL)
+		*pdfMin = dfMin;
+	if (pdfMax != NULL)
+		*pdfMax = dfMax;
+	if (pdfMean != NULL)
+		*pdfMean = dfMean;
+	if (pdfStdDev != NULL)
+		*pdfStdDev = dfStdDev;
+
+	return CE_None;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                        RCMGeometryRasterBand                         */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                       RCMGeometryRasterBand()                        */
+/************************************************************************/
+
+RCMGeometryRasterBand::RCMGeometryRasterBand(RCMDataset *poDataset,
+	eGeometryLayer eLayer, int nBandIn, const char *pszLayerName) :
+	m_poRCMDataset(poDataset),
+	m_eLayer(eLayer)
+{
+	poDS = poDataset;
+	nBand = nBandIn;
+	eDataType = GDT_Float64;
+
+	/* One block per line, a line is computed in a single pass */
+	nBlockXSize = poDataset->GetRasterXSize();
+	nBlockYSize = 1;
+
+	SetDescription(pszLayerName);
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr RCMGeometryRasterBand::IReadBlock(int /* nBlockXOff */, int nBlockYOff,
+	void *pImage)
+{
+	if (m_eLayer != GeomLatLon)
+		return m_poRCMDataset->ComputeGeometryLine(m_eLayer, nBlockYOff,
+			static_cast<double *>(pImage));
+
+	/* -------------------------------------------------------------------- */
+	/*      The inversion gives both coordinates: the other band of the    */
+	/*      line goes to its block cache, unless it is already there.      */
+	/* -------------------------------------------------------------------- */
+	if (!m_poRCMDataset->GetRPCModel()->IsValid())
 		return CE_Failure;
+
+	RCMGeometryRasterBand *poOther = static_cast<RCMGeometryRasterBand *>(
+		poDS->GetRasterBand(nBand == 1 ? 2 : 1));
+	std::vector<double> adfOther;
+	double *padfOther = NULL;
+
+	GDALRasterBlock *poBlock = poOther->TryGetLockedBlockRef(0, nBlockYOff);
+	if (poBlock != NULL) {
+		poBlock->DropLock();
+		poBlock = NULL;
+	}
+	else
+		poBlock = poOther->GetLockedBlockRef(0, nBlockYOff, TRUE);
+
+	if (poBlock != NULL)
+		padfOther = static_cast<double *>(poBlock->GetDataRef());
+	else {
+		adfOther.resize(nBlockXSize);
+		padfOther = adfOther.data();
 	}
+
+	double *padfThis = static_cast<double *>(pImage);
+	const CPLErr eErr = m_poRCMDataset->ComputeLatLonLine(nBlockYOff,
+		nBand == 1 ? padfThis : padfOther, nBand == 1 ? padfOther : padfThis);
+
+	if (poBlock != NULL)
+		poBlock->DropLock();
+
 	return eErr;
 }
 
+/************************************************************************/
+/* ==================================================================== */
+/*                      RCMPolarimetricRasterBand                       */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                     RCMPolarimetricRasterBand()                      */
+/************************************************************************/
+
+RCMPolarimetricRasterBand::RCMPolarimetricRasterBand(RCMDataset *poDataset,
+	int nBandIn, const char *pszBandName, int nBlockXSizeIn, int nBlockYSizeIn,
+	GDALColorInterp eColorInterp) :
+	m_poRCMDataset(poDataset),
+	m_eColorInterp(eColorInterp)
+{
+	poDS = poDataset;
+	nBand = nBandIn;
+	eDataType = GDT_Float32;
+
+	nBlockXSize = nBlockXSizeIn;
+	nBlockYSize = nBlockYSizeIn;
+
+	SetDescription(pszBandName);
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr RCMPolarimetricRasterBand::IReadBlock(int nBlockXOff, int nBlockYOff,
+	void *pImage)
+{
+	return m_poRCMDataset->ComputePolarimetricBlock(nBlockXOff, nBlockYOff, nBand, pImage);
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                    RCMCrossCorrelationRasterBand                     */
+/* ==================================================================== */
+/************************************************************************/
+
+/************************************************************************/
+/*                   RCMCrossCorrelationRasterBand()                    */
+/************************************************************************/
+
+RCMCrossCorrelationRasterBand::RCMCrossCorrelationRasterBand(RCMDataset *poDataset,
+	int nBandIn, GDALDataset *poBandFile, int nSrcBand, bool bTwoBandComplex) :
+	m_poBandFile(poBandFile),
+	m_nSrcBand(nSrcBand),
+	m_bTwoBandComplex(bTwoBandComplex)
+{
+	poDS = poDataset;
+	nBand = nBandIn;
+
+	GDALRasterBand *poSrcBand = poBandFile->GetRasterBand(nSrcBand);
+	poSrcBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+
+	/* I and Q bands are returned as the matching complex type */
+	eDataType = poSrcBand->GetRasterDataType();
+	if (bTwoBandComplex) {
+		switch (eDataType) {
+		case GDT_Int16: eDataType = GDT_CInt16; break;
+		case GDT_Int32: eDataType = GDT_CInt32; break;
+		case GDT_Float64: eDataType = GDT_CFloat64; break;
+		default: eDataType = GDT_CFloat32; break;
+		}
+	}
+
+	SetMetadataItem("POLARIMETRIC_INTERP", "XC");
+}
+
+/************************************************************************/
+/*                             IReadBlock()                             */
+/************************************************************************/
+
+CPLErr RCMCrossCorrelationRasterBand::IReadBlock(int nBlockXOff, int nBlockYOff,
+	void *pImage)
+{
+	const int nRequestXSize = std::min(nBlockXSize, nRasterXSize - nBlockXOff * nBlockXSize);
+	const int nRequestYSize = std::min(nBlockYSize, nRasterYSize - nBlockYOff * nBlockYSize);
+	const int dataTypeSize = GDALGetDataTypeSizeBytes(eDataType);
+
+	/* Partial blocks on the right and bottom edges are padded with 0 */
+	if (nRequestXSize < nBlockXSize || nRequestYSize < nBlockYSize)
+		memset(pImage, 0, static_cast<size_t>(dataTypeSize) * nBlockXSize * nBlockYSize);
+
+	if (m_bTwoBandComplex) {
+		/* I and Q from each band are pixel-interleaved into this complex band */
+		int anBands[2] = { m_nSrcBand, m_nSrcBand + 1 };
+		const GDALDataType eBandFileType = m_poBandFile->GetRasterBand(m_nSrcBand)->GetRasterDataType();
+
+		return m_poBandFile->RasterIO(GF_Read,
+			nBlockXOff * nBlockXSize, nBlockYOff * nBlockYSize,
+			nRequestXSize, nRequestYSize,
+			pImage, nRequestXSize, nRequestYSize,
+			eBandFileType,
+			2, anBands, dataTypeSize, static_cast<GSpacing>(dataTypeSize) * nBlockXSize,
+			dataTypeSize / 2, NULL);
+	}
+
+	return m_poBandFile->GetRasterBand(m_nSrcBand)->RasterIO(GF_Read,
+		nBlockXOff * nBlockXSize, nBlockYOff * nBlockYSize,
+		nRequestXSize, nRequestYSize,
+		pImage, nRequestXSize, nRequestYSize,
+		eDataType, dataTypeSize, static_cast<GSpacing>(dataTypeSize) * nBlockXSize, NULL);
+}
+
 /************************************************************************/
 /* ==================================================================== */
 /*                              RCMDataset                              */
@@ -1123,6 +2176,32 @@ RCMDataset::RCMDataset() :
 	papszExtraFiles(NULL),
 	m_nfIncidenceAngleTable(NULL),
 	m_IncidenceAngleTableSize(0),
+	nAzimuthLooks(1),
+	nRangeLooks(1),
+	nFullRasterXSize(0),
+	nFullRasterYSize(0),
+	bNoiseSubtraction(false),
+	dfTerrainHeight(0.0),
+	dfSemiMajorAxis(6378137.0),
+	dfSemiMinorAxis(6356752.314245),
+	bHaveLineTimes(false),
+	dfFirstLineTime(0.0),
+	dfLastLineTime(0.0),
+	dfLineTimeInterval(0.0),
+	bSlantRangeGeometry(false),
+	bPixelTimeIncreasing(true),
+	dfSlantRangeNearEdge(0.0),
+	dfPixelSpacing(0.0),
+	ePolarimetry(PolNone),
+	poCrossCorrelationFile(NULL),
+	nWorkerThreads(1),
+	poWorkerThreadPool(NULL),
+	eSpeckle(SpeckleNone),
+	nSpeckleWindow(7),
+	dfSpeckleENL(1.0),
+	nReadaheadRows(0),
+	nXMLParseNanoseconds(0),
+	papszPerf(NULL),
 	isComplexData(FALSE),
 	magnitudeBits(16),
 	realBitsComplexData(32),
@@ -1145,6 +2224,8 @@ RCMDataset::~RCMDataset()
 {
 	FlushCache();
 
+	delete poWorkerThreadPool;
+
 	CPLDestroyXMLNode(psProduct);
 	CPLFree(pszProjection);
 	CPLFree(pszGCPProjection);
@@ -1161,6 +2242,8 @@ RCMDataset::~RCMDataset()
 	if (papszSubDatasets != NULL )
 		CSLDestroy(papszSubDatasets);
 
+	CSLDestroy(papszPerf);
+
 	if (papszExtraFiles != NULL)
 		CSLDestroy(papszExtraFiles);
 
@@ -1189,54 +2272,279 @@ int RCMDataset::CloseDependentDatasets()
 	}
 	nBands = 0;
 
+	/* The polarimetric inputs own their band files */
+	if (!apoPolChannels.empty())
+		bHasDroppedRef = TRUE;
+
+	for (size_t i = 0; i < apoPolChannels.size(); i++)
+	{
+		delete apoPolChannels[i];
+	}
+	apoPolChannels.clear();
+
+	/* Closed after the XC bands that read it */
+	if (poCrossCorrelationFile != NULL)
+	{
+		GDALClose(reinterpret_cast<GDALDatasetH>(poCrossCorrelationFile));
+		poCrossCorrelationFile = NULL;
+		bHasDroppedRef = TRUE;
+	}
+
 	return bHasDroppedRef;
 }
 
 /************************************************************************/
-/*                            GetFileList()                             */
+/*                        GetWorkerThreadPool()                         */
 /************************************************************************/
 
-char **RCMDataset::GetFileList()
-
+CPLWorkerThreadPool *RCMDataset::GetWorkerThreadPool()
 {
-	char **papszFileList = GDALPamDataset::GetFileList();
-
-	papszFileList = CSLInsertStrings(papszFileList, -1, papszExtraFiles);
+	if (nWorkerThreads > 1 && poWorkerThreadPool == NULL) {
+		poWorkerThreadPool = new CPLWorkerThreadPool();
+		if (!poWorkerThreadPool->Setup(nWorkerThreads, NULL, NULL)) {
+			delete poWorkerThreadPool;
+			poWorkerThreadPool = NULL;
+			nWorkerThreads = 1;
+		}
+	}
 
-	return papszFileList;
+	return poWorkerThreadPool;
 }
 
 /************************************************************************/
-/*                             Identify()                               */
+/*                      ComputePolarimetricBlock()                      */
+/************************************************************************/
+/* The input channels are read once per block as calibrated complex     */
+/* samples, multilooked into the Stokes vector or the 3x3 matrix, and   */
+/* every output band is derived from it in the same pass. Output bands  */
+/* other than the requested one are stored in the block cache unless    */
+/* already there, so reading all the bands costs a single read of the   */
+/* channels.                                                            */
 /************************************************************************/
 
-int RCMDataset::Identify(GDALOpenInfo *poOpenInfo)
+CPLErr RCMDataset::ComputePolarimetricBlock(int nBlockXOff, int nBlockYOff,
+	int nRequestBand, void *pImage)
 {
-	/* Check for the case where we're trying to read the calibrated data: */
-	CPLString calibrationFormat = FormatCalibration(NULL, NULL);
+	const size_t nChannels = apoPolChannels.size();
+	const bool bMatrix = ePolarimetry == PolC3 || ePolarimetry == PolT3 ||
+		ePolarimetry == PolPauli || ePolarimetry == PolHAAlpha;
+	if (nChannels != (bMatrix ? 4 : 2)) {
+		const char msgError[] = "ERROR: The RCM polarimetric product has no input channels.";
+		write_to_file_error(msgError, "");
+		CPLError(CE_Failure, CPLE_AppDefined, "%s", msgError);
+		return CE_Failure;
+	}
 
-	if (STARTS_WITH_CI(poOpenInfo->pszFilename, calibrationFormat)) {
-		return TRUE;
+	int nBlockXSize = 0;
+	int nBlockYSize = 0;
+	GetRasterBand(nRequestBand)->GetBlockSize(&nBlockXSize, &nBlockYSize);
+
+	const int nXOff = nBlockXOff * nBlockXSize;
+	const int nYOff = nBlockYOff * nBlockYSize;
+	const int nRequestXSize = std::min(nBlockXSize, nRasterXSize - nXOff);
+	const int nRequestYSize = std::min(nBlockYSize, nRasterYSize - nYOff);
+	const int nSrcXSize = nRequestXSize * nRangeLooks;
+	const int nSrcYSize = nRequestYSize * nAzimuthLooks;
+	const size_t nSrcValues = 2 * static_cast<size_t>(nSrcXSize) * nSrcYSize;
+
+	/* One calibrated window per channel, in the order of the product table */
+	std::vector<float *> apafChannels(nChannels, static_cast<float *>(NULL));
+	CPLErr eErr = CE_None;
+	for (size_t i = 0; i < nChannels && eErr == CE_None; i++) {
+		apafChannels[i] = static_cast<float *>(CPLMalloc(sizeof(float) * nSrcValues));
+		eErr = apoPolChannels[i]->ReadCalibratedComplexWindow(nXOff * nRangeLooks,
+			nYOff * nAzimuthLooks, nSrcXSize, nSrcYSize, apafChannels[i]);
 	}
 
+	if (eErr == CE_None) {
+		/* Multilooked Stokes vector (4 planes) or matrix (9 planes) */
+		const size_t nPlane = static_cast<size_t>(nRequestXSize) * nRequestYSize;
+		std::vector<double> adfPlanes((bMatrix ? 9 : 4) * nPlane);
+		if (bMatrix)
+			RCMComputeMatrix3(apafChannels[0], apafChannels[1], apafChannels[2], apafChannels[3],
+				nRequestXSize, nRequestYSize, nRangeLooks, nAzimuthLooks,
+				ePolarimetry != PolC3, adfPlanes.data());
+		else
+			RCMComputeStokes(apafChannels[0], apafChannels[1], nRequestXSize, nRequestYSize,
+				nRangeLooks, nAzimuthLooks, adfPlanes.data());
+
+		/* The eigen decomposition dominates, its rows are shared by NUM_THREADS */
+		std::vector<double> adfHAAlpha;
+		if (ePolarimetry == PolHAAlpha) {
+			adfHAAlpha.resize(3 * nPlane);
+
+			CPLWorkerThreadPool *poPool = GetWorkerThreadPool();
+
+			const int nJobs = poPool != NULL ? std::min(nWorkerThreads, nRequestYSize) : 1;
+			std::vector<RCMDecompositionJob> asJobs(nJobs);
+			for (int iJob = 0; iJob < nJobs; iJob++) {
+				RCMDecompositionJob &sJob = asJobs[iJob];
+				sJob.padfT3 = adfPlanes.data();
+				sJob.nPlane = nPlane;
+				int iStartRow, iEndRow;
+				RCMGetJobRows(nRequestYSize, nJobs, iJob, &iStartRow, &iEndRow);
+				sJob.nStart = static_cast<size_t>(iStartRow) * nRequestXSize;
+				sJob.nEnd = static_cast<size_t>(iEndRow) * nRequestXSize;
+				sJob.padfHAAlpha = adfHAAlpha.data();
+
+				if (nJobs > 1)
+					poPool->SubmitJob(RCMDecompositionRows, &sJob);
+				else
+					RCMDecompositionRows(&sJob);
+			}
+			if (nJobs > 1)
+				poPool->WaitCompletion();
+		}
 
-	if (poOpenInfo->bIsDirectory)
-	{
-		/* Check for directory access when there is a product.xml file in the
-		directory. */
-		CPLString osMDFilename =
-			CPLFormCIFilename(poOpenInfo->pszFilename, "product.xml", NULL);
+		/* Destination of every band: pImage, a new cache block or none */
+		std::vector<GDALRasterBlock *> apoBlocks(nBands, static_cast<GDALRasterBlock *>(NULL));
+		std::vector<float *> apafOut(nBands, static_cast<float *>(NULL));
+		for (int iBand = 0; iBand < nBands; iBand++) {
+			if (iBand + 1 == nRequestBand) {
+				apafOut[iBand] = static_cast<float *>(pImage);
+				continue;
+			}
 
-		VSIStatBufL sStat;
-		if (VSIStatL(osMDFilename, &sStat) == 0)
-		{
-			CPLXMLNode *psProduct = CPLParseXMLFile(osMDFilename);
-			if (psProduct == NULL)
-				return FALSE;
+			RCMPolarimetricRasterBand *poBand = static_cast<RCMPolarimetricRasterBand *>(GetRasterBand(iBand + 1));
+			GDALRasterBlock *poBlock = poBand->TryGetLockedBlockRef(nBlockXOff, nBlockYOff);
+			if (poBlock != NULL) {
+				poBlock->DropLock();
+				continue;
+			}
 
-			CPLXMLNode *psProductAttributes = CPLGetXMLNode(psProduct, "=product");
-			if (psProductAttributes == NULL)
-			{
+			poBlock = poBand->GetLockedBlockRef(nBlockXOff, nBlockYOff, TRUE);
+			if (poBlock != NULL) {
+				apoBlocks[iBand] = poBlock;
+				apafOut[iBand] = static_cast<float *>(poBlock->GetDataRef());
+			}
+		}
+
+		/* Partial blocks on the right and bottom edges are padded with 0 */
+		if (nRequestXSize < nBlockXSize || nRequestYSize < nBlockYSize) {
+			for (int iBand = 0; iBand < nBands; iBand++) {
+				if (apafOut[iBand] != NULL)
+					memset(apafOut[iBand], 0, sizeof(float) * nBlockXSize * nBlockYSize);
+			}
+		}
+
+		const double *padfS0 = adfPlanes.data();
+		const double *padfS1 = padfS0 + nPlane;
+		const double *padfS2 = padfS1 + nPlane;
+		const double *padfS3 = padfS2 + nPlane;
+		std::vector<double> adfValues(nBands, 0.0);
+
+		for (int i = 0; i < nRequestYSize; i++) {
+			for (int j = 0; j < nRequestXSize; j++) {
+				const size_t n = static_cast<size_t>(i) * nRequestXSize + j;
+
+				switch (ePolarimetry) {
+				case PolStokes:
+					adfValues[0] = padfS0[n];
+					adfValues[1] = padfS1[n];
+					adfValues[2] = padfS2[n];
+					adfValues[3] = padfS3[n];
+					adfValues[4] = RCMStokesDegreeOfPolarization(padfS0[n], padfS1[n], padfS2[n], padfS3[n]);
+					break;
+				case PolMChi:
+					RCMStokesMChi(padfS0[n], padfS1[n], padfS2[n], padfS3[n],
+						&adfValues[0], &adfValues[1], &adfValues[2]);
+					break;
+				case PolPauli:
+					/* |HH - VV|^2 / 2, 2 |HV|^2 and |HH + VV|^2 / 2 are T22, T33, T11 */
+					adfValues[0] = adfPlanes[5 * nPlane + n];
+					adfValues[1] = adfPlanes[8 * nPlane + n];
+					adfValues[2] = adfPlanes[n];
+					break;
+				case PolHAAlpha:
+					adfValues[0] = adfHAAlpha[n];
+					adfValues[1] = adfHAAlpha[nPlane + n];
+					adfValues[2] = adfHAAlpha[2 * nPlane + n];
+					break;
+				default:
+					/* The matrix elements are the bands */
+					for (int iBand = 0; iBand < nBands; iBand++)
+						adfValues[iBand] = adfPlanes[iBand * nPlane + n];
+					break;
+				}
+
+				for (int iBand = 0; iBand < nBands; iBand++) {
+					if (apafOut[iBand] != NULL)
+						apafOut[iBand][static_cast<size_t>(i) * nBlockXSize + j] = static_cast<float>(adfValues[iBand]);
+				}
+			}
+		}
+
+		for (int iBand = 0; iBand < nBands; iBand++) {
+			if (apoBlocks[iBand] != NULL)
+				apoBlocks[iBand]->DropLock();
+		}
+	}
+
+	for (size_t i = 0; i < nChannels; i++)
+		CPLFree(apafChannels[i]);
+
+	return eErr;
+}
+
+/************************************************************************/
+/*                            GetFileList()                             */
+/************************************************************************/
+
+char **RCMDataset::GetFileList()
+
+{
+	char **papszFileList = GDALPamDataset::GetFileList();
+
+	papszFileList = CSLInsertStrings(papszFileList, -1, papszExtraFiles);
+
+	return papszFileList;
+}
+
+/************************************************************************/
+/*                             Identify()                               */
+/************************************************************************/
+
+int RCMDataset::Identify(GDALOpenInfo *poOpenInfo)
+{
+	/* Check for the case where we're trying to read the calibrated data: */
+	CPLString calibrationFormat = FormatCalibration(NULL, NULL);
+
+	if (STARTS_WITH_CI(poOpenInfo->pszFilename, calibrationFormat)) {
+		return TRUE;
+	}
+
+	/* Check for the case where we're trying to read a virtual geometry layer: */
+	CPLString geometryFormat = FormatGeometry(NULL, NULL);
+
+	if (STARTS_WITH_CI(poOpenInfo->pszFilename, geometryFormat)) {
+		return TRUE;
+	}
+
+	/* Check for the case where we're trying to read a derived polarimetric product: */
+	CPLString polarimetryFormat = FormatPolarimetry(NULL, NULL);
+
+	if (STARTS_WITH_CI(poOpenInfo->pszFilename, polarimetryFormat)) {
+		return TRUE;
+	}
+
+
+	if (poOpenInfo->bIsDirectory)
+	{
+		/* Check for directory access when there is a product.xml file in the
+		directory. */
+		CPLString osMDFilename =
+			CPLFormCIFilename(poOpenInfo->pszFilename, "product.xml", NULL);
+
+		VSIStatBufL sStat;
+		if (VSIStatL(osMDFilename, &sStat) == 0)
+		{
+			CPLXMLNode *psProduct = CPLParseXMLFile(osMDFilename);
+			if (psProduct == NULL)
+				return FALSE;
+
+			CPLXMLNode *psProductAttributes = CPLGetXMLNode(psProduct, "=product");
+			if (psProductAttributes == NULL)
+			{
 				CPLDestroyXMLNode(psProduct);
 				return FALSE;
 			}
@@ -1340,6 +2648,10 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		{
 			eCalib = Beta0;
 		}
+		else if (STARTS_WITH_CI(pszFilename, szGAMMA0_ELLIPSOID)) {
+			/* Before GAMMA, which is a prefix of it */
+			eCalib = Gamma0Ellipsoid;
+		}
 		else if (STARTS_WITH_CI(pszFilename, szSIGMA0)) {
 			eCalib = Sigma0;
 		}
@@ -1370,6 +2682,85 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			poOpenInfo->bIsDirectory = VSI_ISDIR(sStat.st_mode);
 	}
 
+	eGeometryLayer eGeometry = GeomNone;
+	const char *pszGeometryName = NULL;
+
+	CPLString geometryFormat(FormatGeometry(NULL, NULL));
+
+	if (STARTS_WITH_CI(pszFilename, geometryFormat)) {
+		// The layer name and filename begins after the hard coded layer name
+		pszFilename += strlen(szLayerGeometry) + 1;
+
+		for (size_t i = 0; i < CPL_ARRAYSIZE(asGeometryLayers); i++)
+		{
+			const char *pszName = asGeometryLayers[i].pszName;
+			if (STARTS_WITH_CI(pszFilename, pszName) && pszFilename[strlen(pszName)] == ':')
+			{
+				eGeometry = asGeometryLayers[i].eLayer;
+				pszGeometryName = pszName;
+				break;
+			}
+		}
+
+		if (eGeometry == GeomNone)
+		{
+			const char msgError[] = "ERROR: Unsupported RCM geometry layer in %s.\n";
+			write_to_file_error(msgError, poOpenInfo->pszFilename);
+			CPLError(CE_Failure, CPLE_OpenFailed, msgError, poOpenInfo->pszFilename);
+			return NULL;
+		}
+
+		/* advance the pointer to the actual filename */
+		pszFilename += strlen(pszGeometryName) + 1;
+
+		//need to redo the directory check:
+		//the GDALOpenInfo check would have failed because of the layer name on the filename
+		VSIStatBufL  sStat;
+		if (VSIStatL(pszFilename, &sStat) == 0)
+			poOpenInfo->bIsDirectory = VSI_ISDIR(sStat.st_mode);
+	}
+
+	ePolarimetricProduct ePolarimetry = PolNone;
+	int iPolarimetry = -1;
+
+	CPLString polarimetryFormat(FormatPolarimetry(NULL, NULL));
+
+	if (STARTS_WITH_CI(pszFilename, polarimetryFormat)) {
+		// The product name and filename begins after the hard coded layer name
+		pszFilename += strlen(szLayerPolarimetry) + 1;
+
+		for (size_t i = 0; i < CPL_ARRAYSIZE(asPolarimetricProducts); i++)
+		{
+			const char *pszName = asPolarimetricProducts[i].pszName;
+			if (STARTS_WITH_CI(pszFilename, pszName) && pszFilename[strlen(pszName)] == ':')
+			{
+				ePolarimetry = asPolarimetricProducts[i].eProduct;
+				iPolarimetry = static_cast<int>(i);
+				break;
+			}
+		}
+
+		if (ePolarimetry == PolNone)
+		{
+			const char msgError[] = "ERROR: Unsupported RCM polarimetric product in %s.\n";
+			write_to_file_error(msgError, poOpenInfo->pszFilename);
+			CPLError(CE_Failure, CPLE_OpenFailed, msgError, poOpenInfo->pszFilename);
+			return NULL;
+		}
+
+		/* advance the pointer to the actual filename */
+		pszFilename += strlen(asPolarimetricProducts[iPolarimetry].pszName) + 1;
+
+		/* The channels are calibrated to Sigma Nought, which also enables MULTILOOK */
+		eCalib = Sigma0;
+
+		//need to redo the directory check:
+		//the GDALOpenInfo check would have failed because of the product name on the filename
+		VSIStatBufL  sStat;
+		if (VSIStatL(pszFilename, &sStat) == 0)
+			poOpenInfo->bIsDirectory = VSI_ISDIR(sStat.st_mode);
+	}
+
 	CPLString osMDFilename;
 	if (poOpenInfo->bIsDirectory)
 	{
@@ -1393,9 +2784,11 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 	/* -------------------------------------------------------------------- */
 	/*      Ingest the Product.xml file.                                    */
 	/* -------------------------------------------------------------------- */
+	const GIntBig nParseStart = RCMPerfNow();
 	CPLXMLNode *psProduct = CPLParseXMLFile(osMDFilename);
 	if (psProduct == NULL)
 		return NULL;
+	const GIntBig nProductParseNanoseconds = RCMPerfNow() - nParseStart;
 
 	/* -------------------------------------------------------------------- */
 	/*      Confirm the requested access is supported.                      */
@@ -1472,6 +2865,8 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 	RCMDataset *poDS = new RCMDataset();
 
 	poDS->psProduct = psProduct;
+	poDS->nXMLParseNanoseconds = nProductParseNanoseconds;
+	poDS->ePolarimetry = ePolarimetry;
 
 	/* -------------------------------------------------------------------- */
 	/*      Get overall image information.                                  */
@@ -1495,6 +2890,149 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		return NULL;
 	}
 
+	/* -------------------------------------------------------------------- */
+	/*      MULTILOOK=az,rg averages calibrated power over az lines by      */
+	/*      rg pixels. The reduced raster drops any partial look cell.      */
+	/* -------------------------------------------------------------------- */
+	poDS->nFullRasterXSize = poDS->nRasterXSize;
+	poDS->nFullRasterYSize = poDS->nRasterYSize;
+	const int nFullRasterXSize = poDS->nFullRasterXSize;
+	const int nFullRasterYSize = poDS->nFullRasterYSize;
+
+	const char *pszMultilook = CSLFetchNameValue(poOpenInfo->papszOpenOptions, "MULTILOOK");
+	if (pszMultilook != NULL) {
+		char **papszLooks = CSLTokenizeString2(pszMultilook, ",x", 0);
+		const int nLooksCount = CSLCount(papszLooks);
+		const int nAzimuthLooks = nLooksCount >= 1 ? atoi(papszLooks[0]) : 0;
+		const int nRangeLooks = nLooksCount == 2 ? atoi(papszLooks[1]) : nAzimuthLooks;
+		CSLDestroy(papszLooks);
+
+		if (nLooksCount < 1 || nLooksCount > 2 || nAzimuthLooks < 1 || nRangeLooks < 1 ||
+			nAzimuthLooks > nFullRasterYSize || nRangeLooks > nFullRasterXSize) {
+			char msgError[256] = "";
+			snprintf(msgError, sizeof(msgError), "ERROR: Invalid MULTILOOK=%s, expected azimuth,range looks such as 2,2.", pszMultilook);
+			write_to_file_error(msgError, "");
+
+			delete poDS;
+			CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+			return NULL;
+		}
+
+		if (eCalib == None || eCalib == Uncalib) {
+			if (nAzimuthLooks > 1 || nRangeLooks > 1) {
+				const char msgError[] = "WARNING: MULTILOOK is only supported on calibrated subdatasets and is ignored.";
+				write_to_file_error(msgError, "");
+
+				CPLError(CE_Warning, CPLE_NotSupported, "%s", msgError);
+			}
+		}
+		else {
+			poDS->nAzimuthLooks = nAzimuthLooks;
+			poDS->nRangeLooks = nRangeLooks;
+			poDS->nRasterXSize = nFullRasterXSize / nRangeLooks;
+			poDS->nRasterYSize = nFullRasterYSize / nAzimuthLooks;
+		}
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      NUM_THREADS shares the polarimetric decompositions and speckle  */
+	/*      filters of a block between threads, GDAL_NUM_THREADS default.   */
+	/* -------------------------------------------------------------------- */
+	poDS->nWorkerThreads = RCMGetThreadCount(poOpenInfo->papszOpenOptions);
+
+	/* -------------------------------------------------------------------- */
+	/*      READAHEAD prefetches the next block rows of the calibrated      */
+	/*      bands while the current one is calibrated: YES for about        */
+	/*      RCM_READAHEAD_BYTES of source, or a number of block rows.       */
+	/* -------------------------------------------------------------------- */
+	const char *pszReadahead = CSLFetchNameValueDef(poOpenInfo->papszOpenOptions, "READAHEAD", "NO");
+	if (CPLGetValueType(pszReadahead) == CPL_VALUE_INTEGER)
+		poDS->nReadaheadRows = std::max(0, atoi(pszReadahead));
+	else
+		poDS->nReadaheadRows = CPLTestBool(pszReadahead) ? -1 : 0;
+
+	/* -------------------------------------------------------------------- */
+	/*      NOISE_SUBTRACTION=YES removes the noise equivalent level from   */
+	/*      the calibrated values, in linear power.                         */
+	/* -------------------------------------------------------------------- */
+	if (CPLFetchBool(poOpenInfo->papszOpenOptions, "NOISE_SUBTRACTION", false)) {
+		if (eCalib == None || eCalib == Uncalib || ePolarimetry != PolNone) {
+			const char msgError[] = "WARNING: NOISE_SUBTRACTION is only supported on calibrated power subdatasets and is ignored.";
+			write_to_file_error(msgError, "");
+
+			CPLError(CE_Warning, CPLE_NotSupported, "%s", msgError);
+		}
+		else {
+			poDS->bNoiseSubtraction = true;
+		}
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      SPECKLE_FILTER=BOXCAR|LEE|REFINED_LEE filters the calibrated    */
+	/*      power over a SPECKLE_WINDOW square. SPECKLE_ENL defaults to     */
+	/*      the processing looks times the MULTILOOK looks.                 */
+	/* -------------------------------------------------------------------- */
+	const char *pszSpeckle = CSLFetchNameValueDef(poOpenInfo->papszOpenOptions, "SPECKLE_FILTER", "NONE");
+	eSpeckleFilter eSpeckle = SpeckleNone;
+	if (EQUAL(pszSpeckle, "BOXCAR"))
+		eSpeckle = SpeckleBoxcar;
+	else if (EQUAL(pszSpeckle, "LEE"))
+		eSpeckle = SpeckleLee;
+	else if (EQUAL(pszSpeckle, "REFINED_LEE"))
+		eSpeckle = SpeckleRefinedLee;
+	else if (!EQUAL(pszSpeckle, "NONE")) {
+		char msgError[256] = "";
+		snprintf(msgError, sizeof(msgError), "ERROR: Invalid SPECKLE_FILTER=%s, expected NONE, BOXCAR, LEE or REFINED_LEE.", pszSpeckle);
+		write_to_file_error(msgError, "");
+
+		delete poDS;
+		CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+		return NULL;
+	}
+
+	if (eSpeckle != SpeckleNone) {
+		const char *pszWindow = CSLFetchNameValueDef(poOpenInfo->papszOpenOptions, "SPECKLE_WINDOW", "7");
+		const int nWindow = atoi(pszWindow);
+		if (nWindow < 3 || nWindow % 2 == 0 || nWindow > 101) {
+			char msgError[256] = "";
+			snprintf(msgError, sizeof(msgError), "ERROR: Invalid SPECKLE_WINDOW=%s, expected an odd size from 3 to 101.", pszWindow);
+			write_to_file_error(msgError, "");
+
+			delete poDS;
+			CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+			return NULL;
+		}
+
+		if (eCalib == None || eCalib == Uncalib || ePolarimetry != PolNone) {
+			const char msgError[] = "WARNING: SPECKLE_FILTER is only supported on calibrated power subdatasets and is ignored.";
+			write_to_file_error(msgError, "");
+
+			CPLError(CE_Warning, CPLE_NotSupported, "%s", msgError);
+		}
+		else {
+			const double dfProductLooks =
+				std::max(1.0, CPLAtof(CPLGetXMLValue(psImageGenerationParameters,
+					"sarProcessingInformation.numberOfAzimuthLooks", "1"))) *
+				std::max(1.0, CPLAtof(CPLGetXMLValue(psImageGenerationParameters,
+					"sarProcessingInformation.numberOfRangeLooks", "1")));
+			const char *pszENL = CSLFetchNameValue(poOpenInfo->papszOpenOptions, "SPECKLE_ENL");
+
+			poDS->eSpeckle = eSpeckle;
+			poDS->nSpeckleWindow = nWindow;
+			poDS->dfSpeckleENL = pszENL != NULL ? CPLAtof(pszENL) :
+				dfProductLooks * poDS->nAzimuthLooks * poDS->nRangeLooks;
+			if (poDS->dfSpeckleENL <= 0.0) {
+				char msgError[256] = "";
+				snprintf(msgError, sizeof(msgError), "ERROR: Invalid SPECKLE_ENL=%s, expected a positive number of looks.", pszENL != NULL ? pszENL : "");
+				write_to_file_error(msgError, "");
+
+				delete poDS;
+				CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+				return NULL;
+			}
+		}
+	}
+
 	/* -------------------------------------------------------------------- */
 	/*      Check product type, as to determine if there are LUTs for       */
 	/*      calibration purposes.                                           */
@@ -1534,6 +3072,17 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		"sarProcessingInformation.zeroDopplerTimeLastLine", "UNK");
 	poDS->SetMetadataItem("LAST_LINE_TIME", pszItem);
 
+	/* Zero Doppler azimuth times of the first and last lines, for the geometry services. */
+	/* Geocoded products are not in zero Doppler geometry, their lines have no such time. */
+	poDS->bHaveLineTimes =
+		!STARTS_WITH_CI(pszProductType, "GCD") && !STARTS_WITH_CI(pszProductType, "GCC") &&
+		RCMParseUTCTime(poDS->GetMetadataItem("FIRST_LINE_TIME"), &poDS->dfFirstLineTime) &&
+		RCMParseUTCTime(pszItem, &poDS->dfLastLineTime);
+
+	/* SLC and MLC products are in slant range, the others in ground range */
+	poDS->bSlantRangeGeometry = STARTS_WITH_CI(pszProductType, "SLC") ||
+		STARTS_WITH_CI(pszProductType, "MLC");
+
 	pszItem = CPLGetXMLValue(psImageGenerationParameters,
 		"sarProcessingInformation.lutApplied", "");
 	poDS->SetMetadataItem("LUT_APPLIED", pszItem);
@@ -1657,11 +3206,22 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		return NULL;
 	}
 
+	/* The polarimetric products combine the phases of complex channels */
+	if (ePolarimetry != PolNone && !poDS->isComplexData) {
+		const char msgError[] = "ERROR: RCM polarimetric products need a complex (SLC) product.";
+		write_to_file_error(msgError, "");
+
+		delete poDS;
+		CPLError(CE_Failure, CPLE_OpenFailed, "%s", msgError);
+		return NULL;
+	}
+
 	/* Indicates whether pixel number (i.e., range) increases or decreases with range time.  
 	For GCD and GCC products, this applies to intermediate ground range image data prior to geocoding. */
     const char *pszPixelTimeOrdering = CPLGetXMLValue(psImageReferenceAttributes,
 			"rasterAttributes.pixelTimeOrdering", "UNK");
 	poDS->SetMetadataItem("PIXEL_TIME_ORDERING", pszPixelTimeOrdering);
+	poDS->bPixelTimeIncreasing = !EQUAL(pszPixelTimeOrdering, "Decreasing");
 
 	/* Indicates whether line numbers (i.e., azimuth) increase or decrease with azimuth time.  
 	For GCD and GCC products, this applies to intermediate ground range image data prior to geocoding. */
@@ -1669,10 +3229,24 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		"rasterAttributes.lineTimeOrdering", "UNK");
 	poDS->SetMetadataItem("LINE_TIME_ORDERING", pszLineTimeOrdering);
 
+	/* Time from one line to the next. The sampled line spacing time is exact, */
+	/* the first and last line times only give its sign, or stand in for it.   */
+	if (poDS->bHaveLineTimes) {
+		double dfInterval = CPLAtof(pszSampledLineSpacingTime);
+		if (dfInterval <= 0.0 && nFullRasterYSize > 1)
+			dfInterval = fabs(poDS->dfLastLineTime - poDS->dfFirstLineTime) / (nFullRasterYSize - 1);
+
+		const bool bDecreasing = poDS->dfLastLineTime != poDS->dfFirstLineTime ?
+			poDS->dfLastLineTime < poDS->dfFirstLineTime :
+			EQUAL(pszLineTimeOrdering, "Decreasing");
+		poDS->dfLineTimeInterval = bDecreasing ? -dfInterval : dfInterval;
+	}
+
 	/* while we're at it, extract the pixel spacing information */
 	const char *pszPixelSpacing = CPLGetXMLValue(psImageReferenceAttributes,
 		"rasterAttributes.sampledPixelSpacing", "UNK");
 	poDS->SetMetadataItem("PIXEL_SPACING", pszPixelSpacing);
+	poDS->dfPixelSpacing = CPLAtof(pszPixelSpacing);
 
 	const char *pszLineSpacing = CPLGetXMLValue(psImageReferenceAttributes,
 		"rasterAttributes.sampledLineSpacing", "UNK");
@@ -1745,6 +3319,7 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 	For NITF 2.1 format, only one entry. */
 	bool bIsNITF = false;
 	const char *pszNITF_Filename;
+	CPLString osCrossCorrelationFilename;   /* RCM MLC XC image, not a polarization */
 	int imageBandFileCount = 0;
 	int imageBandCount = 0;
 
@@ -1799,7 +3374,8 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			}
 
 			if (EQUAL(pszPole, "XC")) {
-				/* Skip RCM MLC's 3rd band file ##XC.tif */
+				/* RCM MLC's 3rd band file ##XC.tif is added after the polarizations */
+				osCrossCorrelationFilename = pszBasedFilename;
 				imageBandFileCount--;
 				continue;
 			}
@@ -1828,7 +3404,9 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			CPLString osIncidenceAngleFilePath = CPLFormFilename(pszPath, osIncidenceAnglePath,
 				NULL);
 
+			const GIntBig nIncidenceParseStart = RCMPerfNow();
 			CPLXMLNode *psIncidenceAngle = CPLParseXMLFile(osIncidenceAngleFilePath);
+			poDS->nXMLParseNanoseconds += RCMPerfNow() - nIncidenceParseStart;
 
 			int pixelFirstLutValue = atoi(CPLGetXMLValue(psIncidenceAngle, "=incidenceAngles.pixelFirstAnglesValue", "0"));
 
@@ -1869,11 +3447,20 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 	}
 
 
+	/* Input channels of a polarimetric product, filled in the band loop */
+	if (ePolarimetry != PolNone)
+		poDS->apoPolChannels.assign(CountPolarimetricNames(asPolarimetricProducts[iPolarimetry].apszPoles),
+			static_cast<RCMCalibRasterBand *>(NULL));
+
 	for (int iPoleInx=0; iPoleInx<nPolarizationsGridCount; iPoleInx++)
 	{
 		// Search for a specific band name
 		const CPLString pszPole = CPLString(papszPolarizationsGrids[iPoleInx]).toupper();
 
+		/* A polarimetric product only reads its input channels */
+		if (ePolarimetry != PolNone && GetPolarimetricChannel(iPolarimetry, pszPole) < 0)
+			continue;
+
 		double *tableNoiseLevelsBetaNought = NULL;
 		double *tableNoiseLevelsSigmaNought = NULL;
 		double *tableNoiseLevelsGamma = NULL;
@@ -2116,6 +3703,9 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			}
 		}
 
+		/* A geometry layer is computed from product.xml, no image is read */
+		if (eGeometry != GeomNone)
+			continue;
 
 		/* -------------------------------------------------------------------- */
 		/*      Fetch ipdf image. Could be either tif or ntf.                   */
@@ -2209,6 +3799,11 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		/*      Create the band.                                                */
 		/* -------------------------------------------------------------------- */     		
 		int bandNum = poDS->GetRasterCount()+1;
+
+		/* A file holding every polarization has them in the product order */
+		const int nSrcBand = isOneFilePerPol || twoBandComplex ? 1 :
+			std::min(iPoleInx + 1, poBandFile->GetRasterCount());
+
 		if (eCalib == None || eCalib == Uncalib) {
 			RCMRasterBand *poBand
 				= new RCMRasterBand(poDS, bandNum, eDataType, pszPole, 
@@ -2218,6 +3813,23 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 
 		}
 		else {
+			if (eCalib == Gamma0Ellipsoid &&
+				(pszSigma0LUT == NULL || poDS->m_nfIncidenceAngleTable == NULL)) {
+				const char msgError[] = "ERROR: GAMMA0_ELLIPSOID needs the Sigma Nought LUT and the incidence angle table of the product.";
+				write_to_file_error(msgError, "");
+
+				GDALClose(reinterpret_cast<GDALDatasetH>(poBandFile));
+				CPLFree(pszFullname);
+				CPLFree(imageBandList);
+				CSLDestroy(papszPolarizationsGrids);
+				CPLFree(imageBandFileList);
+				CPLFree(pszPath);
+				delete poDS;
+
+				CPLError(CE_Failure, CPLE_OpenFailed, "%s", msgError);
+				return NULL;
+			}
+
 			const char *pszLUT = NULL;
 			switch (eCalib) {
 			case Sigma0:
@@ -2229,6 +3841,9 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			case Gamma:
 				pszLUT = pszGammaLUT;
 				break;
+			case Gamma0Ellipsoid:
+				pszLUT = pszSigma0LUT;
+				break;
 			default:
 				/* we should bomb gracefully... */
 				pszLUT = pszSigma0LUT;
@@ -2240,15 +3855,20 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 				RCMCalibRasterBand *poBand
 					= new RCMCalibRasterBand(poDS, pszPole, GDT_Float32, poBandFile, eCalib,
 						CPLFormFilename(pszPath, pszLUT, NULL),
-						CPLFormFilename(pszPath, pszNoiseLevelsValues, NULL), eDataType);
-				poDS->SetBand(poDS->GetRasterCount() + 1, poBand);
+						CPLFormFilename(pszPath, pszNoiseLevelsValues, NULL), eDataType, nSrcBand);
+
+				/* The channels of a polarimetric product feed its bands */
+				if (ePolarimetry != PolNone)
+					poDS->apoPolChannels[GetPolarimetricChannel(iPolarimetry, pszPole)] = poBand;
+				else
+					poDS->SetBand(poDS->GetRasterCount() + 1, poBand);
 			}
 			else {
 				// Whatever the datatype was previoulsy set
 				RCMCalibRasterBand *poBand
 					= new RCMCalibRasterBand(poDS, pszPole, eDataType, poBandFile, eCalib,
 						CPLFormFilename(pszPath, pszLUT, NULL),
-						CPLFormFilename(pszPath, pszNoiseLevelsValues, NULL), eDataType);
+						CPLFormFilename(pszPath, pszNoiseLevelsValues, NULL), eDataType, nSrcBand);
 				poDS->SetBand(poDS->GetRasterCount() + 1, poBand);
 			}
 
@@ -2257,7 +3877,105 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		CPLFree(pszFullname);
 	}
 
-	if (poDS->papszSubDatasets != NULL && eCalib == None) {
+	/* -------------------------------------------------------------------- */
+	/*      Surface the MLC cross-correlation (XC) elements as digital      */
+	/*      numbers after the polarization bands. There is no LUT for      */
+	/*      them, so they are not part of the calibrated subdatasets.       */
+	/* -------------------------------------------------------------------- */
+	if (!osCrossCorrelationFilename.empty() && (eCalib == None || eCalib == Uncalib) &&
+		eGeometry == GeomNone) {
+		CPLString osBasename(osCrossCorrelationFilename);
+		for (size_t i = 0; i < osBasename.size(); i++) {
+			if (osBasename[i] == cOppositePathSeparator)
+				osBasename[i] = cPathSeparator;
+		}
+
+		const CPLString osFullname(CPLFormFilename(pszPath, osBasename, NULL));
+		GDALDataset *poBandFile = reinterpret_cast<GDALDataset *>(
+			GDALOpen(osFullname, GA_ReadOnly));
+
+		if (poBandFile != NULL && poBandFile->GetRasterCount() > 0 &&
+			poBandFile->GetRasterXSize() == poDS->nRasterXSize &&
+			poBandFile->GetRasterYSize() == poDS->nRasterYSize) {
+			poDS->poCrossCorrelationFile = poBandFile;
+			poDS->papszExtraFiles = CSLAddString(poDS->papszExtraFiles, osFullname);
+
+			/* Real bands hold I and Q in pairs */
+			const int nSrcBands = poBandFile->GetRasterCount();
+			const bool bTwoBandComplex = nSrcBands % 2 == 0 &&
+				!GDALDataTypeIsComplex(poBandFile->GetRasterBand(1)->GetRasterDataType());
+			const int nStep = bTwoBandComplex ? 2 : 1;
+
+			for (int iSrc = 1; iSrc <= nSrcBands; iSrc += nStep) {
+				const int nBandNum = poDS->GetRasterCount() + 1;
+				RCMCrossCorrelationRasterBand *poBand = new RCMCrossCorrelationRasterBand(poDS,
+					nBandNum, poBandFile, iSrc, bTwoBandComplex);
+				poBand->SetMetadataItem("XC_ELEMENT", CPLSPrintf("%d", (iSrc - 1) / nStep + 1));
+				poDS->SetBand(nBandNum, poBand);
+			}
+		}
+		else {
+			const char msgError[] = "WARNING: The RCM MLC cross-correlation image %s cannot be read and is skipped.";
+			write_to_file_error(msgError, osFullname);
+
+			CPLError(CE_Warning, CPLE_OpenFailed, msgError, osFullname.c_str());
+			if (poBandFile != NULL)
+				GDALClose(reinterpret_cast<GDALDatasetH>(poBandFile));
+		}
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Create the bands of a polarimetric product once all its         */
+	/*      calibrated input channels are found.                            */
+	/* -------------------------------------------------------------------- */
+	if (ePolarimetry != PolNone) {
+		bool bHaveChannels = true;
+		for (size_t i = 0; i < poDS->apoPolChannels.size(); i++) {
+			if (poDS->apoPolChannels[i] == NULL || !poDS->apoPolChannels[i]->IsExistLUT())
+				bHaveChannels = false;
+		}
+
+		if (!bHaveChannels) {
+			CPLString osPoles;
+			for (const char * const *papszPole = asPolarimetricProducts[iPolarimetry].apszPoles; *papszPole != NULL; papszPole++) {
+				if (!osPoles.empty())
+					osPoles += " ";
+				osPoles += *papszPole;
+			}
+
+			char msgError[256] = "";
+			snprintf(msgError, sizeof(msgError), "ERROR: RCM_POL:%s needs the Sigma Nought LUT and the %s channels of an SLC product.",
+				asPolarimetricProducts[iPolarimetry].pszName, osPoles.c_str());
+			write_to_file_error(msgError, "");
+
+			CPLFree(pszPath);
+			CPLFree(pszBeta0LUT);
+			CPLFree(pszSigma0LUT);
+			CPLFree(pszGammaLUT);
+			CSLDestroy(papszPolarizationsGrids);
+			delete poDS;
+
+			CPLError(CE_Failure, CPLE_OpenFailed, "%s", msgError);
+			return NULL;
+		}
+
+		int nBlockXSize = 0;
+		int nBlockYSize = 0;
+		poDS->apoPolChannels[0]->GetBlockSize(&nBlockXSize, &nBlockYSize);
+		/* Several lines per block for the rows shared by NUM_THREADS */
+		nBlockYSize = RCMGetProcessingBlockYSize(nBlockXSize, nBlockYSize, poDS->nRasterYSize);
+
+		const char * const *papszBands = asPolarimetricProducts[iPolarimetry].apszBands;
+		for (int i = 0; papszBands[i] != NULL; i++) {
+			/* The Pauli bands are an RGB composite */
+			const GDALColorInterp eColorInterp = ePolarimetry == PolPauli ?
+				static_cast<GDALColorInterp>(GCI_RedBand + i) : GCI_Undefined;
+			poDS->SetBand(i + 1, new RCMPolarimetricRasterBand(poDS, i + 1, papszBands[i],
+				nBlockXSize, nBlockYSize, eColorInterp));
+		}
+	}
+
+	if (poDS->papszSubDatasets != NULL && eCalib == None && eGeometry == GeomNone) {
 		// must be removed const size_t nBufLen = nFLen + 28;
 		CPLString pszBuf = FormatCalibration(szUNCALIB, osMDFilename.c_str());
 		poDS->papszSubDatasets = CSLSetNameValue(poDS->papszSubDatasets,
@@ -2265,6 +3983,30 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		poDS->papszSubDatasets = CSLSetNameValue(poDS->papszSubDatasets,
 			"SUBDATASET_1_DESC", "Uncalibrated digital numbers");
 
+		/* Ellipsoid Gamma Nought needs the Sigma Nought LUT and the incidence angles */
+		if (pszSigma0LUT != NULL && poDS->m_nfIncidenceAngleTable != NULL) {
+			CPLString pszGamma0Buf = FormatCalibration(szGAMMA0_ELLIPSOID, osMDFilename.c_str());
+			poDS->papszSubDatasets = AddSubDataset(poDS->papszSubDatasets, pszGamma0Buf,
+				"Ellipsoid Gamma Nought from Sigma Nought and incidence angle");
+		}
+
+		/* Polarimetric products need calibrated complex samples of all their channels */
+		if (pszSigma0LUT != NULL && poDS->isComplexData) {
+			for (int i = 0; i < static_cast<int>(CPL_ARRAYSIZE(asPolarimetricProducts)); i++) {
+				bool bHaveChannels = true;
+				for (const char * const *papszPole = asPolarimetricProducts[i].apszPoles; *papszPole != NULL; papszPole++) {
+					if (CSLFindString(papszPolarizationsGrids, *papszPole) < 0)
+						bHaveChannels = false;
+				}
+
+				if (bHaveChannels) {
+					CPLString pszPolBuf = FormatPolarimetry(asPolarimetricProducts[i].pszName, osMDFilename.c_str());
+					poDS->papszSubDatasets = AddSubDataset(poDS->papszSubDatasets, pszPolBuf,
+						asPolarimetricProducts[i].pszDescription);
+				}
+			}
+		}
+
 	}
 	else if (poDS->papszSubDatasets != NULL) {
 		CSLDestroy(poDS->papszSubDatasets);
@@ -2276,12 +4018,20 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 	/*      Set the appropriate MATRIX_REPRESENTATION.                      */
 	/* -------------------------------------------------------------------- */
 
-	if (poDS->GetRasterCount() == 4 && (eDataType == GDT_CInt16 ||
+	if (poDS->GetRasterCount() == 4 && ePolarimetry == PolNone && (eDataType == GDT_CInt16 ||
 		eDataType == GDT_CFloat32))
 	{
 		poDS->SetMetadataItem("MATRIX_REPRESENTATION", "SCATTERING");
 
 	}
+	else if (ePolarimetry == PolC3)
+	{
+		poDS->SetMetadataItem("MATRIX_REPRESENTATION", "COVARIANCE");
+	}
+	else if (ePolarimetry == PolT3)
+	{
+		poDS->SetMetadataItem("MATRIX_REPRESENTATION", "COHERENCY");
+	}
 
 	/* -------------------------------------------------------------------- */
 	/*      Collect a few useful metadata items.                            */
@@ -2322,9 +4072,39 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		"orbitAndAttitude.orbitInformation.orbitDataFileName", "UNK");
 	poDS->SetMetadataItem("ORBIT_DATA_FILE", pszItem);
 
+	/* Parse the orbit state vectors once for the geometry services */
+	if (!poDS->oOrbit.Initialize(psProduct)) {
+		const char msgError[] = "WARNING: No valid orbit state vectors found in product.xml.";
+		write_to_file_error(msgError, "");
 
-	/* Get incidence angle information. DONE */
-	pszItem = CPLGetXMLValue(psSceneAttributes,
+		CPLDebug("RCM", "%s", msgError);
+	}
+
+	/* Parse the ground to slant range polynomials once for the geometry services */
+	if (!poDS->oSlantRange.Initialize(psProduct)) {
+		const char msgError[] = "WARNING: No valid slant range to ground range entries found in product.xml.";
+		write_to_file_error(msgError, "");
+
+		CPLDebug("RCM", "%s", msgError);
+	}
+
+	/* Parse the Doppler centroid estimates once for the geometry services */
+	if (!poDS->oDopplerCentroid.Initialize(psProduct)) {
+		const char msgError[] = "WARNING: No valid Doppler centroid estimates found in product.xml.";
+		write_to_file_error(msgError, "");
+
+		CPLDebug("RCM", "%s", msgError);
+	}
+
+	/* Parse the ScanSAR burst map once, stripmap products have none */
+	if (poDS->oBurstMap.Initialize(psProduct)) {
+		CPLDebug("RCM", "%d bursts over %d beams in the burst map.",
+			poDS->oBurstMap.GetBurstCount(), poDS->oBurstMap.GetBeamCount());
+	}
+
+
+	/* Get incidence angle information. DONE */
+	pszItem = CPLGetXMLValue(psSceneAttributes,
 		"imageAttributes.incAngNearRng", "UNK");
 	poDS->SetMetadataItem("NEAR_RANGE_INCIDENCE_ANGLE", pszItem);
 
@@ -2335,6 +4115,7 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 	pszItem = CPLGetXMLValue(psSceneAttributes,
 		"imageAttributes.slantRangeNearEdge", "UNK");
 	poDS->SetMetadataItem("SLANT_RANGE_NEAR_EDGE", pszItem);
+	poDS->dfSlantRangeNearEdge = CPLAtof(pszItem);
 
 	pszItem = CPLGetXMLValue(psSceneAttributes,
 		"imageAttributes.slantRangeFarEdge", "UNK");
@@ -2381,10 +4162,10 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 				psPos, "upperRightCorner.mapCoordinate.easting", "0.0"), NULL);
 			const double tr_y = CPLStrtod(CPLGetXMLValue(
 				psPos, "upperRightCorner.mapCoordinate.northing", "0.0"), NULL);
-			poDS->adfGeoTransform[1] = (tr_x - tl_x) / (poDS->nRasterXSize - 1);
-			poDS->adfGeoTransform[4] = (tr_y - tl_y) / (poDS->nRasterXSize - 1);
-			poDS->adfGeoTransform[2] = (bl_x - tl_x) / (poDS->nRasterYSize - 1);
-			poDS->adfGeoTransform[5] = (bl_y - tl_y) / (poDS->nRasterYSize - 1);
+			poDS->adfGeoTransform[1] = (tr_x - tl_x) / (nFullRasterXSize - 1);
+			poDS->adfGeoTransform[4] = (tr_y - tl_y) / (nFullRasterXSize - 1);
+			poDS->adfGeoTransform[2] = (bl_x - tl_x) / (nFullRasterYSize - 1);
+			poDS->adfGeoTransform[5] = (bl_y - tl_y) / (nFullRasterYSize - 1);
 			poDS->adfGeoTransform[0] = (tl_x - 0.5*poDS->adfGeoTransform[1]
 				- 0.5*poDS->adfGeoTransform[2]);
 			poDS->adfGeoTransform[3] = (tl_y - 0.5*poDS->adfGeoTransform[4]
@@ -2396,11 +4177,11 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			const double br_y = CPLStrtod(CPLGetXMLValue(
 				psPos, "lowerRightCorner.mapCoordinate.northing", "0.0"), NULL);
 			const double testx = poDS->adfGeoTransform[0] + poDS->adfGeoTransform[1] *
-				(poDS->nRasterXSize - 0.5) + poDS->adfGeoTransform[2] *
-				(poDS->nRasterYSize - 0.5);
+				(nFullRasterXSize - 0.5) + poDS->adfGeoTransform[2] *
+				(nFullRasterYSize - 0.5);
 			const double testy = poDS->adfGeoTransform[3] + poDS->adfGeoTransform[4] *
-				(poDS->nRasterXSize - 0.5) + poDS->adfGeoTransform[5] *
-				(poDS->nRasterYSize - 0.5);
+				(nFullRasterXSize - 0.5) + poDS->adfGeoTransform[5] *
+				(nFullRasterYSize - 0.5);
 
 			/* Give 1/4 pixel numerical error leeway in calculating location
 			based on affine transform */
@@ -2457,6 +4238,9 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 			oPrj.SetWellKnownGeogCS("WGS84");
 		}
 		else {
+			poDS->dfSemiMajorAxis = major_axis;
+			poDS->dfSemiMinorAxis = minor_axis;
+
 			const double inv_flattening = major_axis / (major_axis - minor_axis);
 			oLL.SetGeogCS("", "", pszEllipsoidName, major_axis,
 				inv_flattening);
@@ -2652,6 +4436,123 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		CSLDestroy(papszRPC);
 	}
 
+	/* -------------------------------------------------------------------- */
+	/*      Bring the georeferencing to the multilooked grid. Pixel (i,j)   */
+	/*      covers full resolution pixels [i*az,(i+1)*az) x [j*rg,(j+1)*rg) */
+	/* -------------------------------------------------------------------- */
+	if (poDS->IsMultilooked()) {
+		const double dfAzimuthLooks = poDS->nAzimuthLooks;
+		const double dfRangeLooks = poDS->nRangeLooks;
+
+		poDS->adfGeoTransform[1] *= dfRangeLooks;
+		poDS->adfGeoTransform[4] *= dfRangeLooks;
+		poDS->adfGeoTransform[2] *= dfAzimuthLooks;
+		poDS->adfGeoTransform[5] *= dfAzimuthLooks;
+
+		for (int iGCP = 0; iGCP < poDS->nGCPCount; iGCP++) {
+			poDS->pasGCPList[iGCP].dfGCPPixel /= dfRangeLooks;
+			poDS->pasGCPList[iGCP].dfGCPLine /= dfAzimuthLooks;
+		}
+
+		/* RPC line/sample refer to pixel centres */
+		const char *pszLineOff = poDS->GetMetadataItem("LINE_OFF", "RPC");
+		if (pszLineOff != NULL) {
+			char **papszRPC = CSLDuplicate(poDS->GetMetadata("RPC"));
+			const double dfLineOff = (CPLAtof(pszLineOff) + 0.5) / dfAzimuthLooks - 0.5;
+			const double dfSampOff = (CPLAtof(CSLFetchNameValueDef(papszRPC, "SAMP_OFF", "0")) + 0.5) / dfRangeLooks - 0.5;
+			const double dfLineScale = CPLAtof(CSLFetchNameValueDef(papszRPC, "LINE_SCALE", "1")) / dfAzimuthLooks;
+			const double dfSampScale = CPLAtof(CSLFetchNameValueDef(papszRPC, "SAMP_SCALE", "1")) / dfRangeLooks;
+			papszRPC = CSLSetNameValue(papszRPC, "LINE_OFF", CPLSPrintf("%.15g", dfLineOff));
+			papszRPC = CSLSetNameValue(papszRPC, "SAMP_OFF", CPLSPrintf("%.15g", dfSampOff));
+			papszRPC = CSLSetNameValue(papszRPC, "LINE_SCALE", CPLSPrintf("%.15g", dfLineScale));
+			papszRPC = CSLSetNameValue(papszRPC, "SAMP_SCALE", CPLSPrintf("%.15g", dfSampScale));
+			poDS->GDALDataset::SetMetadata(papszRPC, "RPC");
+			CSLDestroy(papszRPC);
+		}
+
+		poDS->SetMetadataItem("MULTILOOK_AZIMUTH_LOOKS", CPLSPrintf("%d", poDS->nAzimuthLooks));
+		poDS->SetMetadataItem("MULTILOOK_RANGE_LOOKS", CPLSPrintf("%d", poDS->nRangeLooks));
+	}
+
+	if (poDS->eSpeckle != SpeckleNone) {
+		const char *const apszSpeckleNames[] = { "NONE", "BOXCAR", "LEE", "REFINED_LEE" };
+		poDS->SetMetadataItem("SPECKLE_FILTER", apszSpeckleNames[poDS->eSpeckle]);
+		poDS->SetMetadataItem("SPECKLE_WINDOW", CPLSPrintf("%d", poDS->nSpeckleWindow));
+		poDS->SetMetadataItem("SPECKLE_ENL", CPLSPrintf("%.15g", poDS->dfSpeckleENL));
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Parse the rational functions once, in the final pixel/line      */
+	/*      coordinates. The lat/lon layers use the scene terrain height.   */
+	/* -------------------------------------------------------------------- */
+	if (poDS->oRPC.Initialize(poDS->GetMetadata("RPC"))) {
+		const char *pszTerrainHeight = poDS->GetMetadataItem("GEODETIC_TERRAIN_HEIGHT");
+		if (pszTerrainHeight != NULL && !EQUAL(pszTerrainHeight, "UNK"))
+			poDS->dfTerrainHeight = CPLAtof(pszTerrainHeight);
+		else
+			poDS->dfTerrainHeight = poDS->oRPC.GetHeightOffset();
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Index the tie points as a lattice for fast geolocation, once    */
+	/*      the GCPs are in the final pixel/line coordinates.               */
+	/* -------------------------------------------------------------------- */
+	if (poDS->nGCPCount > 0 && !poDS->oTiePointGrid.Build(poDS->nGCPCount, poDS->pasGCPList)) {
+		const char msgError[] = "WARNING: The geolocation grid tie points do not form a regular lattice.";
+		write_to_file_error(msgError, "");
+
+		CPLDebug("RCM", "%s", msgError);
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Create the virtual geometry band, or list the geometry layers.  */
+	/* -------------------------------------------------------------------- */
+	if (eGeometry != GeomNone)
+	{
+		if (!IsGeometryLayerAvailable(poDS, eGeometry))
+		{
+			const char msgError[] = "ERROR: The RCM geometry layer %s cannot be computed from this product.";
+			write_to_file_error(msgError, pszGeometryName);
+
+			delete poDS;
+			CPLError(CE_Failure, CPLE_OpenFailed, msgError, pszGeometryName);
+			return NULL;
+		}
+
+		/* Longitude and latitude share the inversion of each line */
+		if (eGeometry == GeomLatLon) {
+			poDS->SetBand(1, new RCMGeometryRasterBand(poDS, eGeometry, 1, szLONGITUDE));
+			poDS->SetBand(2, new RCMGeometryRasterBand(poDS, eGeometry, 2, szLATITUDE));
+		}
+		else
+			poDS->SetBand(1, new RCMGeometryRasterBand(poDS, eGeometry, 1, pszGeometryName));
+
+		/* Beam names of the BEAM_ID values, in order */
+		if (eGeometry == GeomBeamId)
+		{
+			CPLString osBeams;
+			for (int i = 1; i <= poDS->oBurstMap.GetBeamCount(); i++)
+			{
+				if (i > 1)
+					osBeams += " ";
+				osBeams += poDS->oBurstMap.GetBeamName(i);
+			}
+			poDS->GetRasterBand(1)->SetMetadataItem("BEAMS", osBeams);
+		}
+	}
+	else if (eCalib == None)
+	{
+		for (size_t i = 0; i < CPL_ARRAYSIZE(asGeometryLayers); i++)
+		{
+			if (!IsGeometryLayerAvailable(poDS, asGeometryLayers[i].eLayer))
+				continue;
+
+			CPLString pszBuf = FormatGeometry(asGeometryLayers[i].pszName, osMDFilename.c_str());
+			poDS->papszSubDatasets = AddSubDataset(poDS->papszSubDatasets,
+				pszBuf, asGeometryLayers[i].pszDescription);
+		}
+	}
+
 	/* -------------------------------------------------------------------- */
 	/*      Initialize any PAM information.                                 */
 	/* -------------------------------------------------------------------- */
@@ -2681,6 +4582,12 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		osDescription = pszDescriptionGamma;
 	}
 	break;
+	case Gamma0Ellipsoid:
+	{
+		osSubdatasetName = szGAMMA0_ELLIPSOID;
+		osDescription = FormatCalibration(szGAMMA0_ELLIPSOID, osMDFilename.c_str());
+	}
+	break;
 	case Uncalib:
 	{
 		osSubdatasetName = szUNCALIB;
@@ -2694,7 +4601,21 @@ GDALDataset *RCMDataset::Open(GDALOpenInfo * poOpenInfo)
 		useSubdatasets = false;
 	}
 
-	if (eCalib != None)
+	if (eGeometry != GeomNone)
+	{
+		osSubdatasetName = pszGeometryName;
+		osDescription = FormatGeometry(pszGeometryName, osMDFilename.c_str());
+		useSubdatasets = true;
+	}
+
+	if (ePolarimetry != PolNone)
+	{
+		osSubdatasetName = asPolarimetricProducts[iPolarimetry].pszName;
+		osDescription = FormatPolarimetry(osSubdatasetName, osMDFilename.c_str());
+		useSubdatasets = true;
+	}
+
+	if (eCalib != None || eGeometry != GeomNone)
 		poDS->papszExtraFiles =
 		CSLAddString(poDS->papszExtraFiles, osMDFilename);
 
@@ -2776,6 +4697,166 @@ CPLErr RCMDataset::GetGeoTransform(double * padfTransform)
 	return CE_Failure;
 }
 
+/************************************************************************/
+/*                        GetSharedSourceBands()                        */
+/************************************************************************/
+/* True if the requested bands are calibrated bands reading one band    */
+/* each of the same image file, as the polarizations of a single NITF.  */
+/************************************************************************/
+
+bool RCMDataset::GetSharedSourceBands(int nBandCount, int *panBandMap,
+	std::vector<RCMCalibRasterBand *> &apoBands)
+{
+	apoBands.clear();
+	for (int i = 0; i < nBandCount; i++) {
+		RCMCalibRasterBand *poBand = dynamic_cast<RCMCalibRasterBand *>(GetRasterBand(panBandMap[i]));
+		if (poBand == NULL || !poBand->IsExistLUT() ||
+			poBand->GetRasterDataType() != GDT_Float32 || poBand->GetSourceBandCount() != 1)
+			return false;
+
+		if (i > 0 && (!EQUAL(poBand->GetSourceDataset()->GetDescription(),
+				apoBands[0]->GetSourceDataset()->GetDescription()) ||
+			poBand->IsComplexSource() != apoBands[0]->IsComplexSource()))
+			return false;
+
+		apoBands.push_back(poBand);
+	}
+
+	return true;
+}
+
+/************************************************************************/
+/*                             IRasterIO()                              */
+/************************************************************************/
+/* A multi-band read of calibrated bands sharing one image file reads   */
+/* strips of whole source block rows with one source RasterIO for all   */
+/* the bands, then calibrates and multilooks every band straight into   */
+/* the caller's buffer, whatever its interleaving. The source driver    */
+/* decodes each block once when it fills the cache of the other bands   */
+/* with it (NITF IMODE=P/R, pixel interleaved GeoTIFF), so the strips   */
+/* are kept within half the block cache. Anything else goes through    */
+/* the blocks of each band.                                             */
+/************************************************************************/
+
+static const GIntBig RCM_SHARED_READ_BYTES = 64 * 1024 * 1024;
+
+CPLErr RCMDataset::IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int nXSize, int nYSize,
+	void *pData, int nBufXSize, int nBufYSize, GDALDataType eBufType,
+	int nBandCount, int *panBandMap, GSpacing nPixelSpace, GSpacing nLineSpace,
+	GSpacing nBandSpace, GDALRasterIOExtraArg *psExtraArg)
+{
+	std::vector<RCMCalibRasterBand *> apoBands;
+	if (eRWFlag != GF_Read || nBandCount < 2 || nBufXSize != nXSize || nBufYSize != nYSize ||
+		eSpeckle != SpeckleNone || !GetSharedSourceBands(nBandCount, panBandMap, apoBands)) {
+		return GDALPamDataset::IRasterIO(eRWFlag, nXOff, nYOff, nXSize, nYSize,
+			pData, nBufXSize, nBufYSize, eBufType, nBandCount, panBandMap,
+			nPixelSpace, nLineSpace, nBandSpace, psExtraArg);
+	}
+
+	GDALDataset *poSource = apoBands[0]->GetSourceDataset();
+	const bool bComplex = apoBands[0]->IsComplexSource();
+	const int nValues = bComplex ? 2 : 1;   /* floats per source sample */
+	const int nSourceTypeSize = GDALGetDataTypeSizeBytes(
+		poSource->GetRasterBand(apoBands[0]->GetSourceBand())->GetRasterDataType());
+
+	std::vector<int> anSourceBands(nBandCount);
+	for (int i = 0; i < nBandCount; i++)
+		anSourceBands[i] = apoBands[i]->GetSourceBand();
+
+	/* Strips of dataset lines, about RCM_SHARED_READ_BYTES of source samples */
+	/* and at most half the block cache of source blocks                      */
+	const int nSrcXSize = nXSize * nRangeLooks;
+	const GIntBig nLineBytes = static_cast<GIntBig>(nSrcXSize) * nAzimuthLooks *
+		nValues * sizeof(float) * nBandCount;
+	const GIntBig nSrcLineBytes = static_cast<GIntBig>(nSrcXSize) * nAzimuthLooks *
+		nSourceTypeSize * nBandCount;
+	const int nStripLines = static_cast<int>(std::max(static_cast<GIntBig>(1),
+		std::min(std::min(static_cast<GIntBig>(nYSize), RCM_SHARED_READ_BYTES / nLineBytes),
+			GDALGetCacheMax64() / 2 / nSrcLineBytes)));
+	int nSrcBlockXSize, nSrcBlockYSize;
+	poSource->GetRasterBand(anSourceBands[0])->GetBlockSize(&nSrcBlockXSize, &nSrcBlockYSize);
+	const size_t nSrcPlane = static_cast<size_t>(nSrcXSize) * nStripLines * nAzimuthLooks * nValues;
+
+	std::vector<float> afSource(nSrcPlane * nBandCount);
+	std::vector<float> afCalibrated(bComplex ? static_cast<size_t>(nSrcXSize) * nStripLines * nAzimuthLooks : 0);
+	std::vector<float> afMultilooked(IsMultilooked() ? static_cast<size_t>(nXSize) * nStripLines : 0);
+
+	/* The blocks of each band this request stands for, as IReadBlock() counts them */
+	int nBlockXSize, nBlockYSize;
+	apoBands[0]->GetBlockSize(&nBlockXSize, &nBlockYSize);
+	const GIntBig nWindowBlocks =
+		static_cast<GIntBig>((nXOff + nXSize - 1) / nBlockXSize - nXOff / nBlockXSize + 1) *
+		((nYOff + nYSize - 1) / nBlockYSize - nYOff / nBlockYSize + 1);
+	for (int iBand = 0; iBand < nBandCount; iBand++)
+		RCMPerfCounters::Add(apoBands[iBand]->GetPerfCounters()->nBlocksRead, nWindowBlocks);
+
+	int nLines = 0;
+	for (int iLine = 0; iLine < nYSize; iLine += nLines) {
+		nLines = std::min(nStripLines, nYSize - iLine);
+
+		/* End the strip on a source block row boundary when it holds one */
+		const int nSrcEnd = (nYOff + iLine + nLines) * nAzimuthLooks;
+		const int nAlignedLines = (nSrcEnd - nSrcEnd % nSrcBlockYSize) / nAzimuthLooks - (nYOff + iLine);
+		if (iLine + nLines < nYSize && nAlignedLines > 0)
+			nLines = nAlignedLines;
+
+		const int nSrcXOff = nXOff * nRangeLooks;
+		const int nSrcYOff = (nYOff + iLine) * nAzimuthLooks;
+		const int nSrcLines = nLines * nAzimuthLooks;
+
+		/* One read of every polarization, band sequential: the first band */
+		/* loads each source block, the others find it in the block cache  */
+		const GIntBig nIOStart = RCMPerfNow();
+		CPLErr eErr = poSource->RasterIO(GF_Read, nSrcXOff, nSrcYOff, nSrcXSize, nSrcLines,
+			afSource.data(), nSrcXSize, nSrcLines, bComplex ? GDT_CFloat32 : GDT_Float32,
+			nBandCount, anSourceBands.data(), 0, 0,
+			static_cast<GSpacing>(nSrcPlane) * sizeof(float), NULL);
+		const GIntBig nIONanoseconds = (RCMPerfNow() - nIOStart) / nBandCount;
+		if (eErr != CE_None)
+			return eErr;
+
+		for (int iBand = 0; iBand < nBandCount; iBand++) {
+			RCMCalibRasterBand *poBand = apoBands[iBand];
+			RCMPerfCounters *psPerf = poBand->GetPerfCounters();
+			RCMPerfCounters::Add(psPerf->nIONanoseconds, nIONanoseconds);
+			RCMPerfCounters::Add(psPerf->nBytesIn,
+				static_cast<GIntBig>(nSrcXSize) * nSrcLines * nSourceTypeSize);
+			RCMPerfCounters::Add(psPerf->nBytesOut,
+				static_cast<GIntBig>(nXSize) * nLines * GDALGetDataTypeSizeBytes(eBufType));
+
+			/* Detected values are calibrated in place */
+			float *pafPlane = afSource.data() + nSrcPlane * iBand;
+			float *pafCalibrated = bComplex ? afCalibrated.data() : pafPlane;
+			const float *pafResult = pafCalibrated;
+			{
+				RCMPerfTimer oCalibrationTimer(psPerf->nCalibrationNanoseconds);
+				poBand->CalibrateWindow(nSrcXOff, nSrcXSize, nSrcLines, pafPlane,
+					nSrcXSize * nValues, pafCalibrated, nSrcXSize);
+
+				if (IsMultilooked()) {
+					poBand->MultilookWindow(pafCalibrated, nXSize, nLines, afMultilooked.data(), nXSize);
+					pafResult = afMultilooked.data();
+				}
+			}
+
+			GByte *pabyDst = static_cast<GByte *>(pData) + iBand * nBandSpace + iLine * nLineSpace;
+			for (int i = 0; i < nLines; i++) {
+				GDALCopyWords(pafResult + static_cast<size_t>(i) * nXSize, GDT_Float32, sizeof(float),
+					pabyDst + i * nLineSpace, eBufType, static_cast<int>(nPixelSpace), nXSize);
+			}
+		}
+
+		if (psExtraArg != NULL && psExtraArg->pfnProgress != NULL &&
+			!psExtraArg->pfnProgress(static_cast<double>(iLine + nLines) / nYSize, "",
+				psExtraArg->pProgressData)) {
+			CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+			return CE_Failure;
+		}
+	}
+
+	return CE_None;
+}
+
 /************************************************************************/
 /*                      GetMetadataDomainList()                         */
 /************************************************************************/
@@ -2784,7 +4865,7 @@ char **RCMDataset::GetMetadataDomainList()
 {
 	return BuildMetadataDomainList(GDALDataset::GetMetadataDomainList(),
 		TRUE,
-		"SUBDATASETS", NULL);
+		"SUBDATASETS", "__PERF__", NULL);
 }
 
 /************************************************************************/
@@ -2798,9 +4879,669 @@ char **RCMDataset::GetMetadata(const char *pszDomain)
 		papszSubDatasets != NULL)
 		return papszSubDatasets;
 
+	if (pszDomain != NULL && EQUAL(pszDomain, "__PERF__"))
+		return GetPerfMetadata();
+
 	return GDALDataset::GetMetadata(pszDomain);
 }
 
+/************************************************************************/
+/*                          GetMetadataItem()                           */
+/************************************************************************/
+
+const char *RCMDataset::GetMetadataItem(const char *pszName, const char *pszDomain)
+
+{
+	if (pszDomain != NULL && EQUAL(pszDomain, "__PERF__"))
+		return GetPerfMetadataItem(pszName);
+
+	return GDALPamDataset::GetMetadataItem(pszName, pszDomain);
+}
+
+/************************************************************************/
+/*                          SetMetadataItem()                           */
+/************************************************************************/
+/* RESET in the __PERF__ domain sets every counter back to 0, the other */
+/* __PERF__ items are read only.                                        */
+/************************************************************************/
+
+CPLErr RCMDataset::SetMetadataItem(const char *pszName, const char *pszValue,
+	const char *pszDomain)
+
+{
+	if (pszDomain != NULL && EQUAL(pszDomain, "__PERF__")) {
+		if (pszName != NULL && EQUAL(pszName, "RESET")) {
+			if (pszValue != NULL && CPLTestBool(pszValue))
+				ResetPerfCounters();
+			return CE_None;
+		}
+
+		const char msgError[] = "ERROR: The RCM __PERF__ metadata items are read only, except RESET.";
+		write_to_file_error(msgError, "");
+		CPLError(CE_Failure, CPLE_NotSupported, "%s", msgError);
+		return CE_Failure;
+	}
+
+	return GDALPamDataset::SetMetadataItem(pszName, pszValue, pszDomain);
+}
+
+/************************************************************************/
+/*                          GetPerfMetadata()                           */
+/************************************************************************/
+/* XML_PARSE_NS of the dataset, then BAND_<n>_<counter> for the image   */
+/* bands and CHANNEL_<n>_<counter> for the calibrated inputs of a       */
+/* polarimetric product. Rebuilt at every call.                         */
+/************************************************************************/
+
+/* Counters of a band, in the order of the __PERF__ items */
+static const struct {
+	const char *pszName;
+	std::atomic<GIntBig> RCMPerfCounters::*pnMember;
+} asPerfCounters[] = {
+	{ "BLOCKS_READ", &RCMPerfCounters::nBlocksRead },
+	{ "BYTES_IN", &RCMPerfCounters::nBytesIn },
+	{ "BYTES_OUT", &RCMPerfCounters::nBytesOut },
+	{ "IO_NS", &RCMPerfCounters::nIONanoseconds },
+	{ "CALIBRATION_NS", &RCMPerfCounters::nCalibrationNanoseconds },
+	{ "XML_PARSE_NS", &RCMPerfCounters::nXMLParseNanoseconds } };
+
+static RCMPerfCounters *RCMGetBandPerfCounters(GDALRasterBand *poBand)
+{
+	RCMCalibRasterBand *poCalibBand = dynamic_cast<RCMCalibRasterBand *>(poBand);
+	if (poCalibBand != NULL)
+		return poCalibBand->GetPerfCounters();
+
+	RCMRasterBand *poRCMBand = dynamic_cast<RCMRasterBand *>(poBand);
+	if (poRCMBand != NULL)
+		return poRCMBand->GetPerfCounters();
+
+	return NULL;
+}
+
+static char **RCMAddPerfCounters(char **papszList, const char *pszPrefix,
+	const RCMPerfCounters *psPerf)
+{
+	for (size_t i = 0; i < CPL_ARRAYSIZE(asPerfCounters); i++) {
+		papszList = CSLSetNameValue(papszList,
+			CPLSPrintf("%s_%s", pszPrefix, asPerfCounters[i].pszName),
+			CPLSPrintf(CPL_FRMT_GIB, static_cast<GIntBig>(
+				(psPerf->*asPerfCounters[i].pnMember).load(std::memory_order_relaxed))));
+	}
+
+	return papszList;
+}
+
+char **RCMDataset::GetPerfMetadata()
+{
+	CSLDestroy(papszPerf);
+	papszPerf = CSLSetNameValue(NULL, "XML_PARSE_NS",
+		CPLSPrintf(CPL_FRMT_GIB, nXMLParseNanoseconds));
+
+	for (int i = 1; i <= GetRasterCount(); i++) {
+		RCMPerfCounters *psPerf = RCMGetBandPerfCounters(GetRasterBand(i));
+		if (psPerf != NULL)
+			papszPerf = RCMAddPerfCounters(papszPerf, CPLSPrintf("BAND_%d", i), psPerf);
+	}
+
+	for (size_t i = 0; i < apoPolChannels.size(); i++) {
+		if (apoPolChannels[i] != NULL)
+			papszPerf = RCMAddPerfCounters(papszPerf, CPLSPrintf("CHANNEL_%d", static_cast<int>(i) + 1),
+				apoPolChannels[i]->GetPerfCounters());
+	}
+
+	return papszPerf;
+}
+
+/************************************************************************/
+/*                        GetPerfMetadataItem()                         */
+/************************************************************************/
+/* One __PERF__ item, formatted on its own so that the list returned by */
+/* an earlier GetMetadata("__PERF__") stays valid.                      */
+/************************************************************************/
+
+const char *RCMDataset::GetPerfMetadataItem(const char *pszName)
+{
+	if (pszName == NULL)
+		return NULL;
+
+	if (EQUAL(pszName, "XML_PARSE_NS")) {
+		osPerfItem.Printf(CPL_FRMT_GIB, nXMLParseNanoseconds);
+		return osPerfItem.c_str();
+	}
+
+	/* BAND_<n>_<counter> or CHANNEL_<n>_<counter> */
+	const RCMPerfCounters *psPerf = NULL;
+	const char *pszIndex = NULL;
+	if (STARTS_WITH_CI(pszName, "BAND_"))
+		pszIndex = pszName + strlen("BAND_");
+	else if (STARTS_WITH_CI(pszName, "CHANNEL_"))
+		pszIndex = pszName + strlen("CHANNEL_");
+	else
+		return NULL;
+
+	const int nIndex = atoi(pszIndex);
+	const char *pszCounter = pszIndex;
+	while (*pszCounter >= '0' && *pszCounter <= '9')
+		pszCounter++;
+	if (pszCounter == pszIndex || *pszCounter != '_')
+		return NULL;
+	pszCounter++;
+
+	if (STARTS_WITH_CI(pszName, "BAND_")) {
+		if (nIndex >= 1 && nIndex <= GetRasterCount())
+			psPerf = RCMGetBandPerfCounters(GetRasterBand(nIndex));
+	}
+	else if (nIndex >= 1 && nIndex <= static_cast<int>(apoPolChannels.size()) &&
+		apoPolChannels[nIndex - 1] != NULL)
+		psPerf = apoPolChannels[nIndex - 1]->GetPerfCounters();
+
+	if (psPerf == NULL)
+		return NULL;
+
+	for (size_t i = 0; i < CPL_ARRAYSIZE(asPerfCounters); i++) {
+		if (EQUAL(pszCounter, asPerfCounters[i].pszName)) {
+			osPerfItem.Printf(CPL_FRMT_GIB, static_cast<GIntBig>(
+				(psPerf->*asPerfCounters[i].pnMember).load(std::memory_order_relaxed)));
+			return osPerfItem.c_str();
+		}
+	}
+
+	return NULL;
+}
+
+/************************************************************************/
+/*                         ResetPerfCounters()                          */
+/************************************************************************/
+
+void RCMDataset::ResetPerfCounters()
+{
+	for (int i = 1; i <= GetRasterCount(); i++) {
+		RCMPerfCounters *psPerf = RCMGetBandPerfCounters(GetRasterBand(i));
+		if (psPerf != NULL)
+			psPerf->Reset();
+	}
+
+	for (size_t i = 0; i < apoPolChannels.size(); i++) {
+		if (apoPolChannels[i] != NULL)
+			apoPolChannels[i]->GetPerfCounters()->Reset();
+	}
+}
+
+/************************************************************************/
+/*                        GetLineAzimuthTime()                          */
+/************************************************************************/
+
+double RCMDataset::GetLineAzimuthTime(double dfLine)
+{
+	/* Back to the full resolution line when multilooked */
+	return dfFirstLineTime + GetFullResolutionLine(dfLine) * dfLineTimeInterval;
+}
+
+/************************************************************************/
+/*                          HasSlantRange()                             */
+/************************************************************************/
+
+bool RCMDataset::HasSlantRange()
+{
+	if (bSlantRangeGeometry)
+		return true;
+
+	/* Ground range products go through the polynomials at the line time */
+	return bHaveLineTimes && oSlantRange.IsValid();
+}
+
+/************************************************************************/
+/*                          GetSlantRanges()                            */
+/************************************************************************/
+
+CPLErr RCMDataset::GetSlantRanges(double dfLine, int nCount,
+	const double *padfPixel, double *padfSlantRange)
+{
+	if (!HasSlantRange())
+	{
+		const char msgError[] = "ERROR: No slant range information is available for this product.";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_NotSupported, "%s", msgError);
+		return CE_Failure;
+	}
+
+	for (int i = 0; i < nCount; i++)
+	{
+		double dfFullPixel = GetFullResolutionPixel(padfPixel != NULL ? padfPixel[i] : i);
+
+		if (bSlantRangeGeometry)
+		{
+			if (!bPixelTimeIncreasing)
+				dfFullPixel = nFullRasterXSize - 1 - dfFullPixel;
+			padfSlantRange[i] = dfSlantRangeNearEdge + dfFullPixel * dfPixelSpacing;
+		}
+		else
+		{
+			/* Ground range, same convention as the Python tools */
+			if (!bPixelTimeIncreasing)
+				dfFullPixel = nFullRasterXSize - dfFullPixel;
+			padfSlantRange[i] = dfFullPixel * dfPixelSpacing;
+		}
+	}
+
+	/* The ground ranges are replaced in place by the slant ranges */
+	if (!bSlantRangeGeometry)
+		oSlantRange.EvaluateLine(GetLineAzimuthTime(dfLine), nCount,
+			padfSlantRange, padfSlantRange);
+
+	return CE_None;
+}
+
+CPLErr RCMDataset::GetSlantRanges(int nCount, const double *padfPixel,
+	const double *padfLine, double *padfSlantRange)
+{
+	if (bSlantRangeGeometry || !HasSlantRange())
+	{
+		for (int i = 0; i < nCount; i++)
+		{
+			if (GetSlantRanges(padfLine[i], 1, padfPixel + i, padfSlantRange + i) != CE_None)
+				return CE_Failure;
+		}
+		return CE_None;
+	}
+
+	std::vector<double> adfAzimuthTime(nCount);
+	for (int i = 0; i < nCount; i++)
+	{
+		adfAzimuthTime[i] = GetLineAzimuthTime(padfLine[i]);
+
+		double dfFullPixel = GetFullResolutionPixel(padfPixel[i]);
+		if (!bPixelTimeIncreasing)
+			dfFullPixel = nFullRasterXSize - dfFullPixel;
+		padfSlantRange[i] = dfFullPixel * dfPixelSpacing;
+	}
+
+	oSlantRange.Evaluate(nCount, adfAzimuthTime.data(), padfSlantRange, padfSlantRange);
+
+	return CE_None;
+}
+
+/************************************************************************/
+/*                       GetImageCoordinates()                          */
+/************************************************************************/
+
+bool RCMDataset::GetImageCoordinates(double dfAzimuthTime, double dfSlantRange,
+	double *pdfPixel, double *pdfLine)
+{
+	if (!bHaveLineTimes || dfLineTimeInterval == 0.0 || !HasSlantRange())
+		return false;
+
+	const double dfFullLine = (dfAzimuthTime - dfFirstLineTime) / dfLineTimeInterval;
+
+	double dfFullPixel;
+	if (bSlantRangeGeometry)
+	{
+		if (dfPixelSpacing == 0.0)
+			return false;
+		dfFullPixel = (dfSlantRange - dfSlantRangeNearEdge) / dfPixelSpacing;
+		if (!bPixelTimeIncreasing)
+			dfFullPixel = nFullRasterXSize - 1 - dfFullPixel;
+	}
+	else
+	{
+		double dfGroundRange;
+		if (dfPixelSpacing == 0.0 ||
+			!oSlantRange.GroundRange(dfAzimuthTime, dfSlantRange, &dfGroundRange))
+			return false;
+		dfFullPixel = dfGroundRange / dfPixelSpacing;
+		if (!bPixelTimeIncreasing)
+			dfFullPixel = nFullRasterXSize - dfFullPixel;
+	}
+
+	/* To the multilooked grid, if any */
+	*pdfLine = (dfFullLine + 0.5) / nAzimuthLooks - 0.5;
+	*pdfPixel = (dfFullPixel + 0.5) / nRangeLooks - 0.5;
+
+	return true;
+}
+
+/************************************************************************/
+/*                        GetSlantRangeTimes()                          */
+/************************************************************************/
+
+CPLErr RCMDataset::GetSlantRangeTimes(double dfLine, int nCount,
+	const double *padfPixel, double *padfSlantRangeTime)
+{
+	if (GetSlantRanges(dfLine, nCount, padfPixel, padfSlantRangeTime) != CE_None)
+		return CE_Failure;
+
+	for (int i = 0; i < nCount; i++)
+		padfSlantRangeTime[i] = 2.0 * padfSlantRangeTime[i] / RCM_SPEED_OF_LIGHT;
+
+	return CE_None;
+}
+
+/************************************************************************/
+/*                        GetDopplerCentroid()                          */
+/************************************************************************/
+
+CPLErr RCMDataset::GetDopplerCentroid(int nCount, const double *padfPixel,
+	const double *padfLine, double *padfDoppler)
+{
+	if (!bHaveLineTimes || !oDopplerCentroid.IsValid())
+	{
+		const char msgError[] = "ERROR: No Doppler centroid estimates are available for this product.";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_AppDefined, "%s", msgError);
+		return CE_Failure;
+	}
+
+	std::vector<double> adfAzimuthTime(nCount);
+	std::vector<double> adfSlantRangeTime(nCount);
+
+	if (GetSlantRanges(nCount, padfPixel, padfLine, adfSlantRangeTime.data()) != CE_None)
+		return CE_Failure;
+
+	for (int i = 0; i < nCount; i++)
+	{
+		adfAzimuthTime[i] = GetLineAzimuthTime(padfLine[i]);
+		adfSlantRangeTime[i] = 2.0 * adfSlantRangeTime[i] / RCM_SPEED_OF_LIGHT;
+	}
+
+	oDopplerCentroid.Evaluate(nCount, adfAzimuthTime.data(),
+		adfSlantRangeTime.data(), padfDoppler);
+
+	return CE_None;
+}
+
+/************************************************************************/
+/*                        GetIncidenceAngleRow()                        */
+/************************************************************************/
+
+const double *RCMDataset::GetIncidenceAngleRow()
+{
+	if (m_nfIncidenceAngleTable == NULL || m_IncidenceAngleTableSize <= 0)
+		return NULL;
+
+	if (adfIncidenceAngleRow.empty())
+	{
+		/* The table holds one angle per full resolution pixel, a look */
+		/* takes the angle at its centre                               */
+		const int nLast = m_IncidenceAngleTableSize - 1;
+		adfIncidenceAngleRow.resize(nRasterXSize);
+
+		for (int i = 0; i < nRasterXSize; i++)
+		{
+			const double dfPixel = std::max(0.0, std::min(GetFullResolutionPixel(i),
+				static_cast<double>(nLast)));
+			const int n0 = std::min(static_cast<int>(dfPixel), std::max(0, nLast - 1));
+			const int n1 = std::min(n0 + 1, nLast);
+			const double dfFraction = dfPixel - n0;
+
+			adfIncidenceAngleRow[i] = (1.0 - dfFraction) * m_nfIncidenceAngleTable[n0] +
+				dfFraction * m_nfIncidenceAngleTable[n1];
+		}
+	}
+
+	return adfIncidenceAngleRow.data();
+}
+
+/************************************************************************/
+/*                            GetBurstIds()                             */
+/************************************************************************/
+
+CPLErr RCMDataset::GetBurstIds(int nCount, const double *padfPixel,
+	const double *padfLine, int *panBurst, int *panBeam)
+{
+	if (!oBurstMap.IsValid())
+		return CE_Failure;
+
+	/* The burst map is in full resolution pixel/line */
+	if (IsMultilooked())
+	{
+		std::vector<double> adfFullPixel(nCount), adfFullLine(nCount);
+		for (int i = 0; i < nCount; i++)
+		{
+			adfFullPixel[i] = GetFullResolutionPixel(padfPixel[i]);
+			adfFullLine[i] = GetFullResolutionLine(padfLine[i]);
+		}
+		oBurstMap.Query(nCount, adfFullPixel.data(), adfFullLine.data(), panBurst, panBeam);
+	}
+	else
+		oBurstMap.Query(nCount, padfPixel, padfLine, panBurst, panBeam);
+
+	return CE_None;
+}
+
+/************************************************************************/
+/*                       ComputeGeometryLine()                          */
+/************************************************************************/
+
+CPLErr RCMDataset::ComputeGeometryLine(eGeometryLayer eLayer, int nLine,
+	double *padfLine)
+{
+	switch (eLayer)
+	{
+	case GeomSlantRange:
+		return GetSlantRanges(nLine, nRasterXSize, NULL, padfLine);
+	case GeomAzimuthTime:
+	{
+		/* Zero Doppler time only depends on the line */
+		const double dfTime = GetLineAzimuthTime(nLine);
+		for (int i = 0; i < nRasterXSize; i++)
+			padfLine[i] = dfTime;
+		return CE_None;
+	}
+	case GeomDopplerCentroid:
+	{
+		/* The slant range times are replaced in place by the Doppler values */
+		if (GetSlantRangeTimes(nLine, nRasterXSize, NULL, padfLine) != CE_None)
+			return CE_Failure;
+
+		oDopplerCentroid.EvaluateLine(GetLineAzimuthTime(nLine), nRasterXSize,
+			padfLine, padfLine);
+		return CE_None;
+	}
+	case GeomIncidenceAngle:
+	{
+		/* The angle only depends on the pixel */
+		const double *padfAngles = GetIncidenceAngleRow();
+		if (padfAngles == NULL)
+			break;
+		memcpy(padfLine, padfAngles, sizeof(double) * nRasterXSize);
+		return CE_None;
+	}
+	case GeomBurstId:
+	case GeomBeamId:
+	{
+		/* The centre full resolution pixel of each look, (i + 0.5) * n - 0.5 rounded */
+		std::vector<int> anBurst(nRasterXSize), anBeam(nRasterXSize);
+		oBurstMap.QueryLine(nLine * nAzimuthLooks + nAzimuthLooks / 2, nRangeLooks / 2,
+			nRangeLooks, nRasterXSize, anBurst.data(), anBeam.data());
+
+		const std::vector<int> &anValues = eLayer == GeomBurstId ? anBurst : anBeam;
+		for (int i = 0; i < nRasterXSize; i++)
+			padfLine[i] = anValues[i];
+		return CE_None;
+	}
+	default:
+		break;
+	}
+
+	CPLError(CE_Failure, CPLE_AppDefined, "Unsupported RCM geometry layer %d.",
+		static_cast<int>(eLayer));
+	return CE_Failure;
+}
+
+/************************************************************************/
+/*                          ComputeLatLonLine()                         */
+/************************************************************************/
+
+CPLErr RCMDataset::ComputeLatLonLine(int nLine, double *padfLongitude,
+	double *padfLatitude)
+{
+	if (!oRPC.IsValid())
+		return CE_Failure;
+
+	std::vector<double> adfPixel(nRasterXSize);
+	std::vector<double> adfLine(nRasterXSize, static_cast<double>(nLine));
+	for (int i = 0; i < nRasterXSize; i++)
+		adfPixel[i] = i;
+
+	oRPC.Inverse(nRasterXSize, adfPixel.data(), adfLine.data(), NULL, dfTerrainHeight,
+		padfLongitude, padfLatitude, NULL);
+	return CE_None;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                     RCM tie point grid transformer                   */
+/* ==================================================================== */
+/************************************************************************/
+
+typedef struct
+{
+	GDALTransformerInfo sTI;
+
+	RCMTiePointGrid oGrid;
+
+	/* Full resolution pixel/line per transformer pixel/line, for overviews */
+	double dfPixelRatio;
+	double dfLineRatio;
+} RCMTiePointTransformInfo;
+
+static void *RCMCreateSimilarTiePointTransformer(void *hTransformArg,
+	double dfRatioX, double dfRatioY);
+
+/************************************************************************/
+/*                     RCMNewTiePointTransformer()                      */
+/************************************************************************/
+
+static RCMTiePointTransformInfo *RCMNewTiePointTransformer(const RCMTiePointGrid &oGrid)
+{
+	RCMTiePointTransformInfo *psInfo = new RCMTiePointTransformInfo;
+
+	memcpy(psInfo->sTI.abySignature, GDAL_GTI2_SIGNATURE, strlen(GDAL_GTI2_SIGNATURE));
+	psInfo->sTI.pszClassName = "RCMTiePointTransformer";
+	psInfo->sTI.pfnTransform = GDALRCMTiePointTransform;
+	psInfo->sTI.pfnCleanup = GDALDestroyRCMTiePointTransformer;
+	psInfo->sTI.pfnSerialize = NULL;
+	psInfo->sTI.pfnCreateSimilar = RCMCreateSimilarTiePointTransformer;
+
+	psInfo->oGrid = oGrid;
+	psInfo->dfPixelRatio = 1.0;
+	psInfo->dfLineRatio = 1.0;
+
+	return psInfo;
+}
+
+/************************************************************************/
+/*                  GDALCreateRCMTiePointTransformer()                  */
+/************************************************************************/
+
+/**
+* \brief Create a pixel/line to longitude/latitude transformer from the
+* geolocation grid of an RCM dataset
+*
+* The transformer interpolates the tie point lattice bilinearly, in
+* constant time per point when the lattice is regular. Use it with
+* GDALUseTransformer() or as the transformer of GDALWarpOptions, and free
+* it with GDALDestroyTransformer().
+*
+* @return the transformer, or NULL if the dataset is not RCM or its tie
+* points do not form a lattice.
+*/
+void CPL_DLL *GDALCreateRCMTiePointTransformer(GDALDatasetH hDS)
+{
+	VALIDATE_POINTER1(hDS, "GDALCreateRCMTiePointTransformer", NULL);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || !rcmDataset->GetTiePointGrid()->IsValid())
+	{
+		CPLError(CE_Failure, CPLE_AppDefined,
+			"GDALCreateRCMTiePointTransformer(): no RCM geolocation grid lattice.");
+		return NULL;
+	}
+
+	return RCMNewTiePointTransformer(*rcmDataset->GetTiePointGrid());
+}
+
+/************************************************************************/
+/*                 RCMCreateSimilarTiePointTransformer()                */
+/************************************************************************/
+
+static void *RCMCreateSimilarTiePointTransformer(void *hTransformArg,
+	double dfRatioX, double dfRatioY)
+{
+	VALIDATE_POINTER1(hTransformArg, "RCMCreateSimilarTiePointTransformer", NULL);
+
+	RCMTiePointTransformInfo *psInfo =
+		static_cast<RCMTiePointTransformInfo *>(hTransformArg);
+
+	RCMTiePointTransformInfo *psNewInfo = RCMNewTiePointTransformer(psInfo->oGrid);
+	psNewInfo->dfPixelRatio = psInfo->dfPixelRatio * dfRatioX;
+	psNewInfo->dfLineRatio = psInfo->dfLineRatio * dfRatioY;
+
+	return psNewInfo;
+}
+
+/************************************************************************/
+/*                 GDALDestroyRCMTiePointTransformer()                  */
+/************************************************************************/
+
+void CPL_DLL GDALDestroyRCMTiePointTransformer(void *pTransformArg)
+{
+	if (pTransformArg == NULL)
+		return;
+
+	delete static_cast<RCMTiePointTransformInfo *>(pTransformArg);
+}
+
+/************************************************************************/
+/*                      GDALRCMTiePointTransform()                      */
+/************************************************************************/
+
+/**
+* \brief Transform between pixel/line and longitude/latitude with the RCM
+* tie point grid
+*
+* bDstToSrc FALSE takes x/y as pixel/line and returns longitude/latitude,
+* TRUE does the reverse. z is left untouched.
+*/
+int CPL_DLL GDALRCMTiePointTransform(void *pTransformArg, int bDstToSrc,
+	int nPointCount, double *x, double *y, double * /* z */, int *panSuccess)
+{
+	VALIDATE_POINTER1(pTransformArg, "GDALRCMTiePointTransform", 0);
+
+	RCMTiePointTransformInfo *psInfo =
+		static_cast<RCMTiePointTransformInfo *>(pTransformArg);
+
+	if (!bDstToSrc)
+	{
+		for (int i = 0; i < nPointCount; i++)
+		{
+			x[i] *= psInfo->dfPixelRatio;
+			y[i] *= psInfo->dfLineRatio;
+		}
+
+		/* Each point is read before it is overwritten */
+		psInfo->oGrid.Forward(nPointCount, x, y, x, y, NULL);
+
+		for (int i = 0; i < nPointCount; i++)
+			panSuccess[i] = TRUE;
+
+		return TRUE;
+	}
+
+	const int nSuccess = psInfo->oGrid.Inverse(nPointCount, x, y, x, y, panSuccess);
+
+	for (int i = 0; i < nPointCount; i++)
+	{
+		x[i] /= psInfo->dfPixelRatio;
+		y[i] /= psInfo->dfLineRatio;
+	}
+
+	return nSuccess == nPointCount;
+}
+
 /************************************************************************/
 /*                         GDALRegister_RCM()                           */
 /************************************************************************/
@@ -2820,6 +5561,21 @@ void GDALRegister_RCM()
 	poDriver->SetMetadataItem(GDAL_DMD_LONGNAME, "Radarsat Constellation Mission XML Product");
 	poDriver->SetMetadataItem(GDAL_DMD_HELPTOPIC, "frmt_rcm.html");
 	poDriver->SetMetadataItem(GDAL_DMD_SUBDATASETS, "YES");
+	poDriver->SetMetadataItem(GDAL_DMD_OPENOPTIONLIST,
+		"<OpenOptionList>"
+		"  <Option name='MULTILOOK' type='string' description='Azimuth,range looks averaged in linear power on calibrated subdatasets, e.g. 2,2' default='1,1'/>"
+		"  <Option name='NOISE_SUBTRACTION' type='boolean' description='Subtract the noise equivalent level from calibrated subdatasets' default='NO'/>"
+		"  <Option name='NUM_THREADS' type='string' description='Number of threads for the polarimetric decompositions and speckle filters, or ALL_CPUS' default='GDAL_NUM_THREADS or 1'/>"
+		"  <Option name='READAHEAD' type='string' description='Prefetch the next block rows of the calibrated subdatasets in a background thread: YES for 16 MB of source, NO, or a number of block rows' default='NO'/>"
+		"  <Option name='SPECKLE_FILTER' type='string-select' description='Speckle filter of the calibrated power' default='NONE'>"
+		"    <Value>NONE</Value>"
+		"    <Value>BOXCAR</Value>"
+		"    <Value>LEE</Value>"
+		"    <Value>REFINED_LEE</Value>"
+		"  </Option>"
+		"  <Option name='SPECKLE_WINDOW' type='int' description='Odd size of the speckle filter window' default='7'/>"
+		"  <Option name='SPECKLE_ENL' type='float' description='Equivalent number of looks of the Lee filters, the product looks times MULTILOOK by default'/>"
+		"</OpenOptionList>");
 
 	poDriver->pfnOpen = RCMDataset::Open;
 	poDriver->pfnIdentify = RCMDataset::Identify;
@@ -4,6 +4,10 @@
 /* Roberto Fix */
 #include "gdal_pam.h"
 #include "gdal_lut.h"
+#include "rcmgeometry.h"
+#include "rcmspeckle.h"
+
+#include <atomic>
 
 
 // Should be size of larged possible filename.
@@ -12,8 +16,26 @@ static const char szLayerCalibration[] = "RCM_CALIB";
 static const char szLayerSeparator[] = ":";
 static const char szSIGMA0[] = "SIGMA0";
 static const char szGAMMA[] = "GAMMA";
+static const char szGAMMA0_ELLIPSOID[] = "GAMMA0_ELLIPSOID";
 static const char szBETA0[] = "BETA0";
 static const char szUNCALIB[] = "UNCALIB";
+static const char szLayerGeometry[] = "RCM_GEOM";
+static const char szDOPPLER_CENTROID[] = "DOPPLER_CENTROID";
+static const char szSLANT_RANGE[] = "SLANT_RANGE";
+static const char szAZIMUTH_TIME[] = "AZIMUTH_TIME";
+static const char szLATLON[] = "LATLON";
+static const char szLATITUDE[] = "LATITUDE";
+static const char szLONGITUDE[] = "LONGITUDE";
+static const char szBURST_ID[] = "BURST_ID";
+static const char szBEAM_ID[] = "BEAM_ID";
+static const char szINCIDENCE_ANGLE[] = "INCIDENCE_ANGLE";
+static const char szLayerPolarimetry[] = "RCM_POL";
+static const char szSTOKES[] = "STOKES";
+static const char szMCHI[] = "MCHI";
+static const char szC3[] = "C3";
+static const char szT3[] = "T3";
+static const char szPAULI[] = "PAULI";
+static const char szHAALPHA[] = "HAALPHA";
 static const char szPathSeparator[] =
 #ifdef _WIN32 /* Defined if Win32 and Win64 */
 "\\";
@@ -33,6 +55,41 @@ static const char cOppositePathSeparator =
 '\\';
 #endif
 
+/* Virtual geometry layers, opened with RCM_GEOM:<layer>:product.xml */
+enum eGeometryLayer { GeomNone = 0, GeomDopplerCentroid, GeomSlantRange, GeomAzimuthTime,
+	GeomLatLon, GeomBurstId, GeomBeamId, GeomIncidenceAngle };
+
+/* Derived polarimetric products, opened with RCM_POL:<product>:product.xml */
+enum ePolarimetricProduct { PolNone = 0, PolStokes, PolMChi, PolC3, PolT3, PolPauli, PolHAAlpha };
+
+class RCMCalibRasterBand;
+class CPLWorkerThreadPool;
+struct RCMReadaheadJob;
+
+/* Hot path counters of a band, reported in the __PERF__ metadata      */
+/* domain of the dataset. Times are summed over the calling threads.   */
+struct RCMPerfCounters {
+	std::atomic<GIntBig> nBlocksRead{0};
+	std::atomic<GIntBig> nBytesIn{0};     /* source samples, decoded */
+	std::atomic<GIntBig> nBytesOut{0};    /* block samples returned */
+	std::atomic<GIntBig> nIONanoseconds{0};
+	std::atomic<GIntBig> nCalibrationNanoseconds{0};  /* LUT, noise, multilook and speckle */
+	std::atomic<GIntBig> nXMLParseNanoseconds{0};
+
+	static void Add(std::atomic<GIntBig> &nCounter, GIntBig nValue)
+		{ nCounter.fetch_add(nValue, std::memory_order_relaxed); }
+	void Reset();   /* all but the XML parse time, which only happens at open */
+};
+
+/* Threads of the NUM_THREADS option of papszOptions, else of the       */
+/* GDAL_NUM_THREADS configuration option, else 1. ALL_CPUS is the       */
+/* number of CPUs. Clamped to 1 to 128.                                 */
+int RCMGetThreadCount(char **papszOptions);
+
+/* Rows [*piStartRow, *piEndRow) of job iJob when nRows consecutive     */
+/* rows are shared by nJobs jobs                                        */
+void RCMGetJobRows(int nRows, int nJobs, int iJob, int *piStartRow, int *piEndRow);
+
 /************************************************************************/
 /* ==================================================================== */
 /*                               RCMDataset                             */
@@ -59,6 +116,55 @@ class RCMDataset : public GDALPamDataset
 	char      **papszExtraFiles;
 	double     *m_nfIncidenceAngleTable;
 	int         m_IncidenceAngleTableSize;
+	std::vector<double> adfIncidenceAngleRow;  /* per dataset pixel, filled on first use */
+	int         nAzimuthLooks;
+	int         nRangeLooks;
+	int         nFullRasterXSize;   /* image size before multilooking */
+	int         nFullRasterYSize;
+	bool        bNoiseSubtraction;    /* NOISE_SUBTRACTION open option */
+	RCMOrbit    oOrbit;
+	RCMDopplerCentroid oDopplerCentroid;
+	RCMSlantRange oSlantRange;
+	RCMTiePointGrid oTiePointGrid;
+	RCMRPCModel oRPC;
+	RCMBurstMap oBurstMap;
+	double      dfTerrainHeight;      /* GEODETIC_TERRAIN_HEIGHT, else the RPC height offset */
+	double      dfSemiMajorAxis;      /* ellipsoidParameters, WGS84 if incomplete */
+	double      dfSemiMinorAxis;
+	bool        bHaveLineTimes;
+	double      dfFirstLineTime;
+	double      dfLastLineTime;
+	double      dfLineTimeInterval;   /* seconds from one line to the next, negative if decreasing */
+	bool        bSlantRangeGeometry;
+	bool        bPixelTimeIncreasing;
+	double      dfSlantRangeNearEdge;
+	double      dfPixelSpacing;
+	ePolarimetricProduct ePolarimetry;
+	std::vector<RCMCalibRasterBand *> apoPolChannels;  /* calibrated inputs of ePolarimetry, not dataset bands */
+	GDALDataset *poCrossCorrelationFile;  /* MLC XC image, shared by the XC bands */
+	int         nWorkerThreads;       /* NUM_THREADS open option */
+	CPLWorkerThreadPool *poWorkerThreadPool;  /* created on first use if nWorkerThreads > 1 */
+	eSpeckleFilter eSpeckle;          /* SPECKLE_FILTER open option */
+	int         nSpeckleWindow;
+	double      dfSpeckleENL;
+	int         nReadaheadRows;       /* READAHEAD open option, block rows, -1 sized in bytes */
+	GIntBig     nXMLParseNanoseconds; /* product.xml and incidence angles */
+	char      **papszPerf;            /* last __PERF__ metadata returned */
+	CPLString   osPerfItem;           /* last __PERF__ metadata item returned */
+
+	char **GetPerfMetadata();
+	const char *GetPerfMetadataItem(const char *pszName);
+	void ResetPerfCounters();
+	bool GetSharedSourceBands(int nBandCount, int *panBandMap,
+		std::vector<RCMCalibRasterBand *> &apoBands);
+
+	/* Full resolution pixel of a (possibly multilooked) dataset pixel */
+	double GetFullResolutionPixel(double dfPixel) const
+		{ return (dfPixel + 0.5) * nRangeLooks - 0.5; }
+
+	/* Full resolution line of a (possibly multilooked) dataset line */
+	double GetFullResolutionLine(double dfLine) const
+		{ return (dfLine + 0.5) * nAzimuthLooks - 0.5; }
 
 protected:
 	virtual int         CloseDependentDatasets() override;
@@ -74,8 +180,17 @@ public:
 	virtual const char *GetProjectionRef(void) override;
 	virtual CPLErr GetGeoTransform(double *) override;
 
+	virtual CPLErr IRasterIO(GDALRWFlag eRWFlag, int nXOff, int nYOff, int nXSize, int nYSize,
+		void *pData, int nBufXSize, int nBufYSize, GDALDataType eBufType,
+		int nBandCount, int *panBandMap, GSpacing nPixelSpace, GSpacing nLineSpace,
+		GSpacing nBandSpace, GDALRasterIOExtraArg *psExtraArg) override;
+
 	virtual char      **GetMetadataDomainList() override;
 	virtual char **GetMetadata(const char * pszDomain = "") override;
+	virtual const char *GetMetadataItem(const char *pszName,
+		const char *pszDomain = "") override;
+	virtual CPLErr SetMetadataItem(const char *pszName, const char *pszValue,
+		const char *pszDomain = "") override;
 	virtual char **GetFileList(void) override;
 
 	static GDALDataset *Open(GDALOpenInfo *);
@@ -98,6 +213,119 @@ public:
 
 	/* This variable is used to hold the Incidence Angle Table Size */
 	int GetIncidenceAngleSize() { return m_IncidenceAngleTableSize; }
+
+	/* Incidence angle in degrees of the GetRasterXSize() pixels of a   */
+	/* line, the same on every line. Computed on first use and owned by */
+	/* the dataset. NULL without an incidence angle table.              */
+	const double *GetIncidenceAngleRow();
+
+	/* Number of looks averaged by the MULTILOOK open option, 1 if not multilooked */
+	int GetAzimuthLooks() { return nAzimuthLooks; }
+	int GetRangeLooks() { return nRangeLooks; }
+	bool IsMultilooked() { return nAzimuthLooks > 1 || nRangeLooks > 1; }
+
+	/* True if the calibrated bands subtract the noise equivalent sigma0 */
+	bool GetNoiseSubtraction() { return bNoiseSubtraction; }
+
+	/* Speckle filter of the calibrated bands, its odd window size and  */
+	/* the equivalent number of looks of the filtered intensity         */
+	eSpeckleFilter GetSpeckleFilter() { return eSpeckle; }
+	int GetSpeckleWindow() { return nSpeckleWindow; }
+	double GetSpeckleENL() { return dfSpeckleENL; }
+
+	/* Block rows the calibrated bands prefetch ahead of the current   */
+	/* one, 0 if none, -1 for as many as RCM_READAHEAD_BYTES of source */
+	int GetReadaheadRows() { return nReadaheadRows; }
+	bool IsReadahead() { return nReadaheadRows != 0; }
+
+	/* Threads of the NUM_THREADS open option, NULL if only one. The    */
+	/* jobs must not call GDAL, they only compute.                      */
+	CPLWorkerThreadPool *GetWorkerThreadPool();
+	int GetWorkerThreadCount() { return nWorkerThreads; }
+
+	/* Orbit state vectors, check IsValid() before use */
+	const RCMOrbit *GetOrbit() { return &oOrbit; }
+
+	/* Doppler centroid estimates, check IsValid() before use */
+	const RCMDopplerCentroid *GetDopplerCentroidEstimates() { return &oDopplerCentroid; }
+
+	/* Rational functions of the product, check IsValid() before use */
+	const RCMRPCModel *GetRPCModel() { return &oRPC; }
+
+	/* Geodetic terrain height of the scene, in metres */
+	double GetTerrainHeight() { return dfTerrainHeight; }
+
+	/* Axes of the product ellipsoid, in metres */
+	double GetSemiMajorAxis() { return dfSemiMajorAxis; }
+	double GetSemiMinorAxis() { return dfSemiMinorAxis; }
+
+	/* Geolocation grid lattice, check IsValid() before use */
+	const RCMTiePointGrid *GetTiePointGrid() { return &oTiePointGrid; }
+
+	/* Ground to slant range polynomials, check IsValid() before use */
+	const RCMSlantRange *GetSlantRangeEntries() { return &oSlantRange; }
+
+	/* ScanSAR burst map, check IsValid() before use */
+	const RCMBurstMap *GetBurstMap() { return &oBurstMap; }
+
+	/* False for geocoded products, which are not in zero Doppler geometry */
+	bool HasLineTimes() { return bHaveLineTimes; }
+
+	/* Numeric FIRST_LINE_TIME, LAST_LINE_TIME (seconds since 1970) and */
+	/* signed line time interval, only meaningful if HasLineTimes()     */
+	double GetFirstLineTime() { return dfFirstLineTime; }
+	double GetLastLineTime() { return dfLastLineTime; }
+	double GetLineTimeInterval() { return dfLineTimeInterval; }
+
+	/* Zero Doppler azimuth time (seconds since 1970) of an image line */
+	double GetLineAzimuthTime(double dfLine);
+
+	/* True if slant ranges can be computed, from the slant range       */
+	/* geometry of SLC/MLC or the ground to slant range polynomials.    */
+	bool HasSlantRange();
+
+	/* Slant range in metres of nCount pixels along one line.           */
+	/* padfPixel NULL means the pixels 0 to nCount-1.                   */
+	CPLErr GetSlantRanges(double dfLine, int nCount, const double *padfPixel,
+		double *padfSlantRange);
+
+	/* Slant range in metres of nCount (pixel, line) image coordinates  */
+	CPLErr GetSlantRanges(int nCount, const double *padfPixel, const double *padfLine,
+		double *padfSlantRange);
+
+	/* Two way slant range time of nCount pixels along one line.        */
+	/* padfPixel NULL means the pixels 0 to nCount-1.                   */
+	CPLErr GetSlantRangeTimes(double dfLine, int nCount, const double *padfPixel,
+		double *padfSlantRangeTime);
+
+	/* Image pixel/line of a zero Doppler time and slant range, the      */
+	/* inverse of GetLineAzimuthTime() and GetSlantRanges().            */
+	bool GetImageCoordinates(double dfAzimuthTime, double dfSlantRange,
+		double *pdfPixel, double *pdfLine);
+
+	/* Burst number and beam index of nCount (pixel, line) image        */
+	/* coordinates, 0 outside every burst. panBeam may be NULL.         */
+	CPLErr GetBurstIds(int nCount, const double *padfPixel, const double *padfLine,
+		int *panBurst, int *panBeam);
+
+	/* Doppler centroid in Hz of nCount (pixel, line) image coordinates */
+	CPLErr GetDopplerCentroid(int nCount, const double *padfPixel, const double *padfLine,
+		double *padfDoppler);
+
+	/* Fill one full line of a single band virtual geometry layer */
+	CPLErr ComputeGeometryLine(eGeometryLayer eLayer, int nLine, double *padfLine);
+
+	/* Both bands of the LATLON layer for one line, one RPC inversion */
+	CPLErr ComputeLatLonLine(int nLine, double *padfLongitude, double *padfLatitude);
+
+	/* Derived polarimetric product of the dataset, PolNone for image bands */
+	ePolarimetricProduct GetPolarimetricProduct() { return ePolarimetry; }
+
+	/* Compute one block of every band of the polarimetric product from */
+	/* a single read of the input channels. pImage receives the block   */
+	/* of nRequestBand, the other bands go to the block cache.          */
+	CPLErr ComputePolarimetricBlock(int nBlockXOff, int nBlockYOff, int nRequestBand,
+		void *pImage);
 };
 
 /************************************************************************/
@@ -131,6 +359,8 @@ class RCMRasterBand : public GDALPamRasterBand
 	bool 		isOneFilePerPol;
 	bool		isNITF;
 
+	RCMPerfCounters oPerf;
+
 public:
 	RCMRasterBand(RCMDataset *poDSIn,
 		int nBandIn,
@@ -143,6 +373,14 @@ public:
 
 	virtual CPLErr IReadBlock(int, int, void *) override;
 
+	virtual CPLErr AdviseRead(int nXOff, int nYOff, int nXSize, int nYSize,
+		int nBufXSize, int nBufYSize, GDALDataType eBufType,
+		char **papszOptions) override;
+
+	virtual CPLVirtualMem *GetVirtualMemAuto(GDALRWFlag eRWFlag,
+		int *pnPixelSpace, GIntBig *pnLineSpace,
+		char **papszOptions) override;
+
 	bool IsExistLUT();
 
 	double GetLUT(int pixel);
@@ -167,6 +405,8 @@ public:
 
 	eCalibration GetCalibration();
 
+	RCMPerfCounters *GetPerfCounters() { return &oPerf; }
+
 	static GDALDataset *Open(GDALOpenInfo *);
 };
 
@@ -188,6 +428,7 @@ private:
 	GDALDataset *m_poBandDataset;
 	GDALDataType m_eType; /* data type of data being ingested */
 	GDALDataType m_eOriginalType; /* data type that used to be before transformation */
+	int m_nSrcBand;   /* band of m_poBandDataset, the first of I and Q if stored separately */
 
 	double *m_nfTable;
 	int m_nTableSize;
@@ -204,18 +445,77 @@ private:
 	int numberOfValuesNoiseLevels;
 	int m_nTableNoiseLevelsSize;
 
+	/* Per full resolution pixel, only filled when the calibrated values */
+	/* are corrected: noise power (0 if not subtracted) and cosine of    */
+	/* the incidence angle (1 unless Gamma0Ellipsoid)                    */
+	std::vector<double> m_adfNoisePower;
+	std::vector<double> m_adfIncidenceCosine;
+
+	RCMPerfCounters m_oPerf;
+
+	/* READAHEAD: a background thread reads the next block rows through */
+	/* its own handle on the source, warming the caches of the reads    */
+	/* made through m_poBandDataset. Created on first use.              */
+	CPLWorkerThreadPool *m_poReadaheadPool;
+	RCMReadaheadJob *m_psReadahead;
+
 	void ReadLUT();
 	void ReadNoiseLevels();
+	void PrepareCorrection();
+	CPLErr ReadComplexWindow(int nXOff, int nYOff, int nXSize, int nYSize,
+		float *pafIQ);
+	CPLErr ReadFilteredBlock(int nBlockXOff, int nBlockYOff, int nRequestXSize,
+		int nRequestYSize, float *pafData);
+	void GetSourceWindow(int *pnXOff, int *pnYOff, int *pnXSize, int *pnYSize);
+	void StartReadahead(int nBlockYOff);
 public:
+	/* Image file of the band and the band holding its samples. I and  */
+	/* Q stored as 2 separate bands make GetSourceBandCount() 2.        */
+	GDALDataset *GetSourceDataset() { return m_poBandDataset; }
+	int GetSourceBand() { return m_nSrcBand; }
+	int GetSourceBandCount();
+	bool IsComplexSource() { return GDALDataTypeIsComplex(m_eOriginalType) != FALSE; }
+
+	/* Calibrate to linear power a full resolution window read as       */
+	/* Float32 values, or as CFloat32 I,Q pairs for complex data, with */
+	/* nSourceLineSpace floats per line. pafData may be pafSource for   */
+	/* detected data. nXOff indexes the LUT.                            */
+	void CalibrateWindow(int nXOff, int nXSize, int nYSize, const float *pafSource,
+		int nSourceLineSpace, float *pafData, int nLineSpace);
+
+	/* Average the MULTILOOK cells of a calibrated full resolution      */
+	/* window into nXSize x nYSize dataset pixels                       */
+	void MultilookWindow(const float *pafSource, int nXSize, int nYSize,
+		float *pafData, int nLineSpace);
+
+	CPLErr ReadCalibratedWindow(int nXOff, int nYOff, int nXSize, int nYSize,
+		float *pafData, int nLineSpace);
+
+	/* Calibrated (and multilooked) window in dataset pixels and lines */
+	CPLErr ReadMultilookedWindow(int nXOff, int nYOff, int nXSize, int nYSize,
+		float *pafData, int nLineSpace);
+
+	/* Calibrated complex samples z / A as I,Q pairs, complex data only */
+	CPLErr ReadCalibratedComplexWindow(int nXOff, int nYOff, int nXSize, int nYSize,
+		float *pafIQ);
+
 	RCMCalibRasterBand(
 		RCMDataset *poDataset, const char *pszPolarization,
 		GDALDataType eType, GDALDataset *poBandDataset, eCalibration eCalib,
 		const char *pszLUT, const char *pszNoiseLevels, 
-		GDALDataType eOriginalType);
+		GDALDataType eOriginalType, int nSrcBand);
 	~RCMCalibRasterBand();
 
 	CPLErr IReadBlock(int nBlockXOff, int nBlockYOff, void *pImage) override;
 
+	CPLErr AdviseRead(int nXOff, int nYOff, int nXSize, int nYSize,
+		int nBufXSize, int nBufYSize, GDALDataType eBufType,
+		char **papszOptions) override;
+
+	CPLErr ComputeStatistics(int bApproxOK, double *pdfMin, double *pdfMax,
+		double *pdfMean, double *pdfStdDev, GDALProgressFunc pfnProgress,
+		void *pProgressData) override;
+
 	bool IsExistLUT();
 
 	double GetLUT(int pixel);
@@ -244,7 +544,76 @@ public:
 
 	double * CloneNoiseLevels();
 
+	RCMPerfCounters *GetPerfCounters() { return &m_oPerf; }
+
 };
 
 
+/************************************************************************/
+/* ==================================================================== */
+/*                        RCMGeometryRasterBand                         */
+/* ==================================================================== */
+/************************************************************************/
+/* Float64 band computed line by line from the product.xml geometry.    */
+/************************************************************************/
+
+class RCMGeometryRasterBand : public GDALPamRasterBand {
+private:
+	RCMDataset *m_poRCMDataset;
+	eGeometryLayer m_eLayer;
+
+public:
+	RCMGeometryRasterBand(RCMDataset *poDataset, eGeometryLayer eLayer,
+		int nBandIn, const char *pszLayerName);
+
+	virtual CPLErr IReadBlock(int nBlockXOff, int nBlockYOff, void *pImage) override;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                      RCMPolarimetricRasterBand                       */
+/* ==================================================================== */
+/************************************************************************/
+/* Float32 band of a derived polarimetric product. All the bands of a   */
+/* block are computed together by RCMDataset::ComputePolarimetricBlock. */
+/************************************************************************/
+
+class RCMPolarimetricRasterBand : public GDALPamRasterBand {
+	friend class RCMDataset;   /* fills the block cache of the other bands */
+
+private:
+	RCMDataset *m_poRCMDataset;
+	GDALColorInterp m_eColorInterp;
+
+public:
+	RCMPolarimetricRasterBand(RCMDataset *poDataset, int nBandIn,
+		const char *pszBandName, int nBlockXSizeIn, int nBlockYSizeIn,
+		GDALColorInterp eColorInterp = GCI_Undefined);
+
+	virtual CPLErr IReadBlock(int nBlockXOff, int nBlockYOff, void *pImage) override;
+	virtual GDALColorInterp GetColorInterpretation() override { return m_eColorInterp; }
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                   RCMCrossCorrelationRasterBand                      */
+/* ==================================================================== */
+/************************************************************************/
+/* One off-diagonal element of the MLC cross-correlation (XC) image, a  */
+/* complex band of the file or 2 consecutive I and Q bands.             */
+/************************************************************************/
+
+class RCMCrossCorrelationRasterBand : public GDALPamRasterBand {
+private:
+	GDALDataset *m_poBandFile;   /* owned by the dataset */
+	int m_nSrcBand;
+	bool m_bTwoBandComplex;
+
+public:
+	RCMCrossCorrelationRasterBand(RCMDataset *poDataset, int nBandIn,
+		GDALDataset *poBandFile, int nSrcBand, bool bTwoBandComplex);
+
+	virtual CPLErr IReadBlock(int nBlockXOff, int nBlockYOff, void *pImage) override;
+};
+
 #endif /* ndef GDAL_RCM_H_INCLUDED */
@@ -0,0 +1,497 @@
+#include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_priv.h"
+#include "rcmdataset.h"
+#include "gdal_io_error.h"
+#include "rcmspeckle.h"
+
+#include <algorithm>
+#include <cmath>
+#include <vector>
+
+/************************************************************************/
+/* ==================================================================== */
+/*                  Two-parameter CFAR target detection                 */
+/* ==================================================================== */
+/************************************************************************/
+/* A pixel is a target when it stands out of the clutter around it:     */
+/*   x > mean + K * stddev                                              */
+/* where mean and stddev are taken over the background ring, between    */
+/* the guard window and the background window. It must also exceed the  */
+/* noise equivalent level by NESZ_MARGIN dB and lie inside the          */
+/* incidence angle range. Only the strongest pixel of a guard window is */
+/* reported. The image is read tile by tile with a halo of half the     */
+/* background window, and the ring statistics come from summed area     */
+/* tables, so memory depends on the tile and the ring costs O(1).       */
+/************************************************************************/
+
+typedef struct
+{
+	double dfPixel;
+	double dfLine;
+	double dfValue;
+	double dfMean;
+	double dfStdDev;
+	double dfNESZ;
+	double dfIncidence;
+} RCMDetection;
+
+typedef struct
+{
+	const float *pafIn;           /* tile and halo, nInXSize by nInYSize */
+	int nInXSize;
+	int nInYSize;
+	const double *padfSum;        /* summed area tables of pafIn */
+	const double *padfSum2;
+	const double *padfCount;      /* of the valid (positive) pixels */
+	int nTileXOff;                /* tile position inside pafIn */
+	int nTileYOff;
+	int nTileXSize;
+	int iStartRow;                /* rows of the tile */
+	int iEndRow;
+	int nReadXOff;                /* dataset pixel/line of pafIn[0] */
+	int nReadYOff;
+	int nGuard;                   /* half sizes of the windows */
+	int nBackground;
+	double dfK;
+	double dfMinimumRingPixels;
+	const double *padfThreshold;  /* absolute threshold per dataset pixel, 0 if none */
+	const double *padfNESZ;       /* may be NULL */
+	const double *padfIncidence;  /* may be NULL */
+	std::vector<RCMDetection> *pasDetections;
+} RCMDetectJob;
+
+/************************************************************************/
+/*                          RCMDetectRows()                             */
+/************************************************************************/
+
+static void RCMDetectRows(void *pData)
+{
+	RCMDetectJob *psJob = static_cast<RCMDetectJob *>(pData);
+	const int nInXSize = psJob->nInXSize;
+	const int nInYSize = psJob->nInYSize;
+	const size_t nStride = static_cast<size_t>(nInXSize) + 1;
+	const int g = psJob->nGuard;
+	const int b = psJob->nBackground;
+
+	for (int iRow = psJob->iStartRow; iRow < psJob->iEndRow; iRow++)
+	{
+		const int y = psJob->nTileYOff + iRow;
+		const float *pafLine = psJob->pafIn + static_cast<size_t>(y) * nInXSize;
+
+		for (int iCol = 0; iCol < psJob->nTileXSize; iCol++)
+		{
+			const int x = psJob->nTileXOff + iCol;
+			const int nPixel = psJob->nReadXOff + x;
+			const double dfValue = pafLine[x];
+			if (!(dfValue > psJob->padfThreshold[nPixel]))
+				continue;
+
+			/* Background ring, clipped to the raster */
+			const int bx0 = std::max(0, x - b), bx1 = std::min(nInXSize, x + b + 1);
+			const int by0 = std::max(0, y - b), by1 = std::min(nInYSize, y + b + 1);
+			const int gx0 = std::max(0, x - g), gx1 = std::min(nInXSize, x + g + 1);
+			const int gy0 = std::max(0, y - g), gy1 = std::min(nInYSize, y + g + 1);
+
+			const double dfCount = RCMBoxSum(psJob->padfCount, nStride, bx0, by0, bx1, by1) -
+				RCMBoxSum(psJob->padfCount, nStride, gx0, gy0, gx1, gy1);
+			if (dfCount < psJob->dfMinimumRingPixels)
+				continue;
+
+			const double dfMean = (RCMBoxSum(psJob->padfSum, nStride, bx0, by0, bx1, by1) -
+				RCMBoxSum(psJob->padfSum, nStride, gx0, gy0, gx1, gy1)) / dfCount;
+			const double dfVariance = (RCMBoxSum(psJob->padfSum2, nStride, bx0, by0, bx1, by1) -
+				RCMBoxSum(psJob->padfSum2, nStride, gx0, gy0, gx1, gy1)) / dfCount - dfMean * dfMean;
+			const double dfStdDev = sqrt(std::max(0.0, dfVariance));
+			if (dfValue <= dfMean + psJob->dfK * dfStdDev)
+				continue;
+
+			/* Strongest pixel of its guard window, the first one on ties */
+			bool bMaximum = true;
+			for (int yy = gy0; yy < gy1 && bMaximum; yy++)
+			{
+				const float *pafGuard = psJob->pafIn + static_cast<size_t>(yy) * nInXSize;
+				for (int xx = gx0; xx < gx1; xx++)
+				{
+					if (pafGuard[xx] > dfValue ||
+						(pafGuard[xx] == dfValue && (yy < y || (yy == y && xx < x))))
+					{
+						bMaximum = false;
+						break;
+					}
+				}
+			}
+			if (!bMaximum)
+				continue;
+
+			RCMDetection sDetection;
+			sDetection.dfPixel = nPixel;
+			sDetection.dfLine = psJob->nReadYOff + y;
+			sDetection.dfValue = dfValue;
+			sDetection.dfMean = dfMean;
+			sDetection.dfStdDev = dfStdDev;
+			sDetection.dfNESZ = psJob->padfNESZ != NULL ? psJob->padfNESZ[nPixel] : 0.0;
+			sDetection.dfIncidence = psJob->padfIncidence != NULL ? psJob->padfIncidence[nPixel] : 0.0;
+			psJob->pasDetections->push_back(sDetection);
+		}
+	}
+}
+
+/************************************************************************/
+/*                       RCMCreateDetectionFields()                     */
+/************************************************************************/
+/* Create the fields missing from the layer and return their indices.   */
+/************************************************************************/
+
+static bool RCMCreateDetectionFields(OGRLayerH hLayer, const char *const *papszNames,
+	const OGRFieldType *paeTypes, int nFields, int *panIndex)
+{
+	for (int i = 0; i < nFields; i++)
+	{
+		panIndex[i] = OGR_FD_GetFieldIndex(OGR_L_GetLayerDefn(hLayer), papszNames[i]);
+		if (panIndex[i] >= 0)
+			continue;
+
+		OGRFieldDefnH hField = OGR_Fld_Create(papszNames[i], paeTypes[i]);
+		const OGRErr eErr = OGR_L_CreateField(hLayer, hField, TRUE);
+		OGR_Fld_Destroy(hField);
+		if (eErr != OGRERR_NONE)
+			return false;
+
+		panIndex[i] = OGR_FD_GetFieldIndex(OGR_L_GetLayerDefn(hLayer), papszNames[i]);
+		if (panIndex[i] < 0)
+			return false;
+	}
+
+	return true;
+}
+
+/************************************************************************/
+/*                        GDALRCMDetectTargets()                        */
+/************************************************************************/
+
+/**
+* \brief Two-parameter CFAR detection of bright targets (ships)
+*
+* hSrcDS must be a calibrated RCM subdataset (RCM_CALIB:SIGMA0:, ...), it
+* can be multilooked and noise subtracted. Band nBand (1 based) is scanned
+* and every detection is written to hDstLayer as a point feature at its
+* longitude/latitude, with the fields PIXEL, LINE (dataset coordinates of
+* the pixel centre), LONGITUDE, LATITUDE, BAND, the calibrated value in a
+* field named after the calibration (SIGMA0, BETA0, GAMMA or
+* GAMMA0_ELLIPSOID), BACKGROUND_MEAN, BACKGROUND_STDDEV, NESZ (linear, 0
+* without noise levels) and INCIDENCE_ANGLE. Missing fields are created.
+*
+* Options:
+* <ul>
+* <li>K=value: threshold in background standard deviations above the
+* background mean, 5 by default.</li>
+* <li>GUARD_WINDOW=n: odd size of the window excluded from the
+* background around the pixel, and of the window in which only the
+* strongest pixel is reported, 11 by default.</li>
+* <li>BACKGROUND_WINDOW=n: odd size of the background window, 41 by
+* default.</li>
+* <li>NESZ_MARGIN=dB: minimum height above the noise equivalent level of
+* the band, 3 by default. On a noise subtracted band the noise is added
+* back before the test.</li>
+* <li>MIN_INCIDENCE_ANGLE=deg, MAX_INCIDENCE_ANGLE=deg: incidence angle
+* range searched, the whole swath by default.</li>
+* <li>TILE_SIZE=n: tile edge in dataset pixels, 512 by default.</li>
+* <li>NUM_THREADS=n|ALL_CPUS: threads sharing the rows of a tile, defaults
+* to the GDAL_NUM_THREADS configuration option, else 1.</li>
+* </ul>
+*/
+CPLErr CPL_STDCALL GDALRCMDetectTargets(GDALDatasetH hSrcDS, int nBand, OGRLayerH hDstLayer,
+	char **papszOptions, GDALProgressFunc pfnProgress, void *pProgressData)
+{
+	VALIDATE_POINTER1(hSrcDS, "GDALRCMDetectTargets", CE_Failure);
+	VALIDATE_POINTER1(hDstLayer, "GDALRCMDetectTargets", CE_Failure);
+
+	if (pfnProgress == NULL)
+		pfnProgress = GDALDummyProgress;
+
+	RCMDataset *poSrcDS = dynamic_cast<RCMDataset *>(static_cast<GDALDataset *>(hSrcDS));
+	RCMCalibRasterBand *poBand = NULL;
+	if (poSrcDS != NULL && nBand >= 1 && nBand <= poSrcDS->GetRasterCount())
+		poBand = dynamic_cast<RCMCalibRasterBand *>(poSrcDS->GetRasterBand(nBand));
+
+	/* -------------------------------------------------------------------- */
+	/*      Check the inputs.                                               */
+	/* -------------------------------------------------------------------- */
+	if (poBand == NULL || poBand->GetCalibration() == Uncalib || poBand->GetCalibration() == None)
+	{
+		const char msgError[] = "ERROR: Target detection needs a band of a calibrated RCM subdataset (RCM_CALIB:...).";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+		return CE_Failure;
+	}
+
+	const double dfK = CPLAtof(CSLFetchNameValueDef(papszOptions, "K", "5"));
+	const int nGuardWindow = atoi(CSLFetchNameValueDef(papszOptions, "GUARD_WINDOW", "11"));
+	const int nBackgroundWindow = atoi(CSLFetchNameValueDef(papszOptions, "BACKGROUND_WINDOW", "41"));
+	if (nGuardWindow < 1 || nGuardWindow % 2 == 0 ||
+		nBackgroundWindow % 2 == 0 || nBackgroundWindow < nGuardWindow + 4)
+	{
+		const char msgError[] = "ERROR: GUARD_WINDOW and BACKGROUND_WINDOW must be odd, with a background ring at least 2 pixels wide.";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+		return CE_Failure;
+	}
+
+	double dfNESZMargin = pow(10.0,
+		CPLAtof(CSLFetchNameValueDef(papszOptions, "NESZ_MARGIN", "3")) / 10.0);
+	const double dfMinIncidence = CPLAtof(CSLFetchNameValueDef(papszOptions, "MIN_INCIDENCE_ANGLE", "-90"));
+	const double dfMaxIncidence = CPLAtof(CSLFetchNameValueDef(papszOptions, "MAX_INCIDENCE_ANGLE", "90"));
+	const int nTileSize = std::max(64, atoi(CSLFetchNameValueDef(papszOptions, "TILE_SIZE", "512")));
+
+	int nThreads = RCMGetThreadCount(papszOptions);
+
+	/* -------------------------------------------------------------------- */
+	/*      Output fields.                                                  */
+	/* -------------------------------------------------------------------- */
+	const char *pszValueField;
+	switch (poBand->GetCalibration())
+	{
+	case Beta0:
+		pszValueField = szBETA0;
+		break;
+	case Gamma:
+		pszValueField = szGAMMA;
+		break;
+	case Gamma0Ellipsoid:
+		pszValueField = szGAMMA0_ELLIPSOID;
+		break;
+	default:
+		pszValueField = szSIGMA0;
+		break;
+	}
+
+	enum { FieldPixel = 0, FieldLine, FieldLongitude, FieldLatitude, FieldBand, FieldValue,
+		FieldMean, FieldStdDev, FieldNESZ, FieldIncidence, FieldCount };
+	const char *const apszFields[FieldCount] = { "PIXEL", "LINE", "LONGITUDE", "LATITUDE", "BAND",
+		pszValueField, "BACKGROUND_MEAN", "BACKGROUND_STDDEV", "NESZ", "INCIDENCE_ANGLE" };
+	const OGRFieldType aeTypes[FieldCount] = { OFTReal, OFTReal, OFTReal, OFTReal, OFTInteger,
+		OFTReal, OFTReal, OFTReal, OFTReal, OFTReal };
+	int anFields[FieldCount];
+	if (!RCMCreateDetectionFields(hDstLayer, apszFields, aeTypes, FieldCount, anFields))
+	{
+		CPLError(CE_Failure, CPLE_AppDefined, "Cannot create the detection fields.");
+		return CE_Failure;
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Noise equivalent level and incidence angle per dataset pixel,   */
+	/*      merged into one absolute threshold.                             */
+	/* -------------------------------------------------------------------- */
+	const int nRasterXSize = poSrcDS->GetRasterXSize();
+	const int nRasterYSize = poSrcDS->GetRasterYSize();
+	const int nRangeLooks = poSrcDS->GetRangeLooks();
+	const double *padfIncidence = poSrcDS->GetIncidenceAngleRow();
+
+	std::vector<double> adfNESZ;
+	if (poBand->IsExistNoiseLevels())
+	{
+		/* Mean noise power of the full resolution pixels of a look */
+		const int nLast = poBand->GetNoiseLevelsSize() - 1;
+		adfNESZ.assign(nRasterXSize, 0.0);
+		for (int i = 0; i < nRasterXSize; i++)
+		{
+			for (int k = 0; k < nRangeLooks; k++)
+				adfNESZ[i] += pow(10.0, poBand->GetNoiseLevels(std::min(i * nRangeLooks + k, nLast)) / 10.0);
+			adfNESZ[i] /= nRangeLooks;
+
+			/* The noise levels of GAMMA0_ELLIPSOID are those of Sigma0 */
+			if (poBand->GetCalibration() == Gamma0Ellipsoid && padfIncidence != NULL)
+				adfNESZ[i] /= cos(padfIncidence[i] * (M_PI / 180.0));
+		}
+	}
+	else
+	{
+		CPLDebug("RCM", "No noise levels for band %d, the NESZ margin is not applied.", nBand);
+	}
+
+	/* A noise subtracted band is already NESZ lower, so the noise is */
+	/* added back: x + NESZ > NESZ * margin                           */
+	if (!adfNESZ.empty() && poSrcDS->GetNoiseSubtraction())
+		dfNESZMargin = std::max(0.0, dfNESZMargin - 1.0);
+
+	std::vector<double> adfThreshold(nRasterXSize, 0.0);
+	for (int i = 0; i < nRasterXSize; i++)
+	{
+		if (!adfNESZ.empty())
+			adfThreshold[i] = adfNESZ[i] * dfNESZMargin;
+		if (padfIncidence != NULL &&
+			(padfIncidence[i] < dfMinIncidence || padfIncidence[i] > dfMaxIncidence))
+			adfThreshold[i] = HUGE_VAL;
+	}
+
+	CPLWorkerThreadPool oPool;
+	if (nThreads > 1 && !oPool.Setup(nThreads, NULL, NULL))
+		nThreads = 1;
+
+	/* -------------------------------------------------------------------- */
+	/*      Process the image tile by tile.                                 */
+	/* -------------------------------------------------------------------- */
+	const int g = nGuardWindow / 2;
+	const int b = nBackgroundWindow / 2;
+	const int nTilesX = (nRasterXSize + nTileSize - 1) / nTileSize;
+	const int nTilesY = (nRasterYSize + nTileSize - 1) / nTileSize;
+	const size_t nInMax = static_cast<size_t>(nTileSize) + 2 * b;
+
+	std::vector<float> afIn(nInMax * nInMax);
+	std::vector<double> adfSum((nInMax + 1) * (nInMax + 1));
+	std::vector<double> adfSum2(adfSum.size()), adfCount(adfSum.size());
+	std::vector<RCMDetectJob> asJobs(nThreads);
+	std::vector<std::vector<RCMDetection> > aasDetections(nThreads);
+
+	const RCMTiePointGrid *poGrid = poSrcDS->GetTiePointGrid();
+	const RCMRPCModel *poRPC = poSrcDS->GetRPCModel();
+
+	CPLErr eErr = CE_None;
+	GIntBig nDetections = 0;
+
+	for (int iTileY = 0; iTileY < nTilesY && eErr == CE_None; iTileY++)
+	{
+		for (int iTileX = 0; iTileX < nTilesX && eErr == CE_None; iTileX++)
+		{
+			const int nXOff = iTileX * nTileSize;
+			const int nYOff = iTileY * nTileSize;
+			const int nXSize = std::min(nTileSize, nRasterXSize - nXOff);
+			const int nYSize = std::min(nTileSize, nRasterYSize - nYOff);
+
+			/* Tile and halo, clipped to the raster */
+			const int nReadXOff = std::max(0, nXOff - b);
+			const int nReadYOff = std::max(0, nYOff - b);
+			const int nInXSize = std::min(nRasterXSize, nXOff + nXSize + b) - nReadXOff;
+			const int nInYSize = std::min(nRasterYSize, nYOff + nYSize + b) - nReadYOff;
+
+			eErr = poBand->ReadMultilookedWindow(nReadXOff, nReadYOff, nInXSize, nInYSize,
+				afIn.data(), nInXSize);
+			if (eErr != CE_None)
+				break;
+
+			/* Summed area tables, only the positive pixels are background */
+			RCMBuildSummedAreaTables(afIn.data(), nInXSize, nInYSize,
+				adfSum.data(), adfSum2.data(), adfCount.data());
+
+			/* Rows of the tile shared between the threads */
+			for (int iJob = 0; iJob < nThreads; iJob++)
+			{
+				RCMDetectJob &sJob = asJobs[iJob];
+				sJob.pafIn = afIn.data();
+				sJob.nInXSize = nInXSize;
+				sJob.nInYSize = nInYSize;
+				sJob.padfSum = adfSum.data();
+				sJob.padfSum2 = adfSum2.data();
+				sJob.padfCount = adfCount.data();
+				sJob.nTileXOff = nXOff - nReadXOff;
+				sJob.nTileYOff = nYOff - nReadYOff;
+				sJob.nTileXSize = nXSize;
+				RCMGetJobRows(nYSize, nThreads, iJob, &sJob.iStartRow, &sJob.iEndRow);
+				sJob.nReadXOff = nReadXOff;
+				sJob.nReadYOff = nReadYOff;
+				sJob.nGuard = g;
+				sJob.nBackground = b;
+				sJob.dfK = dfK;
+				/* At least half of the full ring */
+				sJob.dfMinimumRingPixels = 0.5 * (static_cast<double>(nBackgroundWindow) * nBackgroundWindow -
+					static_cast<double>(nGuardWindow) * nGuardWindow);
+				sJob.padfThreshold = adfThreshold.data();
+				sJob.padfNESZ = adfNESZ.empty() ? NULL : adfNESZ.data();
+				sJob.padfIncidence = padfIncidence;
+				sJob.pasDetections = &aasDetections[iJob];
+				aasDetections[iJob].clear();
+
+				if (nThreads > 1)
+					oPool.SubmitJob(RCMDetectRows, &sJob);
+				else
+					RCMDetectRows(&sJob);
+			}
+			if (nThreads > 1)
+				oPool.WaitCompletion();
+
+			/* Geolocate and write the detections, in line order */
+			for (int iJob = 0; iJob < nThreads && eErr == CE_None; iJob++)
+			{
+				const std::vector<RCMDetection> &asDetections = aasDetections[iJob];
+				const int nCount = static_cast<int>(asDetections.size());
+				if (nCount == 0)
+					continue;
+
+				std::vector<double> adfPixel(nCount), adfLine(nCount);
+				std::vector<double> adfLongitude(nCount, 0.0), adfLatitude(nCount, 0.0);
+				std::vector<int> abGeolocated(nCount, FALSE);
+				for (int i = 0; i < nCount; i++)
+				{
+					adfPixel[i] = asDetections[i].dfPixel + 0.5;
+					adfLine[i] = asDetections[i].dfLine + 0.5;
+				}
+
+				if (poGrid->IsValid())
+				{
+					poGrid->Forward(nCount, adfPixel.data(), adfLine.data(),
+						adfLongitude.data(), adfLatitude.data(), NULL);
+					std::fill(abGeolocated.begin(), abGeolocated.end(), TRUE);
+				}
+				else if (poRPC->IsValid())
+				{
+					/* The rational functions have pixel centres at integers */
+					std::vector<double> adfCentrePixel(nCount), adfCentreLine(nCount);
+					for (int i = 0; i < nCount; i++)
+					{
+						adfCentrePixel[i] = asDetections[i].dfPixel;
+						adfCentreLine[i] = asDetections[i].dfLine;
+					}
+					poRPC->Inverse(nCount, adfCentrePixel.data(), adfCentreLine.data(), NULL,
+						poSrcDS->GetTerrainHeight(), adfLongitude.data(), adfLatitude.data(),
+						abGeolocated.data());
+				}
+
+				for (int i = 0; i < nCount && eErr == CE_None; i++)
+				{
+					const RCMDetection &sDetection = asDetections[i];
+					OGRFeatureH hFeature = OGR_F_Create(OGR_L_GetLayerDefn(hDstLayer));
+
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldPixel], adfPixel[i]);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldLine], adfLine[i]);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldLongitude], adfLongitude[i]);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldLatitude], adfLatitude[i]);
+					OGR_F_SetFieldInteger(hFeature, anFields[FieldBand], nBand);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldValue], sDetection.dfValue);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldMean], sDetection.dfMean);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldStdDev], sDetection.dfStdDev);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldNESZ], sDetection.dfNESZ);
+					OGR_F_SetFieldDouble(hFeature, anFields[FieldIncidence], sDetection.dfIncidence);
+
+					if (abGeolocated[i])
+					{
+						OGRGeometryH hPoint = OGR_G_CreateGeometry(wkbPoint);
+						OGR_G_SetPoint_2D(hPoint, 0, adfLongitude[i], adfLatitude[i]);
+						OGR_F_SetGeometryDirectly(hFeature, hPoint);
+					}
+
+					if (OGR_L_CreateFeature(hDstLayer, hFeature) != OGRERR_NONE)
+						eErr = CE_Failure;
+					OGR_F_Destroy(hFeature);
+				}
+
+				nDetections += nCount;
+			}
+
+			if (eErr == CE_None &&
+				!pfnProgress((iTileY * nTilesX + iTileX + 1) / static_cast<double>(nTilesX * nTilesY),
+					NULL, pProgressData))
+			{
+				CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+				eErr = CE_Failure;
+			}
+		}
+	}
+
+	CPLDebug("RCM", "%d x %d pixels searched, " CPL_FRMT_GIB " targets detected.",
+		nRasterXSize, nRasterYSize, nDetections);
+
+	return eErr;
+}
@@ -0,0 +1,338 @@
+#include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_priv.h"
+#include "rcmdataset.h"
+#include "gdal_io_error.h"
+
+#include <algorithm>
+#include <vector>
+
+/************************************************************************/
+/* ==================================================================== */
+/*                  Calibrated export to cloud optimized GeoTIFF        */
+/* ==================================================================== */
+/************************************************************************/
+/* Strips of blocks are read and calibrated in parallel, each worker    */
+/* through its own handle on the subdataset, while the calling thread   */
+/* writes the previous strips to an uncompressed tiled GeoTIFF. The     */
+/* power domain overviews are built on that file, which is then copied  */
+/* to the compressed COG layout (overviews after the full resolution    */
+/* image) with the compression of the blocks shared by NUM_THREADS.     */
+/************************************************************************/
+
+typedef struct
+{
+	GDALDataset *poDS;      /* handle of this worker */
+	int nYOff;
+	int nYSize;
+	GByte *pabyData;        /* nXSize * nYSize pixels of every band */
+	CPLErr eErr;
+} RCMExportJob;
+
+/************************************************************************/
+/*                          RCMExportReadStrip()                        */
+/************************************************************************/
+
+static void RCMExportReadStrip(void *pData)
+{
+	RCMExportJob *psJob = static_cast<RCMExportJob *>(pData);
+	GDALDataset *poDS = psJob->poDS;
+	const GDALDataType eType = poDS->GetRasterBand(1)->GetRasterDataType();
+
+	psJob->eErr = poDS->RasterIO(GF_Read, 0, psJob->nYOff, poDS->GetRasterXSize(), psJob->nYSize,
+		psJob->pabyData, poDS->GetRasterXSize(), psJob->nYSize, eType,
+		poDS->GetRasterCount(), NULL, 0, 0, 0, NULL);
+}
+
+/************************************************************************/
+/*                        RCMExportCopyMetadata()                       */
+/************************************************************************/
+/* Georeferencing, metadata domains and the calibration sources of the  */
+/* bands, so that the exported file documents how it was calibrated.    */
+/************************************************************************/
+
+static void RCMExportCopyMetadata(RCMDataset *poSrcDS, GDALDataset *poDstDS)
+{
+	double adfGeoTransform[6];
+	if (poSrcDS->GetGeoTransform(adfGeoTransform) == CE_None) {
+		poDstDS->SetGeoTransform(adfGeoTransform);
+		poDstDS->SetProjection(poSrcDS->GetProjectionRef());
+	}
+	else if (poSrcDS->GetGCPCount() > 0) {
+		poDstDS->SetGCPs(poSrcDS->GetGCPCount(), poSrcDS->GetGCPs(), poSrcDS->GetGCPProjection());
+	}
+
+	poDstDS->SetMetadata(poSrcDS->GetMetadata());
+	if (poSrcDS->GetMetadata("RPC") != NULL)
+		poDstDS->SetMetadata(poSrcDS->GetMetadata("RPC"), "RPC");
+	poDstDS->SetMetadataItem("RCM_SOURCE", poSrcDS->GetDescription());
+
+	for (int iBand = 1; iBand <= poSrcDS->GetRasterCount(); iBand++) {
+		GDALRasterBand *poSrcBand = poSrcDS->GetRasterBand(iBand);
+		GDALRasterBand *poDstBand = poDstDS->GetRasterBand(iBand);
+
+		poDstBand->SetDescription(poSrcBand->GetDescription());
+		poDstBand->SetMetadata(poSrcBand->GetMetadata());
+
+		RCMCalibRasterBand *poCalibBand = dynamic_cast<RCMCalibRasterBand *>(poSrcBand);
+		if (poCalibBand == NULL)
+			continue;
+
+		if (poCalibBand->GetLUTFilename() != NULL)
+			poDstBand->SetMetadataItem("CALIBRATION_LUT", poCalibBand->GetLUTFilename());
+		if (poCalibBand->IsExistNoiseLevels())
+			poDstBand->SetMetadataItem("NOISE_LEVELS", poCalibBand->GetNoiseLevelsFilename());
+		poDstBand->SetMetadataItem("NOISE_SUBTRACTION",
+			poSrcDS->GetNoiseSubtraction() ? "YES" : "NO");
+	}
+}
+
+/************************************************************************/
+/*                          GDALRCMExportCOG()                          */
+/************************************************************************/
+
+/**
+* \brief Export a calibrated RCM dataset to a cloud optimized GeoTIFF
+*
+* hSrcDS must be a calibrated RCM subdataset (RCM_CALIB:SIGMA0:, ...),
+* with any MULTILOOK, NOISE_SUBTRACTION or SPECKLE_FILTER open options.
+* The GCPs or geotransform, the RPC and the product metadata are kept, and
+* every band records its CALIBRATION_LUT and NOISE_LEVELS files.
+* Overviews average the linear power, they are not built for complex data.
+*
+* A temporary uncompressed GeoTIFF, pszDstFilename with a .tmp.tif suffix,
+* is written first and deleted at the end.
+*
+* Options:
+* <ul>
+* <li>COMPRESS=DEFLATE|LZW|ZSTD|NONE: DEFLATE by default.</li>
+* <li>PREDICTOR=n: 3 (floating point) by default when compressing.</li>
+* <li>BLOCKSIZE=n: tile edge, 512 by default.</li>
+* <li>OVERVIEWS=AUTO|NONE: AUTO halves the size until it fits in a tile.</li>
+* <li>NUM_THREADS=n|ALL_CPUS: readers and compressors, defaults to the
+* GDAL_NUM_THREADS configuration option, else 1.</li>
+* </ul>
+*/
+CPLErr CPL_STDCALL GDALRCMExportCOG(GDALDatasetH hSrcDS, const char *pszDstFilename,
+	char **papszOptions, GDALProgressFunc pfnProgress, void *pProgressData)
+{
+	VALIDATE_POINTER1(hSrcDS, "GDALRCMExportCOG", CE_Failure);
+	VALIDATE_POINTER1(pszDstFilename, "GDALRCMExportCOG", CE_Failure);
+
+	if (pfnProgress == NULL)
+		pfnProgress = GDALDummyProgress;
+
+	RCMDataset *poSrcDS = dynamic_cast<RCMDataset *>(static_cast<GDALDataset *>(hSrcDS));
+
+	/* -------------------------------------------------------------------- */
+	/*      Check the inputs.                                               */
+	/* -------------------------------------------------------------------- */
+	RCMCalibRasterBand *poFirstBand = NULL;
+	if (poSrcDS != NULL && poSrcDS->GetRasterCount() > 0)
+		poFirstBand = dynamic_cast<RCMCalibRasterBand *>(poSrcDS->GetRasterBand(1));
+
+	if (poFirstBand == NULL || poFirstBand->GetCalibration() == Uncalib ||
+		poFirstBand->GetCalibration() == None)
+	{
+		const char msgError[] = "ERROR: COG export needs a calibrated RCM subdataset (RCM_CALIB:...).";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+		return CE_Failure;
+	}
+
+	GDALDriver *poGTiff = GetGDALDriverManager()->GetDriverByName("GTiff");
+	if (poGTiff == NULL) {
+		CPLError(CE_Failure, CPLE_AppDefined, "The GTiff driver is not available.");
+		return CE_Failure;
+	}
+
+	const char *pszCompress = CSLFetchNameValueDef(papszOptions, "COMPRESS", "DEFLATE");
+	const char *pszPredictor = CSLFetchNameValueDef(papszOptions, "PREDICTOR",
+		EQUAL(pszCompress, "NONE") ? "1" : "3");
+	const int nBlockSize = std::max(64, std::min(4096,
+		atoi(CSLFetchNameValueDef(papszOptions, "BLOCKSIZE", "512"))));
+	const bool bOverviews = !EQUAL(CSLFetchNameValueDef(papszOptions, "OVERVIEWS", "AUTO"), "NONE");
+
+	int nThreads = RCMGetThreadCount(papszOptions);
+
+	const int nXSize = poSrcDS->GetRasterXSize();
+	const int nYSize = poSrcDS->GetRasterYSize();
+	const int nBands = poSrcDS->GetRasterCount();
+	const GDALDataType eType = poFirstBand->GetRasterDataType();
+	const int nPixelSize = GDALGetDataTypeSizeBytes(eType);
+
+	/* -------------------------------------------------------------------- */
+	/*      One handle on the subdataset per reader.                        */
+	/* -------------------------------------------------------------------- */
+	const char *const apszDrivers[] = { "RCM", NULL };
+	std::vector<GDALDataset *> apoReaders;
+	for (int i = 0; i < nThreads; i++) {
+		GDALDataset *poReader = static_cast<GDALDataset *>(GDALOpenEx(poSrcDS->GetDescription(),
+			GDAL_OF_RASTER | GDAL_OF_VERBOSE_ERROR, apszDrivers, poSrcDS->GetOpenOptions(), NULL));
+		if (poReader == NULL)
+			break;
+		apoReaders.push_back(poReader);
+	}
+	if (apoReaders.empty())
+		return CE_Failure;
+	nThreads = static_cast<int>(apoReaders.size());
+
+	CPLWorkerThreadPool oPool;
+	if (nThreads > 1 && !oPool.Setup(nThreads, NULL, NULL)) {
+		for (size_t i = 1; i < apoReaders.size(); i++)
+			GDALClose(apoReaders[i]);
+		apoReaders.resize(1);
+		nThreads = 1;
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Temporary tiled file.                                           */
+	/* -------------------------------------------------------------------- */
+	const CPLString osTmpFilename = CPLString(pszDstFilename) + ".tmp.tif";
+
+	char **papszTmpOptions = NULL;
+	papszTmpOptions = CSLSetNameValue(papszTmpOptions, "TILED", "YES");
+	papszTmpOptions = CSLSetNameValue(papszTmpOptions, "BLOCKXSIZE", CPLSPrintf("%d", nBlockSize));
+	papszTmpOptions = CSLSetNameValue(papszTmpOptions, "BLOCKYSIZE", CPLSPrintf("%d", nBlockSize));
+	papszTmpOptions = CSLSetNameValue(papszTmpOptions, "BIGTIFF", "IF_SAFER");
+	GDALDataset *poTmpDS = poGTiff->Create(osTmpFilename, nXSize, nYSize, nBands, eType, papszTmpOptions);
+	CSLDestroy(papszTmpOptions);
+
+	if (poTmpDS == NULL) {
+		for (size_t i = 0; i < apoReaders.size(); i++)
+			GDALClose(apoReaders[i]);
+		return CE_Failure;
+	}
+
+	RCMExportCopyMetadata(poSrcDS, poTmpDS);
+
+	/* -------------------------------------------------------------------- */
+	/*      Read strips of blocks in parallel, write the previous batch     */
+	/*      meanwhile.                                                      */
+	/* -------------------------------------------------------------------- */
+	const int nStrips = (nYSize + nBlockSize - 1) / nBlockSize;
+	const size_t nStripBytes = static_cast<size_t>(nXSize) * nBlockSize * nBands * nPixelSize;
+
+	/* Two batches of nThreads strips: one read, one written */
+	std::vector<RCMExportJob> asJobs(2 * nThreads);
+	std::vector<GByte *> apabyBuffers(2 * nThreads, NULL);
+	CPLErr eErr = CE_None;
+	for (size_t i = 0; i < apabyBuffers.size() && eErr == CE_None; i++) {
+		apabyBuffers[i] = static_cast<GByte *>(VSI_MALLOC_VERBOSE(nStripBytes));
+		if (apabyBuffers[i] == NULL)
+			eErr = CE_Failure;
+	}
+
+	const int nBatches = (nStrips + nThreads - 1) / nThreads;
+	void *pScaledProgress = GDALCreateScaledProgress(0.0, bOverviews ? 0.5 : 0.7, pfnProgress, pProgressData);
+
+	for (int iBatch = 0; iBatch <= nBatches && eErr == CE_None; iBatch++) {
+		/* Submit the reads of this batch */
+		RCMExportJob *pasBatch = asJobs.data() + (iBatch % 2) * nThreads;
+		if (iBatch < nBatches) {
+			for (int i = 0; i < nThreads; i++) {
+				const int iStrip = iBatch * nThreads + i;
+				RCMExportJob &sJob = pasBatch[i];
+				sJob.poDS = apoReaders[i];
+				sJob.nYOff = iStrip * nBlockSize;
+				sJob.nYSize = iStrip < nStrips ? std::min(nBlockSize, nYSize - sJob.nYOff) : 0;
+				sJob.pabyData = apabyBuffers[(iBatch % 2) * nThreads + i];
+				sJob.eErr = CE_None;
+
+				if (sJob.nYSize == 0)
+					continue;
+				if (nThreads > 1)
+					oPool.SubmitJob(RCMExportReadStrip, &sJob);
+				else
+					RCMExportReadStrip(&sJob);
+			}
+		}
+
+		/* Write the previous batch while the readers work */
+		if (iBatch > 0) {
+			const RCMExportJob *pasPrevious = asJobs.data() + ((iBatch - 1) % 2) * nThreads;
+			for (int i = 0; i < nThreads && eErr == CE_None; i++) {
+				const RCMExportJob &sJob = pasPrevious[i];
+				if (sJob.nYSize == 0)
+					continue;
+
+				eErr = sJob.eErr;
+				if (eErr == CE_None)
+					eErr = poTmpDS->RasterIO(GF_Write, 0, sJob.nYOff, nXSize, sJob.nYSize,
+						sJob.pabyData, nXSize, sJob.nYSize, eType, nBands, NULL, 0, 0, 0, NULL);
+
+				if (eErr == CE_None &&
+					!GDALScaledProgress(static_cast<double>(sJob.nYOff + sJob.nYSize) / nYSize,
+						NULL, pScaledProgress)) {
+					CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+					eErr = CE_Failure;
+				}
+			}
+		}
+
+		if (nThreads > 1)
+			oPool.WaitCompletion();
+	}
+
+	GDALDestroyScaledProgress(pScaledProgress);
+
+	for (size_t i = 0; i < apabyBuffers.size(); i++)
+		CPLFree(apabyBuffers[i]);
+	for (size_t i = 0; i < apoReaders.size(); i++)
+		GDALClose(apoReaders[i]);
+
+	/* -------------------------------------------------------------------- */
+	/*      Overviews averaging the linear power, down to one tile.         */
+	/* -------------------------------------------------------------------- */
+	if (eErr == CE_None && bOverviews) {
+		if (GDALDataTypeIsComplex(eType)) {
+			CPLDebug("RCM", "No overviews for complex data, averaging I/Q would not preserve the power.");
+		}
+		else {
+			std::vector<int> anLevels;
+			for (int nLevel = 2; nXSize / (nLevel / 2) > nBlockSize || nYSize / (nLevel / 2) > nBlockSize; nLevel *= 2)
+				anLevels.push_back(nLevel);
+
+			if (!anLevels.empty()) {
+				pScaledProgress = GDALCreateScaledProgress(0.5, 0.7, pfnProgress, pProgressData);
+				eErr = poTmpDS->BuildOverviews("AVERAGE", static_cast<int>(anLevels.size()),
+					anLevels.data(), 0, NULL, GDALScaledProgress, pScaledProgress);
+				GDALDestroyScaledProgress(pScaledProgress);
+			}
+		}
+	}
+
+	/* -------------------------------------------------------------------- */
+	/*      Compressed copy with the overviews after the image.             */
+	/* -------------------------------------------------------------------- */
+	if (eErr == CE_None) {
+		char **papszCOGOptions = NULL;
+		papszCOGOptions = CSLSetNameValue(papszCOGOptions, "TILED", "YES");
+		papszCOGOptions = CSLSetNameValue(papszCOGOptions, "BLOCKXSIZE", CPLSPrintf("%d", nBlockSize));
+		papszCOGOptions = CSLSetNameValue(papszCOGOptions, "BLOCKYSIZE", CPLSPrintf("%d", nBlockSize));
+		papszCOGOptions = CSLSetNameValue(papszCOGOptions, "COPY_SRC_OVERVIEWS", "YES");
+		papszCOGOptions = CSLSetNameValue(papszCOGOptions, "BIGTIFF", "IF_SAFER");
+		papszCOGOptions = CSLSetNameValue(papszCOGOptions, "NUM_THREADS", CPLSPrintf("%d", nThreads));
+		if (!EQUAL(pszCompress, "NONE")) {
+			papszCOGOptions = CSLSetNameValue(papszCOGOptions, "COMPRESS", pszCompress);
+			papszCOGOptions = CSLSetNameValue(papszCOGOptions, "PREDICTOR", pszPredictor);
+		}
+
+		pScaledProgress = GDALCreateScaledProgress(0.7, 1.0, pfnProgress, pProgressData);
+		GDALDataset *poDstDS = poGTiff->CreateCopy(pszDstFilename, poTmpDS, FALSE, papszCOGOptions,
+			GDALScaledProgress, pScaledProgress);
+		GDALDestroyScaledProgress(pScaledProgress);
+		CSLDestroy(papszCOGOptions);
+
+		if (poDstDS == NULL)
+			eErr = CE_Failure;
+		else
+			GDALClose(poDstDS);
+	}
+
+	GDALClose(poTmpDS);
+	poGTiff->Delete(osTmpFilename);
+
+	return eErr;
+}
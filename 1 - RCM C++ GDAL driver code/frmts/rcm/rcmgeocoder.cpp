@@ -0,0 +1,504 @@
+#include "cpl_string.h"
+#include "cpl_worker_thread_pool.h"
+#include "gdal_priv.h"
+#include "ogr_spatialref.h"
+#include "rcmdataset.h"
+#include "gdal_io_error.h"
+
+#include <algorithm>
+#include <vector>
+
+/************************************************************************/
+/* ==================================================================== */
+/*                 Range-Doppler backward geocoding                     */
+/* ==================================================================== */
+/************************************************************************/
+/* Every pixel of the output map grid is taken to the ellipsoid with    */
+/* its height, from a DEM or a constant. The zero Doppler time and      */
+/* slant range from the orbit then give its image pixel/line. The       */
+/* calibrated image is resampled there. The output is processed tile by */
+/* tile. The geometry of a tile is computed in parallel, reading and    */
+/* writing stay on the calling thread.                                  */
+/************************************************************************/
+
+/* Source window read for one resampling pass, in tiles of the output */
+static const int RCM_GEOCODE_MAX_WINDOW_TILES = 16;
+
+typedef struct
+{
+	RCMDataset *poDS;
+	const RCMOrbit *poOrbit;
+	int nWidth;
+	int iStartRow;
+	int iEndRow;
+	double dfGuessTime;
+
+	const double *padfLongitude;
+	const double *padfLatitude;
+	const double *padfHeight;
+	double *padfPixel;
+	double *padfLine;
+	bool *pabValid;
+} RCMGeocodeJob;
+
+/************************************************************************/
+/*                         RCMGeocodeRows()                             */
+/************************************************************************/
+
+static void RCMGeocodeRows(void *pData)
+{
+	RCMGeocodeJob *psJob = static_cast<RCMGeocodeJob *>(pData);
+	RCMDataset *poDS = psJob->poDS;
+
+	const double dfA = poDS->GetSemiMajorAxis();
+	const double dfB = poDS->GetSemiMinorAxis();
+
+	for (int iRow = psJob->iStartRow; iRow < psJob->iEndRow; iRow++)
+	{
+		/* Neighbouring pixels have close zero Doppler times */
+		double dfTime = psJob->dfGuessTime;
+
+		for (int i = iRow * psJob->nWidth; i < (iRow + 1) * psJob->nWidth; i++)
+		{
+			psJob->pabValid[i] = false;
+
+			double adfTarget[3];
+			RCMGeodeticToECEF(psJob->padfLongitude[i], psJob->padfLatitude[i],
+				psJob->padfHeight[i], dfA, dfB, adfTarget);
+
+			double dfZeroDopplerTime, dfSlantRange;
+			if (!psJob->poOrbit->ZeroDopplerTime(adfTarget, dfTime,
+				&dfZeroDopplerTime, &dfSlantRange))
+				continue;
+			dfTime = dfZeroDopplerTime;
+
+			psJob->pabValid[i] = poDS->GetImageCoordinates(dfZeroDopplerTime, dfSlantRange,
+				psJob->padfPixel + i, psJob->padfLine + i);
+		}
+	}
+}
+
+/************************************************************************/
+/*                       RCMSampleDEMHeights()                          */
+/************************************************************************/
+/* Bilinear DEM heights of nCount longitude/latitude points. Points     */
+/* outside the DEM or on nodata keep dfDefaultHeight.                   */
+/************************************************************************/
+
+static CPLErr RCMSampleDEMHeights(GDALDataset *poDEM, const double *padfInvGeoTransform,
+	OGRCoordinateTransformation *poDEMTransform, int nCount,
+	const double *padfLongitude, const double *padfLatitude,
+	double dfDefaultHeight, double *padfHeight)
+{
+	std::vector<double> adfX(padfLongitude, padfLongitude + nCount);
+	std::vector<double> adfY(padfLatitude, padfLatitude + nCount);
+	std::vector<int> abTransformed(nCount, TRUE);
+
+	if (poDEMTransform != NULL)
+		poDEMTransform->Transform(nCount, adfX.data(), adfY.data(), NULL, abTransformed.data());
+
+	/* DEM pixel/line with centres at integers, and their bounds */
+	double dfMinX = 1e300, dfMinY = 1e300, dfMaxX = -1e300, dfMaxY = -1e300;
+	for (int i = 0; i < nCount; i++)
+	{
+		padfHeight[i] = dfDefaultHeight;
+		const double dfX = adfX[i], dfY = adfY[i];
+		adfX[i] = padfInvGeoTransform[0] + dfX * padfInvGeoTransform[1] + dfY * padfInvGeoTransform[2] - 0.5;
+		adfY[i] = padfInvGeoTransform[3] + dfX * padfInvGeoTransform[4] + dfY * padfInvGeoTransform[5] - 0.5;
+		if (!abTransformed[i])
+			continue;
+		dfMinX = std::min(dfMinX, adfX[i]);
+		dfMaxX = std::max(dfMaxX, adfX[i]);
+		dfMinY = std::min(dfMinY, adfY[i]);
+		dfMaxY = std::max(dfMaxY, adfY[i]);
+	}
+
+	const int nXOff = std::max(0, static_cast<int>(floor(dfMinX)));
+	const int nYOff = std::max(0, static_cast<int>(floor(dfMinY)));
+	const int nXEnd = std::min(poDEM->GetRasterXSize(), static_cast<int>(floor(dfMaxX)) + 2);
+	const int nYEnd = std::min(poDEM->GetRasterYSize(), static_cast<int>(floor(dfMaxY)) + 2);
+	if (nXEnd <= nXOff || nYEnd <= nYOff)
+		return CE_None;
+
+	const int nXSize = nXEnd - nXOff;
+	const int nYSize = nYEnd - nYOff;
+	std::vector<float> afDEM(static_cast<size_t>(nXSize) * nYSize);
+
+	GDALRasterBand *poBand = poDEM->GetRasterBand(1);
+	if (poBand->RasterIO(GF_Read, nXOff, nYOff, nXSize, nYSize, afDEM.data(),
+		nXSize, nYSize, GDT_Float32, 0, 0, NULL) != CE_None)
+		return CE_Failure;
+
+	int bHasNoData = FALSE;
+	const double dfNoData = poBand->GetNoDataValue(&bHasNoData);
+
+	for (int i = 0; i < nCount; i++)
+	{
+		if (!abTransformed[i])
+			continue;
+
+		const double dfX = std::max(0.0, std::min(adfX[i] - nXOff, nXSize - 1.0));
+		const double dfY = std::max(0.0, std::min(adfY[i] - nYOff, nYSize - 1.0));
+		if (adfX[i] < -0.5 || adfY[i] < -0.5 ||
+			adfX[i] > poDEM->GetRasterXSize() - 0.5 || adfY[i] > poDEM->GetRasterYSize() - 0.5)
+			continue;
+
+		const int nX0 = std::min(static_cast<int>(dfX), std::max(0, nXSize - 2));
+		const int nY0 = std::min(static_cast<int>(dfY), std::max(0, nYSize - 2));
+		const int nX1 = std::min(nX0 + 1, nXSize - 1);
+		const int nY1 = std::min(nY0 + 1, nYSize - 1);
+		const double dfFX = dfX - nX0, dfFY = dfY - nY0;
+
+		const double df00 = afDEM[nY0 * nXSize + nX0], df01 = afDEM[nY0 * nXSize + nX1];
+		const double df10 = afDEM[nY1 * nXSize + nX0], df11 = afDEM[nY1 * nXSize + nX1];
+		if (bHasNoData && (df00 == dfNoData || df01 == dfNoData ||
+			df10 == dfNoData || df11 == dfNoData))
+			continue;
+
+		padfHeight[i] = (1 - dfFY) * ((1 - dfFX) * df00 + dfFX * df01) +
+			dfFY * ((1 - dfFX) * df10 + dfFX * df11);
+	}
+
+	return CE_None;
+}
+
+/************************************************************************/
+/*                        RCMResampleRows()                             */
+/************************************************************************/
+/* Read the source window under rows [iStartRow, iEndRow) of the tile   */
+/* and resample it into pafOut, band sequential. A window larger than   */
+/* nMaxWindow pixels is split in two halves of rows.                    */
+/************************************************************************/
+
+static CPLErr RCMResampleRows(GDALDataset *poSrcDS, int nTileXSize, int nTileYSize,
+	int iStartRow, int iEndRow, const double *padfPixel, const double *padfLine,
+	const bool *pabValid, bool bBilinear, GIntBig nMaxWindow, float *pafOut)
+{
+	const int nSrcXSize = poSrcDS->GetRasterXSize();
+	const int nSrcYSize = poSrcDS->GetRasterYSize();
+	const int nBands = poSrcDS->GetRasterCount();
+
+	double dfMinX = 1e300, dfMinY = 1e300, dfMaxX = -1e300, dfMaxY = -1e300;
+	for (int i = iStartRow * nTileXSize; i < iEndRow * nTileXSize; i++)
+	{
+		if (!pabValid[i])
+			continue;
+		dfMinX = std::min(dfMinX, padfPixel[i]);
+		dfMaxX = std::max(dfMaxX, padfPixel[i]);
+		dfMinY = std::min(dfMinY, padfLine[i]);
+		dfMaxY = std::max(dfMaxY, padfLine[i]);
+	}
+
+	const int nXOff = std::max(0, static_cast<int>(floor(dfMinX)));
+	const int nYOff = std::max(0, static_cast<int>(floor(dfMinY)));
+	const int nXEnd = std::min(nSrcXSize, static_cast<int>(floor(dfMaxX)) + 2);
+	const int nYEnd = std::min(nSrcYSize, static_cast<int>(floor(dfMaxY)) + 2);
+	if (dfMinX > dfMaxX || nXEnd <= nXOff || nYEnd <= nYOff)
+		return CE_None;
+
+	const int nXSize = nXEnd - nXOff;
+	const int nYSize = nYEnd - nYOff;
+
+	if (static_cast<GIntBig>(nXSize) * nYSize > nMaxWindow && iEndRow - iStartRow > 1)
+	{
+		const int iMiddle = (iStartRow + iEndRow) / 2;
+		if (RCMResampleRows(poSrcDS, nTileXSize, nTileYSize, iStartRow, iMiddle, padfPixel,
+			padfLine, pabValid, bBilinear, nMaxWindow, pafOut) != CE_None)
+			return CE_Failure;
+		return RCMResampleRows(poSrcDS, nTileXSize, nTileYSize, iMiddle, iEndRow, padfPixel,
+			padfLine, pabValid, bBilinear, nMaxWindow, pafOut);
+	}
+
+	float *pafSrc = static_cast<float *>(
+		VSI_MALLOC3_VERBOSE(nXSize, nYSize, sizeof(float) * nBands));
+	if (pafSrc == NULL)
+		return CE_Failure;
+
+	if (poSrcDS->RasterIO(GF_Read, nXOff, nYOff, nXSize, nYSize, pafSrc, nXSize, nYSize,
+		GDT_Float32, nBands, NULL, 0, 0, 0, NULL) != CE_None)
+	{
+		CPLFree(pafSrc);
+		return CE_Failure;
+	}
+
+	const GPtrDiff_t nSrcBandSize = static_cast<GPtrDiff_t>(nXSize) * nYSize;
+	const GPtrDiff_t nOutBandSize = static_cast<GPtrDiff_t>(nTileXSize) * nTileYSize;
+
+	for (int i = iStartRow * nTileXSize; i < iEndRow * nTileXSize; i++)
+	{
+		/* Pixel centres are at integer coordinates */
+		if (!pabValid[i] || padfPixel[i] < -0.5 || padfLine[i] < -0.5 ||
+			padfPixel[i] > nSrcXSize - 0.5 || padfLine[i] > nSrcYSize - 0.5)
+			continue;
+
+		const double dfX = std::max(0.0, std::min(padfPixel[i] - nXOff, nXSize - 1.0));
+		const double dfY = std::max(0.0, std::min(padfLine[i] - nYOff, nYSize - 1.0));
+
+		if (!bBilinear)
+		{
+			const GPtrDiff_t nSrc = static_cast<GPtrDiff_t>(floor(dfY + 0.5)) * nXSize +
+				static_cast<int>(floor(dfX + 0.5));
+			for (int iBand = 0; iBand < nBands; iBand++)
+				pafOut[iBand * nOutBandSize + i] = pafSrc[iBand * nSrcBandSize + nSrc];
+			continue;
+		}
+
+		const int nX0 = std::min(static_cast<int>(dfX), std::max(0, nXSize - 2));
+		const int nY0 = std::min(static_cast<int>(dfY), std::max(0, nYSize - 2));
+		const int nX1 = std::min(nX0 + 1, nXSize - 1);
+		const int nY1 = std::min(nY0 + 1, nYSize - 1);
+		const double dfFX = dfX - nX0, dfFY = dfY - nY0;
+
+		for (int iBand = 0; iBand < nBands; iBand++)
+		{
+			const float *pafBand = pafSrc + iBand * nSrcBandSize;
+			pafOut[iBand * nOutBandSize + i] = static_cast<float>(
+				(1 - dfFY) * ((1 - dfFX) * pafBand[nY0 * nXSize + nX0] + dfFX * pafBand[nY0 * nXSize + nX1]) +
+				dfFY * ((1 - dfFX) * pafBand[nY1 * nXSize + nX0] + dfFX * pafBand[nY1 * nXSize + nX1]));
+		}
+	}
+
+	CPLFree(pafSrc);
+
+	return CE_None;
+}
+
+/************************************************************************/
+/*                       GDALRCMTerrainGeocode()                        */
+/************************************************************************/
+
+/**
+* \brief Range-Doppler terrain geocoding of a calibrated RCM dataset
+*
+* hSrcDS must be a calibrated RCM subdataset (RCM_CALIB:SIGMA0:, ...)
+* in zero Doppler geometry. hDstDS is an already created map grid with a
+* geotransform, a projection (WGS84 geographic if empty) and as many bands
+* as hSrcDS. It receives the calibrated values as Float32.
+*
+* Heights come from the first band of hDEMDS, ellipsoidal and in any
+* projection, or dfConstantHeight where the DEM is NULL, missing or nodata.
+*
+* Options:
+* <ul>
+* <li>TILE_SIZE=n: output tile edge in pixels, 256 by default.</li>
+* <li>NUM_THREADS=n|ALL_CPUS: threads computing the geometry, defaults to
+* the GDAL_NUM_THREADS configuration option, else 1.</li>
+* <li>RESAMPLING=BILINEAR|NEAREST: BILINEAR by default.</li>
+* <li>NODATA=value: output value outside the image, 0 by default.</li>
+* </ul>
+*/
+CPLErr CPL_STDCALL GDALRCMTerrainGeocode(GDALDatasetH hSrcDS, GDALDatasetH hDEMDS,
+	double dfConstantHeight, GDALDatasetH hDstDS, char **papszOptions,
+	GDALProgressFunc pfnProgress, void *pProgressData)
+{
+	VALIDATE_POINTER1(hSrcDS, "GDALRCMTerrainGeocode", CE_Failure);
+	VALIDATE_POINTER1(hDstDS, "GDALRCMTerrainGeocode", CE_Failure);
+
+	if (pfnProgress == NULL)
+		pfnProgress = GDALDummyProgress;
+
+	RCMDataset *poSrcDS = dynamic_cast<RCMDataset *>(static_cast<GDALDataset *>(hSrcDS));
+	GDALDataset *poDstDS = static_cast<GDALDataset *>(hDstDS);
+	GDALDataset *poDEM = static_cast<GDALDataset *>(hDEMDS);
+
+	/* -------------------------------------------------------------------- */
+	/*      Check the inputs.                                               */
+	/* -------------------------------------------------------------------- */
+	if (poSrcDS == NULL || poSrcDS->GetRasterCount() == 0 ||
+		dynamic_cast<RCMCalibRasterBand *>(poSrcDS->GetRasterBand(1)) == NULL)
+	{
+		const char msgError[] = "ERROR: Terrain geocoding needs a calibrated RCM subdataset (RCM_CALIB:...).";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+		return CE_Failure;
+	}
+
+	if (!poSrcDS->GetOrbit()->IsValid() || !poSrcDS->HasLineTimes() || !poSrcDS->HasSlantRange())
+	{
+		const char msgError[] = "ERROR: The RCM product lacks the orbit, zero Doppler times or slant range information needed for terrain geocoding.";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_NotSupported, "%s", msgError);
+		return CE_Failure;
+	}
+
+	const int nBands = poSrcDS->GetRasterCount();
+	double adfDstGeoTransform[6];
+	if (poDstDS->GetRasterCount() != nBands ||
+		poDstDS->GetGeoTransform(adfDstGeoTransform) != CE_None)
+	{
+		const char msgError[] = "ERROR: The output dataset needs a geotransform and one band per input band.";
+		write_to_file_error(msgError, "");
+
+		CPLError(CE_Failure, CPLE_IllegalArg, "%s", msgError);
+		return CE_Failure;
+	}
+
+	const int nTileSize = std::max(16, atoi(CSLFetchNameValueDef(papszOptions, "TILE_SIZE", "256")));
+	const bool bBilinear = !EQUAL(CSLFetchNameValueDef(papszOptions, "RESAMPLING", "BILINEAR"), "NEAREST");
+	const float fNoData = static_cast<float>(CPLAtof(CSLFetchNameValueDef(papszOptions, "NODATA", "0")));
+
+	int nThreads = RCMGetThreadCount(papszOptions);
+
+	/* -------------------------------------------------------------------- */
+	/*      Map grid to longitude/latitude, and to the DEM.                 */
+	/* -------------------------------------------------------------------- */
+	OGRSpatialReference oLL;
+	oLL.SetWellKnownGeogCS("WGS84");
+
+	OGRCoordinateTransformation *poDstTransform = NULL;
+	const char *pszDstWKT = poDstDS->GetProjectionRef();
+	if (pszDstWKT != NULL && pszDstWKT[0] != '\0')
+	{
+		OGRSpatialReference oDstSRS;
+		if (oDstSRS.SetFromUserInput(pszDstWKT) != OGRERR_NONE)
+			return CE_Failure;
+		if (!oDstSRS.IsSame(&oLL))
+		{
+			poDstTransform = OGRCreateCoordinateTransformation(&oDstSRS, &oLL);
+			if (poDstTransform == NULL)
+				return CE_Failure;
+		}
+	}
+
+	double adfDEMInvGeoTransform[6];
+	OGRCoordinateTransformation *poDEMTransform = NULL;
+	if (poDEM != NULL)
+	{
+		double adfDEMGeoTransform[6];
+		if (poDEM->GetRasterCount() == 0 ||
+			poDEM->GetGeoTransform(adfDEMGeoTransform) != CE_None ||
+			!GDALInvGeoTransform(adfDEMGeoTransform, adfDEMInvGeoTransform))
+		{
+			delete poDstTransform;
+			CPLError(CE_Failure, CPLE_IllegalArg, "The DEM needs a band and an invertible geotransform.");
+			return CE_Failure;
+		}
+
+		const char *pszDEMWKT = poDEM->GetProjectionRef();
+		if (pszDEMWKT != NULL && pszDEMWKT[0] != '\0')
+		{
+			OGRSpatialReference oDEMSRS;
+			if (oDEMSRS.SetFromUserInput(pszDEMWKT) == OGRERR_NONE && !oDEMSRS.IsSame(&oLL))
+				poDEMTransform = OGRCreateCoordinateTransformation(&oLL, &oDEMSRS);
+		}
+	}
+
+	CPLWorkerThreadPool oPool;
+	if (nThreads > 1 && !oPool.Setup(nThreads, NULL, NULL))
+		nThreads = 1;
+
+	/* -------------------------------------------------------------------- */
+	/*      Process the output tile by tile.                                */
+	/* -------------------------------------------------------------------- */
+	const int nDstXSize = poDstDS->GetRasterXSize();
+	const int nDstYSize = poDstDS->GetRasterYSize();
+	const int nTilesX = (nDstXSize + nTileSize - 1) / nTileSize;
+	const int nTilesY = (nDstYSize + nTileSize - 1) / nTileSize;
+	const size_t nTileArea = static_cast<size_t>(nTileSize) * nTileSize;
+
+	std::vector<double> adfLongitude(nTileArea), adfLatitude(nTileArea), adfHeight(nTileArea);
+	std::vector<double> adfPixel(nTileArea), adfLine(nTileArea);
+	std::vector<int> abTransformed(nTileArea);
+	bool *pabValid = new bool[nTileArea];
+	std::vector<float> afOut(nTileArea * nBands);
+	std::vector<RCMGeocodeJob> asJobs(nThreads);
+
+	/* Scene centre time as the first guess of each tile */
+	const double dfGuessTime = poSrcDS->GetLineAzimuthTime(poSrcDS->GetRasterYSize() / 2.0);
+
+	CPLErr eErr = CE_None;
+
+	for (int iTileY = 0; iTileY < nTilesY && eErr == CE_None; iTileY++)
+	{
+		for (int iTileX = 0; iTileX < nTilesX && eErr == CE_None; iTileX++)
+		{
+			const int nXOff = iTileX * nTileSize;
+			const int nYOff = iTileY * nTileSize;
+			const int nXSize = std::min(nTileSize, nDstXSize - nXOff);
+			const int nYSize = std::min(nTileSize, nDstYSize - nYOff);
+			const int nCount = nXSize * nYSize;
+
+			/* Map coordinates of the pixel centres */
+			for (int j = 0; j < nYSize; j++)
+			{
+				for (int i = 0; i < nXSize; i++)
+				{
+					const double dfX = nXOff + i + 0.5;
+					const double dfY = nYOff + j + 0.5;
+					adfLongitude[j * nXSize + i] = adfDstGeoTransform[0] +
+						dfX * adfDstGeoTransform[1] + dfY * adfDstGeoTransform[2];
+					adfLatitude[j * nXSize + i] = adfDstGeoTransform[3] +
+						dfX * adfDstGeoTransform[4] + dfY * adfDstGeoTransform[5];
+					abTransformed[j * nXSize + i] = TRUE;
+				}
+			}
+
+			if (poDstTransform != NULL)
+				poDstTransform->Transform(nCount, adfLongitude.data(), adfLatitude.data(),
+					NULL, abTransformed.data());
+
+			for (int i = 0; i < nCount; i++)
+				adfHeight[i] = dfConstantHeight;
+
+			if (poDEM != NULL)
+				eErr = RCMSampleDEMHeights(poDEM, adfDEMInvGeoTransform, poDEMTransform, nCount,
+					adfLongitude.data(), adfLatitude.data(), dfConstantHeight, adfHeight.data());
+			if (eErr != CE_None)
+				break;
+
+			/* Image coordinates, rows shared between the threads */
+			for (int iJob = 0; iJob < nThreads; iJob++)
+			{
+				RCMGeocodeJob &sJob = asJobs[iJob];
+				sJob.poDS = poSrcDS;
+				sJob.poOrbit = poSrcDS->GetOrbit();
+				sJob.nWidth = nXSize;
+				RCMGetJobRows(nYSize, nThreads, iJob, &sJob.iStartRow, &sJob.iEndRow);
+				sJob.dfGuessTime = dfGuessTime;
+				sJob.padfLongitude = adfLongitude.data();
+				sJob.padfLatitude = adfLatitude.data();
+				sJob.padfHeight = adfHeight.data();
+				sJob.padfPixel = adfPixel.data();
+				sJob.padfLine = adfLine.data();
+				sJob.pabValid = pabValid;
+
+				if (nThreads > 1)
+					oPool.SubmitJob(RCMGeocodeRows, &sJob);
+				else
+					RCMGeocodeRows(&sJob);
+			}
+			if (nThreads > 1)
+				oPool.WaitCompletion();
+
+			for (int i = 0; i < nCount; i++)
+				pabValid[i] = pabValid[i] && abTransformed[i];
+
+			/* Resample and write the tile */
+			std::fill(afOut.begin(), afOut.begin() + static_cast<size_t>(nCount) * nBands, fNoData);
+
+			eErr = RCMResampleRows(poSrcDS, nXSize, nYSize, 0, nYSize, adfPixel.data(),
+				adfLine.data(), pabValid, bBilinear,
+				static_cast<GIntBig>(RCM_GEOCODE_MAX_WINDOW_TILES) * nTileArea, afOut.data());
+
+			if (eErr == CE_None)
+				eErr = poDstDS->RasterIO(GF_Write, nXOff, nYOff, nXSize, nYSize, afOut.data(),
+					nXSize, nYSize, GDT_Float32, nBands, NULL, 0, 0, 0, NULL);
+
+			if (eErr == CE_None &&
+				!pfnProgress((iTileY * nTilesX + iTileX + 1) / static_cast<double>(nTilesX * nTilesY),
+					NULL, pProgressData))
+			{
+				CPLError(CE_Failure, CPLE_UserInterrupt, "User terminated");
+				eErr = CE_Failure;
+			}
+		}
+	}
+
+	delete[] pabValid;
+	delete poDstTransform;
+	delete poDEMTransform;
+
+	return eErr;
+}
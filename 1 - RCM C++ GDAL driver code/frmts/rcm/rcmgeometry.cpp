@@ -0,0 +1,1348 @@
+#include "cpl_conv.h"
+#include "cpl_string.h"
+#include "cpl_time.h"
+#include "rcmgeometry.h"
+
+#include <algorithm>
+#include <climits>
+
+/************************************************************************/
+/*                          RCMParseUTCTime()                           */
+/************************************************************************/
+
+bool RCMParseUTCTime(const char *pszTime, double *pdfSeconds)
+{
+	if (pszTime == NULL)
+		return false;
+
+	int nYear = 0, nMonth = 0, nDay = 0, nHour = 0, nMin = 0, nSec = 0;
+	if (sscanf(pszTime, "%d-%d-%dT%d:%d:%d",
+		&nYear, &nMonth, &nDay, &nHour, &nMin, &nSec) != 6)
+		return false;
+
+	struct tm brokendowntime;
+	memset(&brokendowntime, 0, sizeof(brokendowntime));
+	brokendowntime.tm_year = nYear - 1900;
+	brokendowntime.tm_mon = nMonth - 1;
+	brokendowntime.tm_mday = nDay;
+	brokendowntime.tm_hour = nHour;
+	brokendowntime.tm_min = nMin;
+	brokendowntime.tm_sec = nSec;
+
+	/* The decimal part of the seconds is optional */
+	const char *pszFraction = strchr(pszTime, '.');
+	const double dfFraction = (pszFraction != NULL) ? CPLAtof(pszFraction) : 0.0;
+
+	*pdfSeconds = static_cast<double>(CPLYMDHMSToUnixTime(&brokendowntime)) + dfFraction;
+	return true;
+}
+
+/************************************************************************/
+/*                         RCMGeodeticToECEF()                          */
+/************************************************************************/
+
+void RCMGeodeticToECEF(double dfLongitude, double dfLatitude, double dfHeight,
+	double dfSemiMajorAxis, double dfSemiMinorAxis, double *padfXYZ)
+{
+	const double dfE2 = 1.0 - (dfSemiMinorAxis * dfSemiMinorAxis) /
+		(dfSemiMajorAxis * dfSemiMajorAxis);
+	const double dfLon = dfLongitude * M_PI / 180.0;
+	const double dfLat = dfLatitude * M_PI / 180.0;
+	const double dfSinLat = sin(dfLat);
+	const double dfCosLat = cos(dfLat);
+	const double dfN = dfSemiMajorAxis / sqrt(1.0 - dfE2 * dfSinLat * dfSinLat);
+
+	padfXYZ[0] = (dfN + dfHeight) * dfCosLat * cos(dfLon);
+	padfXYZ[1] = (dfN + dfHeight) * dfCosLat * sin(dfLon);
+	padfXYZ[2] = (dfN * (1.0 - dfE2) + dfHeight) * dfSinLat;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                               RCMOrbit                               */
+/* ==================================================================== */
+/************************************************************************/
+
+RCMOrbit::RCMOrbit()
+{
+}
+
+/************************************************************************/
+/*                            Initialize()                              */
+/************************************************************************/
+
+bool RCMOrbit::Initialize(CPLXMLNode *psProduct)
+{
+	m_adfTime.clear();
+	m_adfPosition.clear();
+	m_adfVelocity.clear();
+
+	CPLXMLNode *psOrbitInformation = CPLGetXMLNode(psProduct,
+		"=product.sourceAttributes.orbitAndAttitude.orbitInformation");
+	if (psOrbitInformation == NULL)
+		return false;
+
+	/* Collect the state vectors along with their index, to sort them by time */
+	std::vector<std::pair<double, int> > aoOrder;
+	std::vector<double> adfPosition;
+	std::vector<double> adfVelocity;
+
+	for (CPLXMLNode *psNode = psOrbitInformation->psChild; psNode != NULL;
+		psNode = psNode->psNext)
+	{
+		if (psNode->eType != CXT_Element || !EQUAL(psNode->pszValue, "stateVector"))
+			continue;
+
+		double dfTime;
+		if (!RCMParseUTCTime(CPLGetXMLValue(psNode, "timeStamp", NULL), &dfTime))
+			continue;
+
+		aoOrder.push_back(std::make_pair(dfTime, static_cast<int>(aoOrder.size())));
+		adfPosition.push_back(CPLAtof(CPLGetXMLValue(psNode, "xPosition", "0")));
+		adfPosition.push_back(CPLAtof(CPLGetXMLValue(psNode, "yPosition", "0")));
+		adfPosition.push_back(CPLAtof(CPLGetXMLValue(psNode, "zPosition", "0")));
+		adfVelocity.push_back(CPLAtof(CPLGetXMLValue(psNode, "xVelocity", "0")));
+		adfVelocity.push_back(CPLAtof(CPLGetXMLValue(psNode, "yVelocity", "0")));
+		adfVelocity.push_back(CPLAtof(CPLGetXMLValue(psNode, "zVelocity", "0")));
+	}
+
+	std::stable_sort(aoOrder.begin(), aoOrder.end());
+
+	for (size_t i = 0; i < aoOrder.size(); i++) {
+		/* Duplicated time stamps would give a zero length interval */
+		if (!m_adfTime.empty() && aoOrder[i].first <= m_adfTime.back())
+			continue;
+
+		const int iSrc = aoOrder[i].second;
+		m_adfTime.push_back(aoOrder[i].first);
+		for (int k = 0; k < 3; k++) {
+			m_adfPosition.push_back(adfPosition[3 * iSrc + k]);
+			m_adfVelocity.push_back(adfVelocity[3 * iSrc + k]);
+		}
+	}
+
+	return IsValid();
+}
+
+/************************************************************************/
+/*                           FindInterval()                             */
+/************************************************************************/
+/* Index i of the interval [t(i), t(i+1)] holding dfTime. nHint is the  */
+/* interval of the previous epoch, which is usually the right one or    */
+/* the next one for sorted epochs.                                      */
+/************************************************************************/
+
+int RCMOrbit::FindInterval(double dfTime, int nHint) const
+{
+	const int nLast = static_cast<int>(m_adfTime.size()) - 2;
+
+	if (nHint >= 0 && nHint <= nLast) {
+		if (dfTime >= m_adfTime[nHint] && dfTime <= m_adfTime[nHint + 1])
+			return nHint;
+		if (nHint < nLast && dfTime >= m_adfTime[nHint + 1] && dfTime <= m_adfTime[nHint + 2])
+			return nHint + 1;
+	}
+
+	const int nIndex = static_cast<int>(
+		std::upper_bound(m_adfTime.begin(), m_adfTime.end(), dfTime) - m_adfTime.begin()) - 1;
+
+	return std::max(0, std::min(nIndex, nLast));
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+void RCMOrbit::Evaluate(int nCount, const double *padfTime,
+	double *padfPosition, double *padfVelocity) const
+{
+	const int nVectors = GetStateVectorCount();
+	if (nVectors == 0)
+		return;
+
+	const double *padfP = &m_adfPosition[0];
+	const double *padfV = &m_adfVelocity[0];
+	int nInterval = 0;
+
+	for (int n = 0; n < nCount; n++) {
+		const double dfTime = padfTime[n];
+
+		/* Out of the state vectors: clamp to the first or last one */
+		int iClamp = -1;
+		if (nVectors == 1 || dfTime <= m_adfTime[0])
+			iClamp = 0;
+		else if (dfTime >= m_adfTime[nVectors - 1])
+			iClamp = nVectors - 1;
+
+		if (iClamp >= 0) {
+			for (int k = 0; k < 3; k++) {
+				if (padfPosition != NULL)
+					padfPosition[3 * n + k] = padfP[3 * iClamp + k];
+				if (padfVelocity != NULL)
+					padfVelocity[3 * n + k] = padfV[3 * iClamp + k];
+			}
+			continue;
+		}
+
+		nInterval = FindInterval(dfTime, nInterval);
+
+		const double dfH = m_adfTime[nInterval + 1] - m_adfTime[nInterval];
+		const double s = (dfTime - m_adfTime[nInterval]) / dfH;
+		const double s2 = s * s;
+		const double s3 = s2 * s;
+
+		/* Hermite basis and its derivative with respect to s */
+		const double h00 = 2 * s3 - 3 * s2 + 1;
+		const double h10 = s3 - 2 * s2 + s;
+		const double h01 = -2 * s3 + 3 * s2;
+		const double h11 = s3 - s2;
+		const double d00 = 6 * s2 - 6 * s;
+		const double d10 = 3 * s2 - 4 * s + 1;
+		const double d01 = -6 * s2 + 6 * s;
+		const double d11 = 3 * s2 - 2 * s;
+
+		const double *p0 = padfP + 3 * nInterval;
+		const double *p1 = p0 + 3;
+		const double *v0 = padfV + 3 * nInterval;
+		const double *v1 = v0 + 3;
+
+		for (int k = 0; k < 3; k++) {
+			if (padfPosition != NULL)
+				padfPosition[3 * n + k] = h00 * p0[k] + h10 * dfH * v0[k] + h01 * p1[k] + h11 * dfH * v1[k];
+			if (padfVelocity != NULL)
+				padfVelocity[3 * n + k] = (d00 * p0[k] + d01 * p1[k]) / dfH + d10 * v0[k] + d11 * v1[k];
+		}
+	}
+}
+
+/************************************************************************/
+/*                          ZeroDopplerTime()                           */
+/************************************************************************/
+
+bool RCMOrbit::ZeroDopplerTime(const double *padfTarget, double dfGuess,
+	double *pdfTime, double *pdfSlantRange) const
+{
+	if (GetStateVectorCount() < 2)
+		return false;
+
+	/* Earth gravitational constant, for the two body acceleration */
+	const double dfGM = 3.986004418e14;
+
+	double dfTime = dfGuess;
+	for (int iIter = 0; iIter < 20; iIter++) {
+		double adfPos[3], adfVel[3];
+		Evaluate(1, &dfTime, adfPos, adfVel);
+
+		const double dfR = sqrt(adfPos[0] * adfPos[0] + adfPos[1] * adfPos[1] + adfPos[2] * adfPos[2]);
+		double dfF = 0.0, dfV2 = 0.0, dfDA = 0.0;
+		for (int k = 0; k < 3; k++) {
+			const double dfD = padfTarget[k] - adfPos[k];
+			dfF += dfD * adfVel[k];
+			dfV2 += adfVel[k] * adfVel[k];
+			dfDA += dfD * (-dfGM * adfPos[k] / (dfR * dfR * dfR));
+		}
+
+		/* Newton step on f(t) = (target - S(t)).V(t) */
+		const double dfDerivative = dfDA - dfV2;
+		if (dfDerivative == 0.0)
+			return false;
+		const double dfStep = -dfF / dfDerivative;
+		dfTime += dfStep;
+
+		if (dfTime < GetFirstTime() || dfTime > GetLastTime())
+			return false;
+
+		if (fabs(dfStep) < 1e-9) {
+			Evaluate(1, &dfTime, adfPos, NULL);
+			double dfRange2 = 0.0;
+			for (int k = 0; k < 3; k++)
+				dfRange2 += (padfTarget[k] - adfPos[k]) * (padfTarget[k] - adfPos[k]);
+			*pdfTime = dfTime;
+			*pdfSlantRange = sqrt(dfRange2);
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/************************************************************************/
+/*                        RCMFindXMLElements()                          */
+/************************************************************************/
+/* Collect every element called pszName below psRoot, at any depth.     */
+/************************************************************************/
+
+static void RCMFindXMLElements(CPLXMLNode *psRoot, const char *pszName,
+	std::vector<CPLXMLNode *> &apsNodes)
+{
+	for (CPLXMLNode *psNode = psRoot; psNode != NULL; psNode = psNode->psNext)
+	{
+		if (psNode->eType != CXT_Element)
+			continue;
+
+		if (EQUAL(psNode->pszValue, pszName))
+			apsNodes.push_back(psNode);
+		else
+			RCMFindXMLElements(psNode->psChild, pszName, apsNodes);
+	}
+}
+
+/************************************************************************/
+/*                       RCMParseCoefficients()                         */
+/************************************************************************/
+/* Append the space separated values of pszList to adfRow               */
+/************************************************************************/
+
+static void RCMParseCoefficients(const char *pszList, std::vector<double> &adfRow)
+{
+	char **papszValues = CSLTokenizeString2(pszList, " ", 0);
+	for (int i = 0; papszValues != NULL && papszValues[i] != NULL; i++)
+		adfRow.push_back(CPLAtof(papszValues[i]));
+	CSLDestroy(papszValues);
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             RCMTimeTable                             */
+/* ==================================================================== */
+/************************************************************************/
+
+RCMTimeTable::RCMTimeTable() :
+	m_nWidth(0)
+{
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+void RCMTimeTable::Build(std::vector<std::pair<double, std::vector<double> > > &aoRows)
+{
+	m_adfTime.clear();
+	m_adfValues.clear();
+	m_nWidth = 0;
+
+	std::stable_sort(aoRows.begin(), aoRows.end(),
+		[](const std::pair<double, std::vector<double> > &a,
+		   const std::pair<double, std::vector<double> > &b) { return a.first < b.first; });
+
+	for (size_t i = 0; i < aoRows.size(); i++)
+		m_nWidth = std::max(m_nWidth, static_cast<int>(aoRows[i].second.size()));
+
+	for (size_t i = 0; i < aoRows.size(); i++) {
+		if (!m_adfTime.empty() && aoRows[i].first <= m_adfTime.back())
+			continue;
+
+		m_adfTime.push_back(aoRows[i].first);
+		std::vector<double> &adfRow = aoRows[i].second;
+		adfRow.resize(m_nWidth, 0.0);
+		m_adfValues.insert(m_adfValues.end(), adfRow.begin(), adfRow.end());
+	}
+}
+
+/************************************************************************/
+/*                            Interpolate()                             */
+/************************************************************************/
+
+void RCMTimeTable::Interpolate(double dfTime, double *padfRow) const
+{
+	const int nRows = GetRowCount();
+
+	if (nRows == 1 || dfTime <= m_adfTime[0]) {
+		memcpy(padfRow, GetRow(0), sizeof(double) * m_nWidth);
+		return;
+	}
+	if (dfTime >= m_adfTime[nRows - 1]) {
+		memcpy(padfRow, GetRow(nRows - 1), sizeof(double) * m_nWidth);
+		return;
+	}
+
+	const int i = static_cast<int>(
+		std::upper_bound(m_adfTime.begin(), m_adfTime.end(), dfTime) - m_adfTime.begin()) - 1;
+	const double dfWeight = (dfTime - m_adfTime[i]) / (m_adfTime[i + 1] - m_adfTime[i]);
+	const double *padfRow0 = GetRow(i);
+	const double *padfRow1 = GetRow(i + 1);
+
+	for (int k = 0; k < m_nWidth; k++)
+		padfRow[k] = padfRow0[k] + dfWeight * (padfRow1[k] - padfRow0[k]);
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          RCMDopplerCentroid                          */
+/* ==================================================================== */
+/************************************************************************/
+
+RCMDopplerCentroid::RCMDopplerCentroid()
+{
+}
+
+/************************************************************************/
+/*                            Initialize()                              */
+/************************************************************************/
+
+bool RCMDopplerCentroid::Initialize(CPLXMLNode *psProduct)
+{
+	std::vector<CPLXMLNode *> apsEstimates;
+	RCMFindXMLElements(CPLGetXMLNode(psProduct, "=product"), "dopplerCentroidEstimate", apsEstimates);
+
+	std::vector<std::pair<double, std::vector<double> > > aoRows;
+	for (size_t i = 0; i < apsEstimates.size(); i++) {
+		double dfTime;
+		if (!RCMParseUTCTime(CPLGetXMLValue(apsEstimates[i], "timeOfDopplerCentroidEstimate", NULL), &dfTime))
+			continue;
+
+		std::vector<double> adfRow;
+		adfRow.push_back(CPLAtof(CPLGetXMLValue(apsEstimates[i], "dopplerCentroidReferenceTime", "0")));
+		RCMParseCoefficients(CPLGetXMLValue(apsEstimates[i], "dopplerCentroidCoefficients", ""), adfRow);
+
+		aoRows.push_back(std::make_pair(dfTime, adfRow));
+	}
+
+	m_oTable.Build(aoRows);
+
+	return IsValid();
+}
+
+/************************************************************************/
+/*                            EvaluateLine()                            */
+/************************************************************************/
+
+void RCMDopplerCentroid::EvaluateLine(double dfAzimuthTime, int nCount,
+	const double *padfSlantRangeTime, double *padfDoppler) const
+{
+	if (!IsValid())
+		return;
+
+	const int nWidth = m_oTable.GetWidth();
+	std::vector<double> adfRow(nWidth);
+	m_oTable.Interpolate(dfAzimuthTime, &adfRow[0]);
+
+	const double dfReferenceTime = adfRow[0];
+	const double *padfCoefficients = adfRow.data() + 1;
+	const int nCoefficients = nWidth - 1;
+
+	for (int i = 0; i < nCount; i++)
+		padfDoppler[i] = RCMHorner(padfCoefficients, nCoefficients,
+			padfSlantRangeTime[i] - dfReferenceTime);
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+void RCMDopplerCentroid::Evaluate(int nCount, const double *padfAzimuthTime,
+	const double *padfSlantRangeTime, double *padfDoppler) const
+{
+	if (!IsValid())
+		return;
+
+	const int nWidth = m_oTable.GetWidth();
+	std::vector<double> adfRow(nWidth);
+
+	for (int i = 0; i < nCount; i++) {
+		/* Points along the same line share the interpolated estimate */
+		if (i == 0 || padfAzimuthTime[i] != padfAzimuthTime[i - 1])
+			m_oTable.Interpolate(padfAzimuthTime[i], &adfRow[0]);
+
+		padfDoppler[i] = RCMHorner(adfRow.data() + 1, nWidth - 1,
+			padfSlantRangeTime[i] - adfRow[0]);
+	}
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            RCMSlantRange                             */
+/* ==================================================================== */
+/************************************************************************/
+
+RCMSlantRange::RCMSlantRange()
+{
+}
+
+/************************************************************************/
+/*                            Initialize()                              */
+/************************************************************************/
+
+bool RCMSlantRange::Initialize(CPLXMLNode *psProduct)
+{
+	std::vector<CPLXMLNode *> apsEntries;
+	RCMFindXMLElements(CPLGetXMLNode(psProduct, "=product"), "slantRangeToGroundRange", apsEntries);
+
+	std::vector<std::pair<double, std::vector<double> > > aoRows;
+	for (size_t i = 0; i < apsEntries.size(); i++) {
+		double dfTime;
+		if (!RCMParseUTCTime(CPLGetXMLValue(apsEntries[i], "zeroDopplerAzimuthTime", NULL), &dfTime))
+			continue;
+
+		std::vector<double> adfRow;
+		adfRow.push_back(CPLAtof(CPLGetXMLValue(apsEntries[i], "slantRangeTimeToFirstRangeSample", "0")));
+		adfRow.push_back(CPLAtof(CPLGetXMLValue(apsEntries[i], "groundRangeOrigin", "0")));
+		RCMParseCoefficients(CPLGetXMLValue(apsEntries[i], "groundToSlantRangeCoefficients", ""), adfRow);
+
+		aoRows.push_back(std::make_pair(dfTime, adfRow));
+	}
+
+	m_oTable.Build(aoRows);
+
+	return IsValid();
+}
+
+/************************************************************************/
+/*                            EvaluateLine()                            */
+/************************************************************************/
+
+void RCMSlantRange::EvaluateLine(double dfAzimuthTime, int nCount,
+	const double *padfGroundRange, double *padfSlantRange) const
+{
+	if (!IsValid() || nCount <= 0)
+		return;
+
+	const int nWidth = m_oTable.GetWidth();
+	std::vector<double> adfRow(nWidth);
+	m_oTable.Interpolate(dfAzimuthTime, &adfRow[0]);
+
+	const double dfGroundRangeOrigin = adfRow[1];
+	const double *padfCoefficients = adfRow.data() + 2;
+	const int nCoefficients = nWidth - 2;
+
+	/* Horner's method run one coefficient at a time over the whole line, */
+	/* so that the inner loops are simple enough for the compiler to      */
+	/* vectorize.                                                         */
+	std::vector<double> adfDelta(nCount);
+	for (int i = 0; i < nCount; i++)
+		adfDelta[i] = padfGroundRange[i] - dfGroundRangeOrigin;
+
+	const double dfLast = nCoefficients > 0 ? padfCoefficients[nCoefficients - 1] : 0.0;
+	for (int i = 0; i < nCount; i++)
+		padfSlantRange[i] = dfLast;
+
+	const double *padfDelta = adfDelta.data();
+	for (int k = nCoefficients - 2; k >= 0; k--) {
+		const double dfCoefficient = padfCoefficients[k];
+		for (int i = 0; i < nCount; i++)
+			padfSlantRange[i] = padfSlantRange[i] * padfDelta[i] + dfCoefficient;
+	}
+}
+
+/************************************************************************/
+/*                              Evaluate()                              */
+/************************************************************************/
+
+void RCMSlantRange::Evaluate(int nCount, const double *padfAzimuthTime,
+	const double *padfGroundRange, double *padfSlantRange) const
+{
+	if (!IsValid())
+		return;
+
+	const int nWidth = m_oTable.GetWidth();
+	std::vector<double> adfRow(nWidth);
+
+	for (int i = 0; i < nCount; i++) {
+		/* Points along the same line share the interpolated entry */
+		if (i == 0 || padfAzimuthTime[i] != padfAzimuthTime[i - 1])
+			m_oTable.Interpolate(padfAzimuthTime[i], &adfRow[0]);
+
+		padfSlantRange[i] = RCMHorner(adfRow.data() + 2, nWidth - 2,
+			padfGroundRange[i] - adfRow[1]);
+	}
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           RCMTiePointGrid                            */
+/* ==================================================================== */
+/************************************************************************/
+
+RCMTiePointGrid::RCMTiePointGrid() :
+	m_bRegularPixel(false),
+	m_bRegularLine(false),
+	m_dfReferenceLongitude(0.0)
+{
+	memset(m_adfInverse, 0, sizeof(m_adfInverse));
+}
+
+/************************************************************************/
+/*                          RCMBuildAxis()                              */
+/************************************************************************/
+/* Sorted distinct values of adfValues, and whether they are evenly     */
+/* spaced.                                                              */
+/************************************************************************/
+
+static const double RCM_TIE_POINT_EPSILON = 1e-3;
+
+static void RCMBuildAxis(std::vector<double> adfValues, std::vector<double> &adfAxis,
+	bool &bRegular)
+{
+	std::sort(adfValues.begin(), adfValues.end());
+
+	adfAxis.clear();
+	for (size_t i = 0; i < adfValues.size(); i++) {
+		if (adfAxis.empty() || adfValues[i] - adfAxis.back() > RCM_TIE_POINT_EPSILON)
+			adfAxis.push_back(adfValues[i]);
+	}
+
+	bRegular = adfAxis.size() >= 2;
+	for (size_t i = 2; bRegular && i < adfAxis.size(); i++) {
+		const double dfStep = (adfAxis.back() - adfAxis.front()) / (adfAxis.size() - 1);
+		if (fabs(adfAxis[i] - adfAxis[i - 1] - dfStep) > RCM_TIE_POINT_EPSILON)
+			bRegular = false;
+	}
+}
+
+/************************************************************************/
+/*                          RCMFindAxisIndex()                          */
+/************************************************************************/
+/* Index of the node equal to dfValue, or -1.                           */
+/************************************************************************/
+
+static int RCMFindAxisIndex(const std::vector<double> &adfAxis, double dfValue)
+{
+	const size_t i = std::lower_bound(adfAxis.begin(), adfAxis.end(),
+		dfValue - RCM_TIE_POINT_EPSILON) - adfAxis.begin();
+	if (i < adfAxis.size() && fabs(adfAxis[i] - dfValue) <= RCM_TIE_POINT_EPSILON)
+		return static_cast<int>(i);
+	return -1;
+}
+
+/************************************************************************/
+/*                          RCMFindAxisCell()                           */
+/************************************************************************/
+/* Cell [i, i+1] holding dfValue, clamped to the first or last cell so  */
+/* that points outside the lattice are extrapolated.                    */
+/************************************************************************/
+
+static int RCMFindAxisCell(const std::vector<double> &adfAxis, bool bRegular, double dfValue)
+{
+	const int nLast = static_cast<int>(adfAxis.size()) - 2;
+	int i;
+
+	if (bRegular) {
+		const double dfStep = (adfAxis.back() - adfAxis.front()) / (nLast + 1);
+		const double dfIndex = floor((dfValue - adfAxis.front()) / dfStep);
+		i = dfIndex < 0 ? 0 : dfIndex > nLast ? nLast : static_cast<int>(dfIndex);
+	}
+	else {
+		i = static_cast<int>(std::upper_bound(adfAxis.begin(), adfAxis.end(), dfValue)
+			- adfAxis.begin()) - 1;
+		i = std::max(0, std::min(i, nLast));
+	}
+
+	return i;
+}
+
+/************************************************************************/
+/*                               Build()                                */
+/************************************************************************/
+
+bool RCMTiePointGrid::Build(int nGCPCount, const GDAL_GCP *pasGCPList)
+{
+	m_adfValues.clear();
+
+	std::vector<double> adfPixel(nGCPCount);
+	std::vector<double> adfLine(nGCPCount);
+	for (int i = 0; i < nGCPCount; i++) {
+		adfPixel[i] = pasGCPList[i].dfGCPPixel;
+		adfLine[i] = pasGCPList[i].dfGCPLine;
+	}
+
+	RCMBuildAxis(adfPixel, m_adfPixel, m_bRegularPixel);
+	RCMBuildAxis(adfLine, m_adfLine, m_bRegularLine);
+
+	const int nPixels = GetPixelCount();
+	const int nLines = GetLineCount();
+	if (nPixels < 2 || nLines < 2 || nPixels * nLines != nGCPCount)
+		return false;
+
+	/* Every node must be given by exactly one tie point */
+	std::vector<double> adfValues(3 * nGCPCount);
+	std::vector<bool> abSet(nGCPCount, false);
+	m_dfReferenceLongitude = pasGCPList[0].dfGCPX;
+
+	for (int i = 0; i < nGCPCount; i++) {
+		const int iPixel = RCMFindAxisIndex(m_adfPixel, pasGCPList[i].dfGCPPixel);
+		const int iLine = RCMFindAxisIndex(m_adfLine, pasGCPList[i].dfGCPLine);
+		if (iPixel < 0 || iLine < 0 || abSet[iLine * nPixels + iPixel])
+			return false;
+
+		const int iNode = iLine * nPixels + iPixel;
+		abSet[iNode] = true;
+
+		double dfLongitude = pasGCPList[i].dfGCPX;
+		while (dfLongitude - m_dfReferenceLongitude > 180.0)
+			dfLongitude -= 360.0;
+		while (dfLongitude - m_dfReferenceLongitude < -180.0)
+			dfLongitude += 360.0;
+
+		adfValues[3 * iNode] = dfLongitude;
+		adfValues[3 * iNode + 1] = pasGCPList[i].dfGCPY;
+		adfValues[3 * iNode + 2] = pasGCPList[i].dfGCPZ;
+	}
+
+	m_adfValues.swap(adfValues);
+
+	/* Affine first guess of the inverse through three corners */
+	const double *padfA = &m_adfValues[0];
+	const double *padfB = &m_adfValues[3 * (nPixels - 1)];
+	const double *padfC = &m_adfValues[3 * (nLines - 1) * nPixels];
+	const double dfDet = (padfB[0] - padfA[0]) * (padfC[1] - padfA[1]) -
+		(padfC[0] - padfA[0]) * (padfB[1] - padfA[1]);
+	if (dfDet == 0.0) {
+		m_adfValues.clear();
+		return false;
+	}
+
+	/* [lon - lonA, lat - latA] -> [pixel, line] */
+	const double dfPixelSpan = m_adfPixel.back() - m_adfPixel.front();
+	const double dfLineSpan = m_adfLine.back() - m_adfLine.front();
+	m_adfInverse[0] = m_adfPixel.front();
+	m_adfInverse[1] = dfPixelSpan * (padfC[1] - padfA[1]) / dfDet;
+	m_adfInverse[2] = -dfPixelSpan * (padfC[0] - padfA[0]) / dfDet;
+	m_adfInverse[3] = m_adfLine.front();
+	m_adfInverse[4] = -dfLineSpan * (padfB[1] - padfA[1]) / dfDet;
+	m_adfInverse[5] = dfLineSpan * (padfB[0] - padfA[0]) / dfDet;
+
+	return true;
+}
+
+/************************************************************************/
+/*                            Interpolate()                             */
+/************************************************************************/
+
+void RCMTiePointGrid::Interpolate(double dfPixel, double dfLine, double *padfValue,
+	double *padfDerivPixel, double *padfDerivLine) const
+{
+	const int nPixels = GetPixelCount();
+	const int iPixel = RCMFindAxisCell(m_adfPixel, m_bRegularPixel, dfPixel);
+	const int iLine = RCMFindAxisCell(m_adfLine, m_bRegularLine, dfLine);
+
+	const double dfCellPixel = m_adfPixel[iPixel + 1] - m_adfPixel[iPixel];
+	const double dfCellLine = m_adfLine[iLine + 1] - m_adfLine[iLine];
+	const double dfU = (dfPixel - m_adfPixel[iPixel]) / dfCellPixel;
+	const double dfV = (dfLine - m_adfLine[iLine]) / dfCellLine;
+
+	const double *padf00 = &m_adfValues[3 * (iLine * nPixels + iPixel)];
+	const double *padf01 = padf00 + 3;
+	const double *padf10 = padf00 + 3 * nPixels;
+	const double *padf11 = padf10 + 3;
+
+	for (int k = 0; k < 3; k++) {
+		padfValue[k] = (1 - dfV) * ((1 - dfU) * padf00[k] + dfU * padf01[k]) +
+			dfV * ((1 - dfU) * padf10[k] + dfU * padf11[k]);
+
+		if (padfDerivPixel != NULL)
+			padfDerivPixel[k] = ((1 - dfV) * (padf01[k] - padf00[k]) +
+				dfV * (padf11[k] - padf10[k])) / dfCellPixel;
+		if (padfDerivLine != NULL)
+			padfDerivLine[k] = ((1 - dfU) * (padf10[k] - padf00[k]) +
+				dfU * (padf11[k] - padf01[k])) / dfCellLine;
+	}
+}
+
+/************************************************************************/
+/*                              Forward()                               */
+/************************************************************************/
+
+void RCMTiePointGrid::Forward(int nCount, const double *padfPixel, const double *padfLine,
+	double *padfLongitude, double *padfLatitude, double *padfHeight) const
+{
+	if (!IsValid())
+		return;
+
+	for (int i = 0; i < nCount; i++) {
+		double adfValue[3];
+		Interpolate(padfPixel[i], padfLine[i], adfValue, NULL, NULL);
+
+		double dfLongitude = adfValue[0];
+		if (dfLongitude > 180.0)
+			dfLongitude -= 360.0;
+		else if (dfLongitude < -180.0)
+			dfLongitude += 360.0;
+
+		padfLongitude[i] = dfLongitude;
+		padfLatitude[i] = adfValue[1];
+		if (padfHeight != NULL)
+			padfHeight[i] = adfValue[2];
+	}
+}
+
+/************************************************************************/
+/*                              Inverse()                               */
+/************************************************************************/
+
+int RCMTiePointGrid::Inverse(int nCount, const double *padfLongitude,
+	const double *padfLatitude, double *padfPixel, double *padfLine, int *pabSuccess) const
+{
+	if (!IsValid())
+		return 0;
+
+	const double *padfOrigin = &m_adfValues[0];
+	int nSuccess = 0;
+
+	for (int i = 0; i < nCount; i++) {
+		double dfLongitude = padfLongitude[i];
+		while (dfLongitude - m_dfReferenceLongitude > 180.0)
+			dfLongitude -= 360.0;
+		while (dfLongitude - m_dfReferenceLongitude < -180.0)
+			dfLongitude += 360.0;
+		const double dfLatitude = padfLatitude[i];
+
+		const double dfDLon = dfLongitude - padfOrigin[0];
+		const double dfDLat = dfLatitude - padfOrigin[1];
+		double dfPixel = m_adfInverse[0] + m_adfInverse[1] * dfDLon + m_adfInverse[2] * dfDLat;
+		double dfLine = m_adfInverse[3] + m_adfInverse[4] * dfDLon + m_adfInverse[5] * dfDLat;
+
+		/* A few Newton steps, the model is bilinear in each cell */
+		bool bConverged = false;
+		for (int iIter = 0; iIter < 20 && !bConverged; iIter++) {
+			double adfValue[3], adfDerivPixel[3], adfDerivLine[3];
+			Interpolate(dfPixel, dfLine, adfValue, adfDerivPixel, adfDerivLine);
+
+			const double dfDet = adfDerivPixel[0] * adfDerivLine[1] -
+				adfDerivLine[0] * adfDerivPixel[1];
+			if (dfDet == 0.0)
+				break;
+
+			const double dfErrLon = dfLongitude - adfValue[0];
+			const double dfErrLat = dfLatitude - adfValue[1];
+			const double dfStepPixel = (adfDerivLine[1] * dfErrLon - adfDerivLine[0] * dfErrLat) / dfDet;
+			const double dfStepLine = (adfDerivPixel[0] * dfErrLat - adfDerivPixel[1] * dfErrLon) / dfDet;
+
+			dfPixel += dfStepPixel;
+			dfLine += dfStepLine;
+
+			bConverged = fabs(dfStepPixel) < 1e-4 && fabs(dfStepLine) < 1e-4;
+		}
+
+		padfPixel[i] = dfPixel;
+		padfLine[i] = dfLine;
+		if (pabSuccess != NULL)
+			pabSuccess[i] = bConverged;
+		if (bConverged)
+			nSuccess++;
+	}
+
+	return nSuccess;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             RCMRPCModel                              */
+/* ==================================================================== */
+/************************************************************************/
+
+/* Points evaluated together, small enough for the stack */
+static const int RCM_RPC_CHUNK = 128;
+
+RCMRPCModel::RCMRPCModel() :
+	m_bValid(false),
+	m_dfLineOffset(0.0), m_dfLineScale(1.0),
+	m_dfPixelOffset(0.0), m_dfPixelScale(1.0),
+	m_dfLatitudeOffset(0.0), m_dfLatitudeScale(1.0),
+	m_dfLongitudeOffset(0.0), m_dfLongitudeScale(1.0),
+	m_dfHeightOffset(0.0), m_dfHeightScale(1.0)
+{
+	memset(m_adfLineNum, 0, sizeof(m_adfLineNum));
+	memset(m_adfLineDen, 0, sizeof(m_adfLineDen));
+	memset(m_adfPixelNum, 0, sizeof(m_adfPixelNum));
+	memset(m_adfPixelDen, 0, sizeof(m_adfPixelDen));
+}
+
+/************************************************************************/
+/*                         RCMParseRPCItem()                            */
+/************************************************************************/
+
+static bool RCMParseRPCItem(char **papszRPC, const char *pszName, double *pdfValue)
+{
+	const char *pszValue = CSLFetchNameValue(papszRPC, pszName);
+	if (pszValue == NULL)
+		return false;
+	*pdfValue = CPLAtof(pszValue);
+	return true;
+}
+
+static bool RCMParseRPCCoefficients(char **papszRPC, const char *pszName, double *padfValues)
+{
+	std::vector<double> adfValues;
+	RCMParseCoefficients(CSLFetchNameValue(papszRPC, pszName), adfValues);
+	if (adfValues.size() != 20)
+		return false;
+	std::copy(adfValues.begin(), adfValues.end(), padfValues);
+	return true;
+}
+
+/************************************************************************/
+/*                            Initialize()                              */
+/************************************************************************/
+
+bool RCMRPCModel::Initialize(char **papszRPC)
+{
+	m_bValid =
+		RCMParseRPCItem(papszRPC, "LINE_OFF", &m_dfLineOffset) &&
+		RCMParseRPCItem(papszRPC, "LINE_SCALE", &m_dfLineScale) &&
+		RCMParseRPCItem(papszRPC, "SAMP_OFF", &m_dfPixelOffset) &&
+		RCMParseRPCItem(papszRPC, "SAMP_SCALE", &m_dfPixelScale) &&
+		RCMParseRPCItem(papszRPC, "LAT_OFF", &m_dfLatitudeOffset) &&
+		RCMParseRPCItem(papszRPC, "LAT_SCALE", &m_dfLatitudeScale) &&
+		RCMParseRPCItem(papszRPC, "LONG_OFF", &m_dfLongitudeOffset) &&
+		RCMParseRPCItem(papszRPC, "LONG_SCALE", &m_dfLongitudeScale) &&
+		RCMParseRPCItem(papszRPC, "HEIGHT_OFF", &m_dfHeightOffset) &&
+		RCMParseRPCItem(papszRPC, "HEIGHT_SCALE", &m_dfHeightScale) &&
+		RCMParseRPCCoefficients(papszRPC, "LINE_NUM_COEFF", m_adfLineNum) &&
+		RCMParseRPCCoefficients(papszRPC, "LINE_DEN_COEFF", m_adfLineDen) &&
+		RCMParseRPCCoefficients(papszRPC, "SAMP_NUM_COEFF", m_adfPixelNum) &&
+		RCMParseRPCCoefficients(papszRPC, "SAMP_DEN_COEFF", m_adfPixelDen) &&
+		m_dfLatitudeScale != 0.0 && m_dfLongitudeScale != 0.0 && m_dfHeightScale != 0.0;
+
+	return m_bValid;
+}
+
+/************************************************************************/
+/*                           ForwardChunk()                             */
+/************************************************************************/
+
+void RCMRPCModel::ForwardChunk(int nCount, const double *padfLongitude,
+	const double *padfLatitude, const double *padfHeight, double dfHeight,
+	double *padfPixel, double *padfLine) const
+{
+	/* Terms 1 to 19 of RPC00B, in the order of the GDAL RPC transformer. */
+	/* Term 0 is 1.                                                        */
+	double adfTerms[20][RCM_RPC_CHUNK];
+
+	for (int i = 0; i < nCount; i++) {
+		const double x = (padfLongitude[i] - m_dfLongitudeOffset) / m_dfLongitudeScale;
+		const double y = (padfLatitude[i] - m_dfLatitudeOffset) / m_dfLatitudeScale;
+		const double z = ((padfHeight != NULL ? padfHeight[i] : dfHeight) - m_dfHeightOffset) / m_dfHeightScale;
+
+		adfTerms[1][i] = x;
+		adfTerms[2][i] = y;
+		adfTerms[3][i] = z;
+		adfTerms[4][i] = x * y;
+		adfTerms[5][i] = x * z;
+		adfTerms[6][i] = y * z;
+		adfTerms[7][i] = x * x;
+		adfTerms[8][i] = y * y;
+		adfTerms[9][i] = z * z;
+		adfTerms[10][i] = x * y * z;
+		adfTerms[11][i] = x * x * x;
+		adfTerms[12][i] = x * y * y;
+		adfTerms[13][i] = x * z * z;
+		adfTerms[14][i] = x * x * y;
+		adfTerms[15][i] = y * y * y;
+		adfTerms[16][i] = y * z * z;
+		adfTerms[17][i] = x * x * z;
+		adfTerms[18][i] = y * y * z;
+		adfTerms[19][i] = z * z * z;
+	}
+
+	double adfLineNum[RCM_RPC_CHUNK], adfLineDen[RCM_RPC_CHUNK];
+	double adfPixelNum[RCM_RPC_CHUNK], adfPixelDen[RCM_RPC_CHUNK];
+
+	for (int i = 0; i < nCount; i++) {
+		adfLineNum[i] = m_adfLineNum[0];
+		adfLineDen[i] = m_adfLineDen[0];
+		adfPixelNum[i] = m_adfPixelNum[0];
+		adfPixelDen[i] = m_adfPixelDen[0];
+	}
+
+	/* One term at a time across the chunk */
+	for (int k = 1; k < 20; k++) {
+		const double dfLineNum = m_adfLineNum[k];
+		const double dfLineDen = m_adfLineDen[k];
+		const double dfPixelNum = m_adfPixelNum[k];
+		const double dfPixelDen = m_adfPixelDen[k];
+		const double *padfTerm = adfTerms[k];
+
+		for (int i = 0; i < nCount; i++) {
+			adfLineNum[i] += dfLineNum * padfTerm[i];
+			adfLineDen[i] += dfLineDen * padfTerm[i];
+			adfPixelNum[i] += dfPixelNum * padfTerm[i];
+			adfPixelDen[i] += dfPixelDen * padfTerm[i];
+		}
+	}
+
+	for (int i = 0; i < nCount; i++) {
+		padfLine[i] = adfLineNum[i] / adfLineDen[i] * m_dfLineScale + m_dfLineOffset;
+		padfPixel[i] = adfPixelNum[i] / adfPixelDen[i] * m_dfPixelScale + m_dfPixelOffset;
+	}
+}
+
+/************************************************************************/
+/*                              Forward()                               */
+/************************************************************************/
+
+void RCMRPCModel::Forward(int nCount, const double *padfLongitude,
+	const double *padfLatitude, const double *padfHeight, double dfHeight,
+	double *padfPixel, double *padfLine) const
+{
+	if (!m_bValid)
+		return;
+
+	for (int iStart = 0; iStart < nCount; iStart += RCM_RPC_CHUNK) {
+		const int nChunk = std::min(RCM_RPC_CHUNK, nCount - iStart);
+		ForwardChunk(nChunk, padfLongitude + iStart, padfLatitude + iStart,
+			padfHeight != NULL ? padfHeight + iStart : NULL, dfHeight,
+			padfPixel + iStart, padfLine + iStart);
+	}
+}
+
+/************************************************************************/
+/*                              Inverse()                               */
+/************************************************************************/
+
+int RCMRPCModel::Inverse(int nCount, const double *padfPixel, const double *padfLine,
+	const double *padfHeight, double dfHeight, double *padfLongitude, double *padfLatitude,
+	int *pabSuccess) const
+{
+	if (!m_bValid)
+		return 0;
+
+	/* Finite difference step for the Jacobian, a small fraction of the scene */
+	const double dfStepLon = m_dfLongitudeScale * 1e-4;
+	const double dfStepLat = m_dfLatitudeScale * 1e-4;
+
+	int nSuccess = 0;
+
+	for (int iStart = 0; iStart < nCount; iStart += RCM_RPC_CHUNK) {
+		const int nChunk = std::min(RCM_RPC_CHUNK, nCount - iStart);
+		const double *padfChunkHeight = padfHeight != NULL ? padfHeight + iStart : NULL;
+
+		/* The three evaluations of a Newton step go through ForwardChunk at once */
+		double adfLon[3 * RCM_RPC_CHUNK], adfLat[3 * RCM_RPC_CHUNK], adfZ[3 * RCM_RPC_CHUNK];
+		double adfPixel[3 * RCM_RPC_CHUNK], adfLine[3 * RCM_RPC_CHUNK];
+		double adfX[RCM_RPC_CHUNK], adfY[RCM_RPC_CHUNK];
+		bool abConverged[RCM_RPC_CHUNK];
+
+		for (int i = 0; i < nChunk; i++) {
+			adfX[i] = m_dfLongitudeOffset;
+			adfY[i] = m_dfLatitudeOffset;
+			abConverged[i] = false;
+			const double dfZ = padfChunkHeight != NULL ? padfChunkHeight[i] : dfHeight;
+			adfZ[i] = adfZ[nChunk + i] = adfZ[2 * nChunk + i] = dfZ;
+		}
+
+		/* Copy the inputs, the outputs may alias them */
+		double adfTargetPixel[RCM_RPC_CHUNK], adfTargetLine[RCM_RPC_CHUNK];
+		memcpy(adfTargetPixel, padfPixel + iStart, sizeof(double) * nChunk);
+		memcpy(adfTargetLine, padfLine + iStart, sizeof(double) * nChunk);
+
+		for (int iIter = 0; iIter < 20; iIter++) {
+			for (int i = 0; i < nChunk; i++) {
+				adfLon[i] = adfX[i];
+				adfLat[i] = adfY[i];
+				adfLon[nChunk + i] = adfX[i] + dfStepLon;
+				adfLat[nChunk + i] = adfY[i];
+				adfLon[2 * nChunk + i] = adfX[i];
+				adfLat[2 * nChunk + i] = adfY[i] + dfStepLat;
+			}
+
+			for (int iPart = 0; iPart < 3; iPart++)
+				ForwardChunk(nChunk, adfLon + iPart * nChunk, adfLat + iPart * nChunk,
+					adfZ + iPart * nChunk, 0.0, adfPixel + iPart * nChunk, adfLine + iPart * nChunk);
+
+			bool bAllConverged = true;
+			for (int i = 0; i < nChunk; i++) {
+				if (abConverged[i])
+					continue;
+
+				const double dfPixelLon = (adfPixel[nChunk + i] - adfPixel[i]) / dfStepLon;
+				const double dfLineLon = (adfLine[nChunk + i] - adfLine[i]) / dfStepLon;
+				const double dfPixelLat = (adfPixel[2 * nChunk + i] - adfPixel[i]) / dfStepLat;
+				const double dfLineLat = (adfLine[2 * nChunk + i] - adfLine[i]) / dfStepLat;
+				const double dfDet = dfPixelLon * dfLineLat - dfPixelLat * dfLineLon;
+				if (dfDet == 0.0)
+					continue;
+
+				const double dfErrPixel = adfTargetPixel[i] - adfPixel[i];
+				const double dfErrLine = adfTargetLine[i] - adfLine[i];
+				adfX[i] += (dfLineLat * dfErrPixel - dfPixelLat * dfErrLine) / dfDet;
+				adfY[i] += (dfPixelLon * dfErrLine - dfLineLon * dfErrPixel) / dfDet;
+
+				abConverged[i] = fabs(dfErrPixel) < 1e-4 && fabs(dfErrLine) < 1e-4;
+				bAllConverged = bAllConverged && abConverged[i];
+			}
+
+			if (bAllConverged)
+				break;
+		}
+
+		for (int i = 0; i < nChunk; i++) {
+			padfLongitude[iStart + i] = adfX[i];
+			padfLatitude[iStart + i] = adfY[i];
+			if (pabSuccess != NULL)
+				pabSuccess[iStart + i] = abConverged[i];
+			if (abConverged[i])
+				nSuccess++;
+		}
+	}
+
+	return nSuccess;
+}
+
+/************************************************************************/
+/*                            GroundRange()                             */
+/************************************************************************/
+
+bool RCMSlantRange::GroundRange(double dfAzimuthTime, double dfSlantRange,
+	double *pdfGroundRange) const
+{
+	if (!IsValid() || m_oTable.GetWidth() < 4)
+		return false;
+
+	const int nWidth = m_oTable.GetWidth();
+	std::vector<double> adfRow(nWidth);
+	m_oTable.Interpolate(dfAzimuthTime, &adfRow[0]);
+
+	const double dfOrigin = adfRow[1];
+	const double *padfC = adfRow.data() + 2;
+	const int nC = nWidth - 2;
+	if (padfC[1] == 0.0)
+		return false;
+
+	/* The polynomial is close to linear, start from its linear part */
+	double dfDelta = (dfSlantRange - padfC[0]) / padfC[1];
+	for (int iIter = 0; iIter < 20; iIter++) {
+		double dfValue = 0.0, dfDerivative = 0.0;
+		for (int k = nC - 1; k >= 0; k--) {
+			dfDerivative = dfDerivative * dfDelta + dfValue;
+			dfValue = dfValue * dfDelta + padfC[k];
+		}
+		if (dfDerivative == 0.0)
+			return false;
+
+		const double dfStep = (dfSlantRange - dfValue) / dfDerivative;
+		dfDelta += dfStep;
+		if (fabs(dfStep) < 1e-6) {
+			*pdfGroundRange = dfOrigin + dfDelta;
+			return true;
+		}
+	}
+
+	return false;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             RCMBurstMap                              */
+/* ==================================================================== */
+/************************************************************************/
+
+RCMBurstMap::RCMBurstMap()
+{
+}
+
+/************************************************************************/
+/*                             Initialize()                             */
+/************************************************************************/
+
+bool RCMBurstMap::Initialize(CPLXMLNode *psProduct)
+{
+	m_asBursts.clear();
+	m_anBandStart.clear();
+	m_anBandOffset.clear();
+	m_anBandBursts.clear();
+	m_aosBeams.clear();
+
+	/* Only the first polarization, the bursts are the same for all */
+	static const char *const apszMaps[] = { "slcBurstMap", "grdBurstMap", "mlcBurstMap" };
+	CPLXMLNode *psMap = NULL;
+	bool bSLC = false;
+	for (size_t i = 0; i < CPL_ARRAYSIZE(apszMaps) && psMap == NULL; i++) {
+		std::vector<CPLXMLNode *> apsMaps;
+		RCMFindXMLElements(CPLGetXMLNode(psProduct, "=product"), apszMaps[i], apsMaps);
+		if (!apsMaps.empty()) {
+			psMap = apsMaps[0];
+			bSLC = (i == 0);
+		}
+	}
+	if (psMap == NULL)
+		return false;
+
+	char **papszBeams = CSLTokenizeString2(
+		CPLGetXMLValue(psProduct, "=product.sourceAttributes.radarParameters.beams", ""), " ", 0);
+	for (int i = 0; papszBeams != NULL && papszBeams[i] != NULL; i++)
+		m_aosBeams.push_back(papszBeams[i]);
+	CSLDestroy(papszBeams);
+
+	std::vector<CPLXMLNode *> apsBursts;
+	RCMFindXMLElements(psMap->psChild, "burstAttributes", apsBursts);
+
+	for (size_t i = 0; i < apsBursts.size(); i++) {
+		CPLXMLNode *psBurst = apsBursts[i];
+		RCMBurst sBurst;
+
+		if (bSLC) {
+			const char *pszLine = CPLGetXMLValue(psBurst, "lineOffset", NULL);
+			const char *pszPixel = CPLGetXMLValue(psBurst, "pixelOffset", NULL);
+			const char *pszLines = CPLGetXMLValue(psBurst, "numLines", NULL);
+			const char *pszPixels = CPLGetXMLValue(psBurst, "samplesPerLine", NULL);
+			if (pszLine == NULL || pszPixel == NULL || pszLines == NULL || pszPixels == NULL)
+				continue;
+			sBurst.nFirstLine = atoi(pszLine);
+			sBurst.nFirstPixel = atoi(pszPixel);
+			sBurst.nLastLine = sBurst.nFirstLine + atoi(pszLines) - 1;
+			sBurst.nLastPixel = sBurst.nFirstPixel + atoi(pszPixels) - 1;
+		}
+		else {
+			const char *pszTopLine = CPLGetXMLValue(psBurst, "topLeftLine", NULL);
+			const char *pszTopPixel = CPLGetXMLValue(psBurst, "topLeftPixel", NULL);
+			const char *pszBottomLine = CPLGetXMLValue(psBurst, "bottomRightLine", NULL);
+			const char *pszBottomPixel = CPLGetXMLValue(psBurst, "bottomRightPixel", NULL);
+			if (pszTopLine == NULL || pszTopPixel == NULL || pszBottomLine == NULL || pszBottomPixel == NULL)
+				continue;
+			sBurst.nFirstLine = atoi(pszTopLine);
+			sBurst.nFirstPixel = atoi(pszTopPixel);
+			sBurst.nLastLine = atoi(pszBottomLine);
+			sBurst.nLastPixel = atoi(pszBottomPixel);
+		}
+
+		/* The corners may come in either order */
+		if (sBurst.nFirstLine > sBurst.nLastLine)
+			std::swap(sBurst.nFirstLine, sBurst.nLastLine);
+		if (sBurst.nFirstPixel > sBurst.nLastPixel)
+			std::swap(sBurst.nFirstPixel, sBurst.nLastPixel);
+
+		sBurst.nBurst = atoi(CPLGetXMLValue(psBurst, "burst", "0"));
+
+		/* Beams missing from radarParameters are added after the others */
+		const char *pszBeam = CPLGetXMLValue(psBurst, "beam", "");
+		sBurst.nBeam = 0;
+		for (size_t j = 0; j < m_aosBeams.size() && sBurst.nBeam == 0; j++) {
+			if (EQUAL(m_aosBeams[j].c_str(), pszBeam))
+				sBurst.nBeam = static_cast<int>(j) + 1;
+		}
+		if (sBurst.nBeam == 0 && pszBeam[0] != '\0') {
+			m_aosBeams.push_back(pszBeam);
+			sBurst.nBeam = static_cast<int>(m_aosBeams.size());
+		}
+
+		m_asBursts.push_back(sBurst);
+	}
+
+	if (m_asBursts.empty())
+		return false;
+
+	/* Cut the lines where a burst starts or ends */
+	for (size_t i = 0; i < m_asBursts.size(); i++) {
+		m_anBandStart.push_back(m_asBursts[i].nFirstLine);
+		m_anBandStart.push_back(m_asBursts[i].nLastLine + 1);
+	}
+	std::sort(m_anBandStart.begin(), m_anBandStart.end());
+	m_anBandStart.erase(std::unique(m_anBandStart.begin(), m_anBandStart.end()), m_anBandStart.end());
+
+	for (size_t iBand = 0; iBand + 1 < m_anBandStart.size(); iBand++) {
+		m_anBandOffset.push_back(static_cast<int>(m_anBandBursts.size()));
+		for (size_t i = 0; i < m_asBursts.size(); i++) {
+			if (m_asBursts[i].nFirstLine <= m_anBandStart[iBand] &&
+				m_asBursts[i].nLastLine >= m_anBandStart[iBand])
+				m_anBandBursts.push_back(static_cast<int>(i));
+		}
+	}
+	m_anBandOffset.push_back(static_cast<int>(m_anBandBursts.size()));
+
+	return true;
+}
+
+/************************************************************************/
+/*                            GetBeamName()                             */
+/************************************************************************/
+
+const char *RCMBurstMap::GetBeamName(int nBeam) const
+{
+	if (nBeam < 1 || nBeam > GetBeamCount())
+		return NULL;
+
+	return m_aosBeams[nBeam - 1].c_str();
+}
+
+/************************************************************************/
+/*                              FindBand()                              */
+/************************************************************************/
+
+int RCMBurstMap::FindBand(int nLine) const
+{
+	const int iBand = static_cast<int>(std::upper_bound(m_anBandStart.begin(),
+		m_anBandStart.end(), nLine) - m_anBandStart.begin()) - 1;
+
+	if (iBand < 0 || iBand + 1 >= static_cast<int>(m_anBandStart.size()))
+		return -1;
+
+	return iBand;
+}
+
+/************************************************************************/
+/*                             QueryLine()                              */
+/************************************************************************/
+
+void RCMBurstMap::QueryLine(int nLine, int nFirstPixel, int nPixelStep, int nCount,
+	int *panBurst, int *panBeam) const
+{
+	for (int i = 0; i < nCount; i++)
+		panBurst[i] = 0;
+	if (panBeam != NULL) {
+		for (int i = 0; i < nCount; i++)
+			panBeam[i] = 0;
+	}
+
+	const int iBand = FindBand(nLine);
+	if (iBand < 0 || nPixelStep <= 0)
+		return;
+
+	/* Last listed first, so the first listed burst overwrites overlaps */
+	for (int k = m_anBandOffset[iBand + 1] - 1; k >= m_anBandOffset[iBand]; k--) {
+		const RCMBurst &sBurst = m_asBursts[m_anBandBursts[k]];
+
+		int iStart = 0;
+		if (sBurst.nFirstPixel > nFirstPixel)
+			iStart = (sBurst.nFirstPixel - nFirstPixel + nPixelStep - 1) / nPixelStep;
+		if (sBurst.nLastPixel < nFirstPixel)
+			continue;
+		const int iEnd = std::min(nCount - 1, (sBurst.nLastPixel - nFirstPixel) / nPixelStep);
+
+		for (int i = iStart; i <= iEnd; i++)
+			panBurst[i] = sBurst.nBurst;
+		if (panBeam != NULL) {
+			for (int i = iStart; i <= iEnd; i++)
+				panBeam[i] = sBurst.nBeam;
+		}
+	}
+}
+
+/************************************************************************/
+/*                               Query()                                */
+/************************************************************************/
+
+void RCMBurstMap::Query(int nCount, const double *padfPixel, const double *padfLine,
+	int *panBurst, int *panBeam) const
+{
+	int iBand = -1;
+
+	for (int i = 0; i < nCount; i++) {
+		panBurst[i] = 0;
+		if (panBeam != NULL)
+			panBeam[i] = 0;
+
+		const double dfPixel = floor(padfPixel[i] + 0.5);
+		const double dfLine = floor(padfLine[i] + 0.5);
+		if (!(fabs(dfPixel) < INT_MAX) || !(fabs(dfLine) < INT_MAX))
+			continue;
+		const int nPixel = static_cast<int>(dfPixel);
+		const int nLine = static_cast<int>(dfLine);
+
+		/* Points along a line usually stay in the same band */
+		if (iBand < 0 || nLine < m_anBandStart[iBand] || nLine >= m_anBandStart[iBand + 1])
+			iBand = FindBand(nLine);
+		if (iBand < 0)
+			continue;
+
+		for (int k = m_anBandOffset[iBand]; k < m_anBandOffset[iBand + 1]; k++) {
+			const RCMBurst &sBurst = m_asBursts[m_anBandBursts[k]];
+			if (nPixel >= sBurst.nFirstPixel && nPixel <= sBurst.nLastPixel) {
+				panBurst[i] = sBurst.nBurst;
+				if (panBeam != NULL)
+					panBeam[i] = sBurst.nBeam;
+				break;
+			}
+		}
+	}
+}
@@ -0,0 +1,354 @@
+#ifndef GDAL_RCM_GEOMETRY_H_INCLUDED
+#define GDAL_RCM_GEOMETRY_H_INCLUDED
+
+#include "cpl_minixml.h"
+#include "gdal.h"
+
+#include <string>
+#include <utility>
+#include <vector>
+
+/* Speed of light in vacuum, metres per second */
+static const double RCM_SPEED_OF_LIGHT = 299792458.0;
+
+/************************************************************************/
+/*                          RCMParseUTCTime()                           */
+/************************************************************************/
+/* Convert an RCM time stamp "YYYY-MM-DDTHH:MM:SS.ffffffZ" to seconds   */
+/* since 1970-01-01T00:00:00Z. The fractional part is optional.         */
+/************************************************************************/
+
+bool RCMParseUTCTime(const char *pszTime, double *pdfSeconds);
+
+/************************************************************************/
+/*                         RCMGeodeticToECEF()                          */
+/************************************************************************/
+/* Earth centred, earth fixed x,y,z in metres of a longitude, latitude  */
+/* (degrees) and ellipsoidal height (metres) on the given ellipsoid.    */
+/************************************************************************/
+
+void RCMGeodeticToECEF(double dfLongitude, double dfLatitude, double dfHeight,
+	double dfSemiMajorAxis, double dfSemiMinorAxis, double *padfXYZ);
+
+/************************************************************************/
+/* ==================================================================== */
+/*                               RCMOrbit                               */
+/* ==================================================================== */
+/************************************************************************/
+/* Orbit state vectors from                                             */
+/* sourceAttributes.orbitAndAttitude.orbitInformation, parsed once and  */
+/* sorted by time. Position and velocity are interpolated with a cubic  */
+/* Hermite polynomial built from the positions and velocities at both   */
+/* ends of each interval, so the velocity is the derivative of the      */
+/* interpolated position. Times outside the state vectors are clamped   */
+/* to the first or last vector.                                         */
+/************************************************************************/
+
+class RCMOrbit
+{
+	std::vector<double> m_adfTime;      /* seconds since 1970 */
+	std::vector<double> m_adfPosition;  /* x,y,z per state vector, metres */
+	std::vector<double> m_adfVelocity;  /* vx,vy,vz per state vector, metres per second */
+
+	int FindInterval(double dfTime, int nHint) const;
+
+public:
+	RCMOrbit();
+
+	/* Load the state vectors of an RCM product.xml, returns false if there are none */
+	bool Initialize(CPLXMLNode *psProduct);
+
+	bool IsValid() const { return !m_adfTime.empty(); }
+
+	int GetStateVectorCount() const { return static_cast<int>(m_adfTime.size()); }
+
+	double GetFirstTime() const { return m_adfTime.front(); }
+	double GetLastTime() const { return m_adfTime.back(); }
+
+	/* Interpolate nCount epochs. padfPosition and padfVelocity receive */
+	/* x,y,z triplets and either may be NULL. Sorted epochs are faster.  */
+	void Evaluate(int nCount, const double *padfTime,
+		double *padfPosition, double *padfVelocity) const;
+
+	/* Zero Doppler time of an x,y,z target, where the line of sight is  */
+	/* perpendicular to the velocity, and the slant range at that time. */
+	/* dfGuess is the starting time, the previous target's is a good one.*/
+	/* Returns false if the time leaves the state vectors.              */
+	bool ZeroDopplerTime(const double *padfTarget, double dfGuess,
+		double *pdfTime, double *pdfSlantRange) const;
+};
+
+/************************************************************************/
+/*                             RCMHorner()                              */
+/************************************************************************/
+/* Evaluate c[0] + c[1]*x + ... + c[n-1]*x^(n-1)                        */
+/************************************************************************/
+
+inline double RCMHorner(const double *padfCoefficients, int nCoefficients, double dfX)
+{
+	double dfValue = 0.0;
+	for (int i = nCoefficients - 1; i >= 0; i--)
+		dfValue = dfValue * dfX + padfCoefficients[i];
+	return dfValue;
+}
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             RCMTimeTable                             */
+/* ==================================================================== */
+/************************************************************************/
+/* Rows of values tagged with an azimuth time. A row is interpolated    */
+/* linearly in time and clamped to the first or last row, like the      */
+/* interp1d tables of the Python tools. Rows shorter than the widest    */
+/* one are padded with zeros, so polynomials of different orders can    */
+/* share a table.                                                       */
+/************************************************************************/
+
+class RCMTimeTable
+{
+	std::vector<double> m_adfTime;
+	std::vector<double> m_adfValues;   /* GetRowCount() rows of m_nWidth values */
+	int m_nWidth;
+
+public:
+	RCMTimeTable();
+
+	/* Sort the rows by time and keep the first row of duplicated times */
+	void Build(std::vector<std::pair<double, std::vector<double> > > &aoRows);
+
+	bool IsValid() const { return !m_adfTime.empty(); }
+
+	int GetRowCount() const { return static_cast<int>(m_adfTime.size()); }
+	int GetWidth() const { return m_nWidth; }
+	double GetTime(int iRow) const { return m_adfTime[iRow]; }
+	const double *GetRow(int iRow) const { return &m_adfValues[iRow * m_nWidth]; }
+
+	/* padfRow receives GetWidth() values */
+	void Interpolate(double dfTime, double *padfRow) const;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                          RCMDopplerCentroid                          */
+/* ==================================================================== */
+/************************************************************************/
+/* dopplerCentroidEstimate polynomials of product.xml:                  */
+/*   fdc = d0 + d1(tSR - t0) + d2(tSR - t0)^2 + ...                     */
+/* with tSR the two way slant range time and t0 the reference time.     */
+/* t0 and the coefficients are interpolated across the estimate times.  */
+/************************************************************************/
+
+class RCMDopplerCentroid
+{
+	RCMTimeTable m_oTable;   /* t0, d0, d1, ... */
+
+public:
+	RCMDopplerCentroid();
+
+	bool Initialize(CPLXMLNode *psProduct);
+
+	bool IsValid() const { return m_oTable.IsValid(); }
+
+	int GetEstimateCount() const { return m_oTable.GetRowCount(); }
+
+	/* Doppler centroid in Hz of nCount slant range times at one azimuth time */
+	void EvaluateLine(double dfAzimuthTime, int nCount,
+		const double *padfSlantRangeTime, double *padfDoppler) const;
+
+	/* Doppler centroid in Hz of nCount (azimuth time, slant range time) points */
+	void Evaluate(int nCount, const double *padfAzimuthTime,
+		const double *padfSlantRangeTime, double *padfDoppler) const;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                            RCMSlantRange                             */
+/* ==================================================================== */
+/************************************************************************/
+/* slantRangeToGroundRange polynomials of product.xml:                  */
+/*   R = c0 + c1(G - G0) + c2(G - G0)^2 + ...                           */
+/* with G the ground range and G0 the ground range origin, in metres.   */
+/* G0 and the coefficients are interpolated across the azimuth times.   */
+/************************************************************************/
+
+class RCMSlantRange
+{
+	RCMTimeTable m_oTable;   /* slant range time to first sample, G0, c0, c1, ... */
+
+public:
+	RCMSlantRange();
+
+	bool Initialize(CPLXMLNode *psProduct);
+
+	bool IsValid() const { return m_oTable.IsValid(); }
+
+	int GetEntryCount() const { return m_oTable.GetRowCount(); }
+
+	/* Slant range in metres of nCount ground ranges at one azimuth time */
+	void EvaluateLine(double dfAzimuthTime, int nCount,
+		const double *padfGroundRange, double *padfSlantRange) const;
+
+	/* Slant range in metres of nCount (azimuth time, ground range) points */
+	void Evaluate(int nCount, const double *padfAzimuthTime,
+		const double *padfGroundRange, double *padfSlantRange) const;
+
+	/* Ground range of a slant range, inverting the polynomial */
+	bool GroundRange(double dfAzimuthTime, double dfSlantRange,
+		double *pdfGroundRange) const;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                           RCMTiePointGrid                            */
+/* ==================================================================== */
+/************************************************************************/
+/* The geolocationGrid tie points laid out as a lattice of pixel and    */
+/* line values. Pixel/line to longitude/latitude/height is bilinear in  */
+/* the lattice cell, extrapolated linearly outside. Regular axes find   */
+/* the cell in constant time. The inverse starts from an affine guess   */
+/* and refines it with Newton steps on the bilinear model.              */
+/* Longitudes are unwrapped on the lattice, so a scene crossing the     */
+/* antimeridian interpolates correctly, and returned in [-180,180].     */
+/************************************************************************/
+
+class RCMTiePointGrid
+{
+	std::vector<double> m_adfPixel;     /* lattice axes, increasing */
+	std::vector<double> m_adfLine;
+	bool m_bRegularPixel;
+	bool m_bRegularLine;
+	std::vector<double> m_adfValues;    /* lon, lat, height per node, pixel fastest */
+	double m_adfInverse[6];             /* affine lon/lat to pixel/line first guess */
+	double m_dfReferenceLongitude;
+
+	void Interpolate(double dfPixel, double dfLine, double *padfValue,
+		double *padfDerivPixel, double *padfDerivLine) const;
+
+public:
+	RCMTiePointGrid();
+
+	/* Returns false if the GCPs do not form a complete lattice */
+	bool Build(int nGCPCount, const GDAL_GCP *pasGCPList);
+
+	bool IsValid() const { return !m_adfValues.empty(); }
+
+	int GetPixelCount() const { return static_cast<int>(m_adfPixel.size()); }
+	int GetLineCount() const { return static_cast<int>(m_adfLine.size()); }
+
+	/* pixel/line to longitude, latitude and height. padfHeight may be NULL. */
+	void Forward(int nCount, const double *padfPixel, const double *padfLine,
+		double *padfLongitude, double *padfLatitude, double *padfHeight) const;
+
+	/* longitude/latitude to pixel/line, returns the number of converged */
+	/* points. pabSuccess may be NULL.                                    */
+	int Inverse(int nCount, const double *padfLongitude, const double *padfLatitude,
+		double *padfPixel, double *padfLine, int *pabSuccess) const;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             RCMRPCModel                              */
+/* ==================================================================== */
+/************************************************************************/
+/* rationalFunctions of product.xml, parsed once from the RPC metadata  */
+/* domain. The 20 term RPC00B polynomials map longitude, latitude and   */
+/* height to pixel/line, with integer coordinates at pixel centres.     */
+/* Points are evaluated in chunks, one term at a time across the chunk, */
+/* so that the loops vectorize. The inverse runs Newton steps on all    */
+/* the points of a chunk together.                                      */
+/************************************************************************/
+
+class RCMRPCModel
+{
+	bool m_bValid;
+	double m_dfLineOffset, m_dfLineScale;
+	double m_dfPixelOffset, m_dfPixelScale;
+	double m_dfLatitudeOffset, m_dfLatitudeScale;
+	double m_dfLongitudeOffset, m_dfLongitudeScale;
+	double m_dfHeightOffset, m_dfHeightScale;
+	double m_adfLineNum[20], m_adfLineDen[20];
+	double m_adfPixelNum[20], m_adfPixelDen[20];
+
+	void ForwardChunk(int nCount, const double *padfLongitude, const double *padfLatitude,
+		const double *padfHeight, double dfHeight, double *padfPixel, double *padfLine) const;
+
+public:
+	RCMRPCModel();
+
+	/* Parse the LINE_OFF, ..., SAMP_DEN_COEFF items of the RPC domain */
+	bool Initialize(char **papszRPC);
+
+	bool IsValid() const { return m_bValid; }
+
+	double GetHeightOffset() const { return m_dfHeightOffset; }
+
+	/* longitude/latitude/height to pixel/line. padfHeight NULL means   */
+	/* dfHeight everywhere.                                             */
+	void Forward(int nCount, const double *padfLongitude, const double *padfLatitude,
+		const double *padfHeight, double dfHeight, double *padfPixel, double *padfLine) const;
+
+	/* pixel/line/height to longitude/latitude, returns the number of   */
+	/* converged points. pabSuccess may be NULL.                        */
+	int Inverse(int nCount, const double *padfPixel, const double *padfLine,
+		const double *padfHeight, double dfHeight, double *padfLongitude, double *padfLatitude,
+		int *pabSuccess) const;
+};
+
+/************************************************************************/
+/* ==================================================================== */
+/*                             RCMBurstMap                              */
+/* ==================================================================== */
+/************************************************************************/
+/* ScanSAR burst rectangles of the first slcBurstMap, grdBurstMap or    */
+/* mlcBurstMap of product.xml, in full resolution pixel/line. The lines */
+/* are cut into bands crossed by the same bursts. A line finds its band */
+/* by binary search, then its pixels are matched against the few bursts */
+/* of the band. Where bursts overlap the first one listed wins, as in   */
+/* the Python tools.                                                    */
+/************************************************************************/
+
+class RCMBurstMap
+{
+	typedef struct
+	{
+		int nFirstPixel, nLastPixel;
+		int nFirstLine, nLastLine;
+		int nBurst;
+		int nBeam;       /* 1 based index in m_aosBeams */
+	} RCMBurst;
+
+	std::vector<RCMBurst> m_asBursts;
+	std::vector<int> m_anBandStart;     /* first line of each band, plus the end of the last */
+	std::vector<int> m_anBandOffset;    /* first m_anBandBursts entry of each band, plus the end */
+	std::vector<int> m_anBandBursts;    /* m_asBursts indices, in document order per band */
+	std::vector<std::string> m_aosBeams;
+
+	int FindBand(int nLine) const;
+
+public:
+	RCMBurstMap();
+
+	/* Returns false if the product has no burst map */
+	bool Initialize(CPLXMLNode *psProduct);
+
+	bool IsValid() const { return !m_asBursts.empty(); }
+
+	int GetBurstCount() const { return static_cast<int>(m_asBursts.size()); }
+	int GetBeamCount() const { return static_cast<int>(m_aosBeams.size()); }
+
+	/* Name of a 1 based beam index, NULL if out of range */
+	const char *GetBeamName(int nBeam) const;
+
+	/* Burst number and beam index of the pixels nFirstPixel,           */
+	/* nFirstPixel + nPixelStep, ... of a line. 0 outside every burst.  */
+	/* panBeam may be NULL.                                             */
+	void QueryLine(int nLine, int nFirstPixel, int nPixelStep, int nCount,
+		int *panBurst, int *panBeam) const;
+
+	/* Burst number and beam index of nCount pixel/line points, rounded */
+	/* to the nearest pixel. panBeam may be NULL.                       */
+	void Query(int nCount, const double *padfPixel, const double *padfLine,
+		int *panBurst, int *panBeam) const;
+};
+
+#endif /* ndef GDAL_RCM_GEOMETRY_H_INCLUDED */
@@ -0,0 +1,90 @@
+/************************************************************************/
+/*                          rcmhaalpha_bench                            */
+/************************************************************************/
+/* Compares the SSE2 H/A/alpha kernel of RCMComputeHAAlpha() with the   */
+/* scalar RCMComputeHAAlphaScalar() on synthetic T3 matrices: largest   */
+/* difference of each output plane and throughput of both paths. Not    */
+/* part of the driver build; from frmts/rcm of a GDAL source tree:      */
+/*                                                                      */
+/*   g++ -O2 -I../../port rcmhaalpha_bench.cpp rcmpolarimetry.cpp \     */
+/*       -o rcmhaalpha_bench                                            */
+/*   ./rcmhaalpha_bench [pixels] [repetitions]                          */
+/*                                                                      */
+/* On a host without SSE2 both paths are the scalar one.                */
+/************************************************************************/
+
+#include "cpl_port.h"
+#include "rcmpolarimetry.h"
+
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <cstdlib>
+#include <random>
+#include <vector>
+
+typedef void (*RCMHAAlphaFunc)(const double *, size_t, size_t, size_t, double *);
+
+/*** Function to time the best of nRepeat runs of a path, in seconds ***/
+static double TimeHAAlpha(RCMHAAlphaFunc pfnHAAlpha, const std::vector<double> &adfT3,
+	size_t nPlane, int nRepeat, std::vector<double> &adfOut)
+{
+	double dfBest = 0.0;
+	for (int i = 0; i < nRepeat; i++) {
+		const std::chrono::steady_clock::time_point oStart = std::chrono::steady_clock::now();
+		pfnHAAlpha(adfT3.data(), nPlane, 0, nPlane, adfOut.data());
+		const double dfSeconds = std::chrono::duration<double>(
+			std::chrono::steady_clock::now() - oStart).count();
+		if (i == 0 || dfSeconds < dfBest)
+			dfBest = dfSeconds;
+	}
+	return dfBest;
+}
+
+int main(int argc, char **argv)
+{
+	const int nXSize = 1000;
+	const int nYSize = argc > 1 ? std::max(1, atoi(argv[1]) / nXSize) : 1000;
+	const int nRepeat = argc > 2 ? std::max(1, atoi(argv[2])) : 5;
+	const int nLooks = 3;
+	const size_t nPlane = static_cast<size_t>(nXSize) * nYSize;
+
+	/* Quad polarization channels, from pure surface to random volume along each line */
+	const size_t nSamples = 2 * nPlane * nLooks * nLooks;
+	std::vector<float> afHH(nSamples), afHV(nSamples), afVH(nSamples), afVV(nSamples);
+	std::mt19937 oGenerator(4242);
+	std::normal_distribution<float> oNormal(0.0f, 1.0f);
+	const size_t nLine = 2 * static_cast<size_t>(nXSize) * nLooks;
+	for (size_t n = 0; n < nSamples; n += 2) {
+		const float fVolume = static_cast<float>((n % nLine) / 2) / (nLine / 2);
+		const float fSurfaceI = oNormal(oGenerator), fSurfaceQ = oNormal(oGenerator);
+		afHH[n] = fSurfaceI + fVolume * oNormal(oGenerator);
+		afHH[n + 1] = fSurfaceQ + fVolume * oNormal(oGenerator);
+		afVV[n] = fSurfaceI + fVolume * oNormal(oGenerator);
+		afVV[n + 1] = fSurfaceQ + fVolume * oNormal(oGenerator);
+		afHV[n] = afVH[n] = 0.7f * fVolume * oNormal(oGenerator);
+		afHV[n + 1] = afVH[n + 1] = 0.7f * fVolume * oNormal(oGenerator);
+	}
+
+	std::vector<double> adfT3(9 * nPlane);
+	RCMComputeMatrix3(afHH.data(), afHV.data(), afVH.data(), afVV.data(), nXSize, nYSize,
+		nLooks, nLooks, true, adfT3.data());
+
+	std::vector<double> adfScalar(3 * nPlane), adfFast(3 * nPlane);
+	const double dfScalar = TimeHAAlpha(RCMComputeHAAlphaScalar, adfT3, nPlane, nRepeat, adfScalar);
+	const double dfFast = TimeHAAlpha(RCMComputeHAAlpha, adfT3, nPlane, nRepeat, adfFast);
+
+	static const char * const apszPlanes[3] = { "entropy", "anisotropy", "alpha (deg)" };
+	for (int i = 0; i < 3; i++) {
+		double dfMaxDiff = 0.0;
+		for (size_t n = 0; n < nPlane; n++)
+			dfMaxDiff = std::max(dfMaxDiff, fabs(adfFast[i * nPlane + n] - adfScalar[i * nPlane + n]));
+		printf("%-12s max |SSE2 - scalar| = %.3g\n", apszPlanes[i], dfMaxDiff);
+	}
+
+	printf("%lu pixels, best of %d runs\n", static_cast<unsigned long>(nPlane), nRepeat);
+	printf("scalar: %8.2f Mpixel/s\n", nPlane / dfScalar / 1e6);
+	printf("SSE2:   %8.2f Mpixel/s (x%.2f)\n", nPlane / dfFast / 1e6, dfScalar / dfFast);
+	return 0;
+}
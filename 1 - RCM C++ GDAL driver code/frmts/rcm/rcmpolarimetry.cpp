@@ -0,0 +1,709 @@
+#include "cpl_port.h"
+#include "rcmpolarimetry.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define RCM_HAALPHA_SSE2
+#include <emmintrin.h>
+#endif
+
+/************************************************************************/
+/*                          RCMComputeStokes()                          */
+/************************************************************************/
+
+void RCMComputeStokes(const float *pafH, const float *pafV, int nXSize, int nYSize,
+	int nRangeLooks, int nAzimuthLooks, double *padfStokes)
+{
+	const size_t nPlane = static_cast<size_t>(nXSize) * nYSize;
+	const size_t nSrcLine = 2 * static_cast<size_t>(nXSize) * nRangeLooks;
+	const double dfScale = 1.0 / (static_cast<double>(nAzimuthLooks) * nRangeLooks);
+
+	double *padfS0 = padfStokes;
+	double *padfS1 = padfStokes + nPlane;
+	double *padfS2 = padfStokes + 2 * nPlane;
+	double *padfS3 = padfStokes + 3 * nPlane;
+	memset(padfStokes, 0, sizeof(double) * 4 * nPlane);
+
+	for (int i = 0; i < nYSize; i++) {
+		double *padfLineHH = padfS0 + i * static_cast<size_t>(nXSize);
+		double *padfLineVV = padfS1 + i * static_cast<size_t>(nXSize);
+		double *padfLineRe = padfS2 + i * static_cast<size_t>(nXSize);
+		double *padfLineIm = padfS3 + i * static_cast<size_t>(nXSize);
+
+		/* Accumulate <|H|^2>, <|V|^2> and <H V*> line by line */
+		for (int k = 0; k < nAzimuthLooks; k++) {
+			const float *pafLineH = pafH + (static_cast<size_t>(i) * nAzimuthLooks + k) * nSrcLine;
+			const float *pafLineV = pafV + (static_cast<size_t>(i) * nAzimuthLooks + k) * nSrcLine;
+
+			for (int j = 0; j < nXSize; j++) {
+				double dfHH = 0.0, dfVV = 0.0, dfRe = 0.0, dfIm = 0.0;
+				for (int l = 0; l < nRangeLooks; l++) {
+					const size_t n = 2 * (static_cast<size_t>(j) * nRangeLooks + l);
+					const double dfHr = pafLineH[n], dfHi = pafLineH[n + 1];
+					const double dfVr = pafLineV[n], dfVi = pafLineV[n + 1];
+					dfHH += dfHr * dfHr + dfHi * dfHi;
+					dfVV += dfVr * dfVr + dfVi * dfVi;
+					dfRe += dfHr * dfVr + dfHi * dfVi;
+					dfIm += dfHi * dfVr - dfHr * dfVi;
+				}
+				padfLineHH[j] += dfHH;
+				padfLineVV[j] += dfVV;
+				padfLineRe[j] += dfRe;
+				padfLineIm[j] += dfIm;
+			}
+		}
+
+		/* From the averaged covariance to the Stokes vector, in place */
+		for (int j = 0; j < nXSize; j++) {
+			const double dfHH = padfLineHH[j] * dfScale;
+			const double dfVV = padfLineVV[j] * dfScale;
+			padfLineHH[j] = dfHH + dfVV;
+			padfLineVV[j] = dfHH - dfVV;
+			padfLineRe[j] = 2.0 * padfLineRe[j] * dfScale;
+			padfLineIm[j] = -2.0 * padfLineIm[j] * dfScale;
+		}
+	}
+}
+
+/************************************************************************/
+/*                   RCMStokesDegreeOfPolarization()                    */
+/************************************************************************/
+
+double RCMStokesDegreeOfPolarization(double dfS0, double dfS1, double dfS2, double dfS3)
+{
+	if (dfS0 <= 0.0)
+		return 0.0;
+
+	/* Averaging keeps m <= 1, rounding may not */
+	return std::min(1.0, sqrt(dfS1 * dfS1 + dfS2 * dfS2 + dfS3 * dfS3) / dfS0);
+}
+
+/************************************************************************/
+/*                           RCMStokesMChi()                            */
+/************************************************************************/
+
+void RCMStokesMChi(double dfS0, double dfS1, double dfS2, double dfS3,
+	double *pdfDoubleBounce, double *pdfVolume, double *pdfSurface)
+{
+	const double dfM = RCMStokesDegreeOfPolarization(dfS0, dfS1, dfS2, dfS3);
+	const double dfPolarized = dfM * dfS0;
+	const double dfSin2Chi = dfPolarized > 0.0 ?
+		std::max(-1.0, std::min(1.0, -dfS3 / dfPolarized)) : 0.0;
+
+	*pdfDoubleBounce = 0.5 * dfPolarized * (1.0 - dfSin2Chi);
+	*pdfVolume = std::max(0.0, dfS0) * (1.0 - dfM);
+	*pdfSurface = 0.5 * dfPolarized * (1.0 + dfSin2Chi);
+}
+
+/************************************************************************/
+/*                       RCMComputeMatrix3()                            */
+/************************************************************************/
+
+void RCMComputeMatrix3(const float *pafHH, const float *pafHV, const float *pafVH,
+	const float *pafVV, int nXSize, int nYSize, int nRangeLooks, int nAzimuthLooks,
+	bool bCoherency, double *padfMatrix)
+{
+	const size_t nPlane = static_cast<size_t>(nXSize) * nYSize;
+	const size_t nSrcLine = 2 * static_cast<size_t>(nXSize) * nRangeLooks;
+	const double dfScale = 1.0 / (static_cast<double>(nAzimuthLooks) * nRangeLooks);
+	const double dfSqrt2 = sqrt(2.0);
+	const double dfInvSqrt2 = 1.0 / dfSqrt2;
+
+	memset(padfMatrix, 0, sizeof(double) * 9 * nPlane);
+
+	for (int i = 0; i < nYSize; i++) {
+		const size_t nOut = static_cast<size_t>(i) * nXSize;
+
+		for (int k = 0; k < nAzimuthLooks; k++) {
+			const size_t nSrc = (static_cast<size_t>(i) * nAzimuthLooks + k) * nSrcLine;
+			const float *pafLineHH = pafHH + nSrc;
+			const float *pafLineHV = pafHV + nSrc;
+			const float *pafLineVH = pafVH + nSrc;
+			const float *pafLineVV = pafVV + nSrc;
+
+			for (int j = 0; j < nXSize; j++) {
+				double adfSum[9] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+
+				for (int l = 0; l < nRangeLooks; l++) {
+					const size_t n = 2 * (static_cast<size_t>(j) * nRangeLooks + l);
+					const double dfHHr = pafLineHH[n], dfHHi = pafLineHH[n + 1];
+					const double dfVVr = pafLineVV[n], dfVVi = pafLineVV[n + 1];
+					/* Reciprocity: HV and VH are averaged */
+					const double dfXr = 0.5 * (pafLineHV[n] + pafLineVH[n]);
+					const double dfXi = 0.5 * (pafLineHV[n + 1] + pafLineVH[n + 1]);
+
+					/* Lexicographic k = [HH, sqrt2 HV, VV] or          */
+					/* Pauli k = [HH+VV, HH-VV, 2 HV] / sqrt2           */
+					double k1r, k1i, k2r, k2i, k3r, k3i;
+					if (bCoherency) {
+						k1r = (dfHHr + dfVVr) * dfInvSqrt2;
+						k1i = (dfHHi + dfVVi) * dfInvSqrt2;
+						k2r = (dfHHr - dfVVr) * dfInvSqrt2;
+						k2i = (dfHHi - dfVVi) * dfInvSqrt2;
+						k3r = dfXr * dfSqrt2;
+						k3i = dfXi * dfSqrt2;
+					}
+					else {
+						k1r = dfHHr;
+						k1i = dfHHi;
+						k2r = dfXr * dfSqrt2;
+						k2i = dfXi * dfSqrt2;
+						k3r = dfVVr;
+						k3i = dfVVi;
+					}
+
+					/* Upper triangle of k k^H */
+					adfSum[0] += k1r * k1r + k1i * k1i;
+					adfSum[1] += k1r * k2r + k1i * k2i;
+					adfSum[2] += k1i * k2r - k1r * k2i;
+					adfSum[3] += k1r * k3r + k1i * k3i;
+					adfSum[4] += k1i * k3r - k1r * k3i;
+					adfSum[5] += k2r * k2r + k2i * k2i;
+					adfSum[6] += k2r * k3r + k2i * k3i;
+					adfSum[7] += k2i * k3r - k2r * k3i;
+					adfSum[8] += k3r * k3r + k3i * k3i;
+				}
+
+				for (int m = 0; m < 9; m++)
+					padfMatrix[m * nPlane + nOut + j] += adfSum[m];
+			}
+		}
+
+		for (int m = 0; m < 9; m++) {
+			double *padfLine = padfMatrix + m * nPlane + nOut;
+			for (int j = 0; j < nXSize; j++)
+				padfLine[j] *= dfScale;
+		}
+	}
+}
+
+/************************************************************************/
+/*                         Hermitian 3x3 helpers                        */
+/************************************************************************/
+
+/* Bilinear cross product of complex 3-vectors, as re,im pairs */
+static void RCMCross(const double *a, const double *b, double *c)
+{
+	for (int i = 0; i < 3; i++) {
+		const int j = (i + 1) % 3;
+		const int k = (i + 2) % 3;
+		c[2 * i] = a[2 * j] * b[2 * k] - a[2 * j + 1] * b[2 * k + 1]
+			- (a[2 * k] * b[2 * j] - a[2 * k + 1] * b[2 * j + 1]);
+		c[2 * i + 1] = a[2 * j] * b[2 * k + 1] + a[2 * j + 1] * b[2 * k]
+			- (a[2 * k] * b[2 * j + 1] + a[2 * k + 1] * b[2 * j]);
+	}
+}
+
+static double RCMNorm2(const double *v)
+{
+	return v[0] * v[0] + v[1] * v[1] + v[2] * v[2] + v[3] * v[3] + v[4] * v[4] + v[5] * v[5];
+}
+
+/* y = M x for the Hermitian matrix given as its upper triangle */
+static void RCMHermitianProduct(const double *m, const double *x, double *y)
+{
+	/* Full matrix as re,im pairs */
+	const double a[3][3][2] = {
+		{ { m[0], 0.0 }, { m[1], m[2] }, { m[3], m[4] } },
+		{ { m[1], -m[2] }, { m[5], 0.0 }, { m[6], m[7] } },
+		{ { m[3], -m[4] }, { m[6], -m[7] }, { m[8], 0.0 } } };
+
+	for (int i = 0; i < 3; i++) {
+		y[2 * i] = 0.0;
+		y[2 * i + 1] = 0.0;
+		for (int j = 0; j < 3; j++) {
+			y[2 * i] += a[i][j][0] * x[2 * j] - a[i][j][1] * x[2 * j + 1];
+			y[2 * i + 1] += a[i][j][0] * x[2 * j + 1] + a[i][j][1] * x[2 * j];
+		}
+	}
+}
+
+/* <x, y> = x^H y */
+static void RCMInnerProduct(const double *x, const double *y, double *pdfRe, double *pdfIm)
+{
+	*pdfRe = 0.0;
+	*pdfIm = 0.0;
+	for (int i = 0; i < 3; i++) {
+		*pdfRe += x[2 * i] * y[2 * i] + x[2 * i + 1] * y[2 * i + 1];
+		*pdfIm += x[2 * i] * y[2 * i + 1] - x[2 * i + 1] * y[2 * i];
+	}
+}
+
+/************************************************************************/
+/*                      RCMHermitianEigenvalues()                       */
+/************************************************************************/
+
+void RCMHermitianEigenvalues(const double *padfM, double *padfLambda)
+{
+	const double dfT11 = padfM[0], dfT22 = padfM[5], dfT33 = padfM[8];
+	const double dfN12 = padfM[1] * padfM[1] + padfM[2] * padfM[2];
+	const double dfN13 = padfM[3] * padfM[3] + padfM[4] * padfM[4];
+	const double dfN23 = padfM[6] * padfM[6] + padfM[7] * padfM[7];
+
+	/* Shift by the mean eigenvalue, then the trigonometric solution */
+	const double dfMean = (dfT11 + dfT22 + dfT33) / 3.0;
+	const double a = dfT11 - dfMean, b = dfT22 - dfMean, c = dfT33 - dfMean;
+	const double dfP2 = (a * a + b * b + c * c + 2.0 * (dfN12 + dfN13 + dfN23)) / 6.0;
+
+	if (dfP2 <= 0.0) {
+		padfLambda[0] = padfLambda[1] = padfLambda[2] = dfMean;
+		return;
+	}
+
+	/* det(T - mean I) = abc + 2 Re(T12 T23 conj(T13)) - a|T23|^2 - b|T13|^2 - c|T12|^2 */
+	const double dfRe1223 = padfM[1] * padfM[6] - padfM[2] * padfM[7];
+	const double dfIm1223 = padfM[1] * padfM[7] + padfM[2] * padfM[6];
+	const double dfDet = a * b * c + 2.0 * (dfRe1223 * padfM[3] + dfIm1223 * padfM[4])
+		- a * dfN23 - b * dfN13 - c * dfN12;
+
+	const double dfP = sqrt(dfP2);
+	const double dfR = std::max(-1.0, std::min(1.0, dfDet / (2.0 * dfP2 * dfP)));
+	const double dfPhi = acos(dfR) / 3.0;
+	const double dfTwoPiOver3 = 2.0943951023931954923;
+
+	padfLambda[0] = dfMean + 2.0 * dfP * cos(dfPhi);
+	padfLambda[2] = dfMean + 2.0 * dfP * cos(dfPhi + dfTwoPiOver3);
+	padfLambda[1] = 3.0 * dfMean - padfLambda[0] - padfLambda[2];
+}
+
+/************************************************************************/
+/*                        RCMHermitianEigen()                           */
+/************************************************************************/
+/* Eigenvector of the best separated eigenvalue from the cross product  */
+/* of 2 rows of T - lambda I, then the remaining 2x2 problem solved in  */
+/* an orthonormal basis of its complement. This stays accurate with     */
+/* repeated eigenvalues, where the cross products vanish.               */
+/************************************************************************/
+
+void RCMHermitianEigen(const double *padfM, double *padfLambda, double *padfVectors)
+{
+	RCMHermitianEigenvalues(padfM, padfLambda);
+
+	const double dfScale = std::max(fabs(padfLambda[0]), fabs(padfLambda[2]));
+	const bool bFirst = padfLambda[0] - padfLambda[1] >= padfLambda[1] - padfLambda[2];
+	const double dfLambda = bFirst ? padfLambda[0] : padfLambda[2];
+
+	/* Rows of T - lambda I as re,im pairs */
+	const double adfRow0[6] = { padfM[0] - dfLambda, 0.0, padfM[1], padfM[2], padfM[3], padfM[4] };
+	const double adfRow1[6] = { padfM[1], -padfM[2], padfM[5] - dfLambda, 0.0, padfM[6], padfM[7] };
+	const double adfRow2[6] = { padfM[3], -padfM[4], padfM[6], -padfM[7], padfM[8] - dfLambda, 0.0 };
+
+	double adfCross[3][6];
+	RCMCross(adfRow0, adfRow1, adfCross[0]);
+	RCMCross(adfRow0, adfRow2, adfCross[1]);
+	RCMCross(adfRow1, adfRow2, adfCross[2]);
+
+	int iBest = 0;
+	double dfBest = RCMNorm2(adfCross[0]);
+	for (int i = 1; i < 3; i++) {
+		const double dfNorm2 = RCMNorm2(adfCross[i]);
+		if (dfNorm2 > dfBest) {
+			dfBest = dfNorm2;
+			iBest = i;
+		}
+	}
+
+	/* All eigenvalues equal: any basis will do */
+	if (dfBest <= 1e-24 * dfScale * dfScale * dfScale * dfScale || dfBest == 0.0) {
+		memset(padfVectors, 0, sizeof(double) * 18);
+		padfVectors[0] = padfVectors[8] = padfVectors[16] = 1.0;
+		return;
+	}
+
+	double adfV[6];
+	const double dfInvNorm = 1.0 / sqrt(dfBest);
+	for (int i = 0; i < 6; i++)
+		adfV[i] = adfCross[iBest][i] * dfInvNorm;
+
+	/* u: the axis least aligned with v, made orthogonal to it */
+	int iAxis = 0;
+	double dfMin = adfV[0] * adfV[0] + adfV[1] * adfV[1];
+	for (int i = 1; i < 3; i++) {
+		const double dfAxis = adfV[2 * i] * adfV[2 * i] + adfV[2 * i + 1] * adfV[2 * i + 1];
+		if (dfAxis < dfMin) {
+			dfMin = dfAxis;
+			iAxis = i;
+		}
+	}
+
+	double adfU[6] = { 0.0, 0.0, 0.0, 0.0, 0.0, 0.0 };
+	adfU[2 * iAxis] = 1.0;
+	double dfRe, dfIm;
+	RCMInnerProduct(adfV, adfU, &dfRe, &dfIm);
+	for (int i = 0; i < 3; i++) {
+		adfU[2 * i] -= dfRe * adfV[2 * i] - dfIm * adfV[2 * i + 1];
+		adfU[2 * i + 1] -= dfRe * adfV[2 * i + 1] + dfIm * adfV[2 * i];
+	}
+	const double dfInvU = 1.0 / sqrt(RCMNorm2(adfU));
+	for (int i = 0; i < 6; i++)
+		adfU[i] *= dfInvU;
+
+	/* w = conj(v x u) completes the unitary basis */
+	double adfW[6];
+	RCMCross(adfV, adfU, adfW);
+	for (int i = 0; i < 3; i++)
+		adfW[2 * i + 1] = -adfW[2 * i + 1];
+
+	/* The 2x2 Hermitian problem [[a, b], [conj(b), c]] in (u, w) */
+	double adfTu[6], adfTw[6];
+	RCMHermitianProduct(padfM, adfU, adfTu);
+	RCMHermitianProduct(padfM, adfW, adfTw);
+
+	double a, c, dfBRe, dfBIm, dfDummy;
+	RCMInnerProduct(adfU, adfTu, &a, &dfDummy);
+	RCMInnerProduct(adfW, adfTw, &c, &dfDummy);
+	RCMInnerProduct(adfU, adfTw, &dfBRe, &dfBIm);
+
+	const double dfHalfDiff = 0.5 * (a - c);
+	const double dfRadius = sqrt(dfHalfDiff * dfHalfDiff + dfBRe * dfBRe + dfBIm * dfBIm);
+	const double dfLarge = 0.5 * (a + c) + dfRadius;
+	const double dfSmall = 0.5 * (a + c) - dfRadius;
+
+	/* Eigenvector (x1, x2) of the larger 2x2 eigenvalue */
+	double x1r, x1i, x2r, x2i;
+	if (dfRadius == 0.0) {
+		x1r = 1.0; x1i = 0.0; x2r = 0.0; x2i = 0.0;
+	}
+	else if (dfHalfDiff >= 0.0) {
+		/* (lambda - c, conj(b)) */
+		x1r = dfLarge - c; x1i = 0.0; x2r = dfBRe; x2i = -dfBIm;
+	}
+	else {
+		/* (b, lambda - a) */
+		x1r = dfBRe; x1i = dfBIm; x2r = dfLarge - a; x2i = 0.0;
+	}
+	const double dfInvX = 1.0 / sqrt(x1r * x1r + x1i * x1i + x2r * x2r + x2i * x2i);
+	x1r *= dfInvX; x1i *= dfInvX; x2r *= dfInvX; x2i *= dfInvX;
+
+	/* Large = x1 u + x2 w, small = -conj(x2) u + conj(x1) w */
+	double adfLarge[6], adfSmall[6];
+	for (int i = 0; i < 3; i++) {
+		const double ur = adfU[2 * i], ui = adfU[2 * i + 1];
+		const double wr = adfW[2 * i], wi = adfW[2 * i + 1];
+		adfLarge[2 * i] = x1r * ur - x1i * ui + x2r * wr - x2i * wi;
+		adfLarge[2 * i + 1] = x1r * ui + x1i * ur + x2r * wi + x2i * wr;
+		adfSmall[2 * i] = -(x2r * ur + x2i * ui) + x1r * wr + x1i * wi;
+		adfSmall[2 * i + 1] = -(x2r * ui - x2i * ur) + x1r * wi - x1i * wr;
+	}
+
+	/* Descending order */
+	const double *apadfVectors[3];
+	if (bFirst) {
+		padfLambda[1] = dfLarge;
+		padfLambda[2] = dfSmall;
+		apadfVectors[0] = adfV;
+		apadfVectors[1] = adfLarge;
+		apadfVectors[2] = adfSmall;
+	}
+	else {
+		padfLambda[0] = dfLarge;
+		padfLambda[1] = dfSmall;
+		apadfVectors[0] = adfLarge;
+		apadfVectors[1] = adfSmall;
+		apadfVectors[2] = adfV;
+	}
+	for (int i = 0; i < 3; i++)
+		memcpy(padfVectors + 6 * i, apadfVectors[i], sizeof(double) * 6);
+}
+
+/************************************************************************/
+/*                          RCMHAAlphaPixel()                           */
+/************************************************************************/
+
+static void RCMHAAlphaPixel(const double *padfT3, size_t nPlane, size_t n, double *padfHAAlpha)
+{
+	const double dfInvLog3 = 1.0 / log(3.0);
+	const double dfRadToDeg = 180.0 / M_PI;
+
+	double adfM[9];
+	for (int m = 0; m < 9; m++)
+		adfM[m] = padfT3[m * nPlane + n];
+
+	double adfLambda[3], adfVectors[18];
+	RCMHermitianEigen(adfM, adfLambda, adfVectors);
+
+	double dfSum = 0.0;
+	for (int i = 0; i < 3; i++) {
+		adfLambda[i] = std::max(0.0, adfLambda[i]);
+		dfSum += adfLambda[i];
+	}
+
+	double dfEntropy = 0.0, dfAnisotropy = 0.0, dfAlpha = 0.0;
+	if (dfSum > 0.0) {
+		for (int i = 0; i < 3; i++) {
+			const double dfP = adfLambda[i] / dfSum;
+			if (dfP > 0.0)
+				dfEntropy -= dfP * log(dfP) * dfInvLog3;
+
+			/* alpha_i from the surface (HH + VV) component */
+			const double *padfV = adfVectors + 6 * i;
+			const double dfCos = std::min(1.0, sqrt(padfV[0] * padfV[0] + padfV[1] * padfV[1]));
+			dfAlpha += dfP * acos(dfCos) * dfRadToDeg;
+		}
+
+		if (adfLambda[1] + adfLambda[2] > 0.0)
+			dfAnisotropy = (adfLambda[1] - adfLambda[2]) / (adfLambda[1] + adfLambda[2]);
+	}
+
+	padfHAAlpha[n] = std::max(0.0, std::min(1.0, dfEntropy));
+	padfHAAlpha[nPlane + n] = dfAnisotropy;
+	padfHAAlpha[2 * nPlane + n] = dfAlpha;
+}
+
+/************************************************************************/
+/*                      RCMComputeHAAlphaScalar()                       */
+/************************************************************************/
+
+void RCMComputeHAAlphaScalar(const double *padfT3, size_t nPlane, size_t nStart, size_t nEnd,
+	double *padfHAAlpha)
+{
+	for (size_t n = nStart; n < nEnd; n++)
+		RCMHAAlphaPixel(padfT3, nPlane, n, padfHAAlpha);
+}
+
+#ifdef RCM_HAALPHA_SSE2
+
+/************************************************************************/
+/*                      SSE2 elementary functions                       */
+/************************************************************************/
+/* Two pixels per register. Each function is accurate to a few units    */
+/* in the last place over the range the decomposition feeds it, which   */
+/* is far below the Float32 resolution of the output bands.             */
+/************************************************************************/
+
+static inline __m128d RCMSelect(__m128d xmmMask, __m128d xmmTrue, __m128d xmmFalse)
+{
+	return _mm_or_pd(_mm_and_pd(xmmMask, xmmTrue), _mm_andnot_pd(xmmMask, xmmFalse));
+}
+
+/* asin(y) for |y| <= 0.5, Taylor series to y^43 */
+static inline __m128d RCMAsinSmall(__m128d xmmY)
+{
+	static const double adfCoef[22] = {
+		1.0, 0.16666666666666666, 0.075, 0.044642857142857144,
+		0.030381944444444444, 0.022372159090909092, 0.017352764423076924,
+		0.01396484375, 0.011551800896139705, 0.009761609529194078,
+		0.008390335809616815, 0.0073125258735988454, 0.006447210311889649,
+		0.005740037670841924, 0.005153309682319905, 0.004660143486915096,
+		0.004240907093679363, 0.003880964558837669, 0.0035692053938259347,
+		0.003297059503473485, 0.0030578216492580306, 0.002846178401108942 };
+
+	const __m128d xmmY2 = _mm_mul_pd(xmmY, xmmY);
+	__m128d xmmSum = _mm_set1_pd(adfCoef[21]);
+	for (int k = 20; k >= 0; k--)
+		xmmSum = _mm_add_pd(_mm_mul_pd(xmmSum, xmmY2), _mm_set1_pd(adfCoef[k]));
+	return _mm_mul_pd(xmmSum, xmmY);
+}
+
+/* acos(x) for |x| <= 1, from asin(sqrt((1 - |x|) / 2)) above 0.5 */
+static inline __m128d RCMAcos(__m128d xmmX)
+{
+	const __m128d xmmSign = _mm_set1_pd(-0.0);
+	const __m128d xmmHalf = _mm_set1_pd(0.5);
+	const __m128d xmmHalfPi = _mm_set1_pd(M_PI / 2.0);
+
+	const __m128d xmmAbs = _mm_andnot_pd(xmmSign, xmmX);
+	const __m128d xmmLarge = _mm_cmpgt_pd(xmmAbs, xmmHalf);
+	const __m128d xmmY = RCMSelect(xmmLarge,
+		_mm_sqrt_pd(_mm_mul_pd(xmmHalf, _mm_sub_pd(_mm_set1_pd(1.0), xmmAbs))), xmmAbs);
+	const __m128d xmmAsin = RCMAsinSmall(xmmY);
+
+	/* acos(|x|), then pi - acos(|x|) for negative x */
+	const __m128d xmmAcos = RCMSelect(xmmLarge, _mm_add_pd(xmmAsin, xmmAsin),
+		_mm_sub_pd(xmmHalfPi, xmmAsin));
+	const __m128d xmmNegative = _mm_cmplt_pd(xmmX, _mm_setzero_pd());
+	return RCMSelect(xmmNegative, _mm_sub_pd(_mm_set1_pd(M_PI), xmmAcos), xmmAcos);
+}
+
+/* cos(t) and sin(t) for 0 <= t <= pi/3, Taylor series to t^20 and t^19 */
+static inline void RCMCosSin(__m128d xmmT, __m128d *pxmmCos, __m128d *pxmmSin)
+{
+	const __m128d xmmT2 = _mm_mul_pd(xmmT, xmmT);
+	__m128d xmmCos = _mm_set1_pd(1.0);
+	__m128d xmmSin = _mm_set1_pd(1.0);
+	for (int k = 10; k >= 1; k--) {
+		/* 1 - t^2 / ((2k-1) 2k) (...) and 1 - t^2 / (2k (2k+1)) (...) */
+		xmmCos = _mm_sub_pd(_mm_set1_pd(1.0),
+			_mm_mul_pd(_mm_mul_pd(xmmT2, _mm_set1_pd(1.0 / ((2 * k - 1) * (2 * k)))), xmmCos));
+		xmmSin = _mm_sub_pd(_mm_set1_pd(1.0),
+			_mm_mul_pd(_mm_mul_pd(xmmT2, _mm_set1_pd(1.0 / ((2 * k) * (2 * k + 1)))), xmmSin));
+	}
+	*pxmmCos = xmmCos;
+	*pxmmSin = _mm_mul_pd(xmmSin, xmmT);
+}
+
+/* log(x) for normal positive x: exponent, then 2 atanh(s) to s^21 */
+static inline __m128d RCMLog(__m128d xmmX)
+{
+	const __m128i xmmBits = _mm_castpd_si128(xmmX);
+	const __m128i xmmExponent = _mm_sub_epi64(_mm_srli_epi64(xmmBits, 52), _mm_set1_epi64x(1023));
+	__m128d xmmE = _mm_cvtepi32_pd(_mm_shuffle_epi32(xmmExponent, _MM_SHUFFLE(3, 1, 2, 0)));
+
+	/* Mantissa in [1, 2), folded to [sqrt(2)/2, sqrt(2)) */
+	__m128d xmmM = _mm_castsi128_pd(_mm_or_si128(
+		_mm_and_si128(xmmBits, _mm_set1_epi64x(0x000FFFFFFFFFFFFFLL)),
+		_mm_set1_epi64x(0x3FF0000000000000LL)));
+	const __m128d xmmFold = _mm_cmpgt_pd(xmmM, _mm_set1_pd(M_SQRT2));
+	xmmM = RCMSelect(xmmFold, _mm_mul_pd(xmmM, _mm_set1_pd(0.5)), xmmM);
+	xmmE = _mm_add_pd(xmmE, _mm_and_pd(xmmFold, _mm_set1_pd(1.0)));
+
+	const __m128d xmmOne = _mm_set1_pd(1.0);
+	const __m128d xmmS = _mm_div_pd(_mm_sub_pd(xmmM, xmmOne), _mm_add_pd(xmmM, xmmOne));
+	const __m128d xmmS2 = _mm_mul_pd(xmmS, xmmS);
+	__m128d xmmSum = _mm_set1_pd(1.0 / 21.0);
+	for (int k = 9; k >= 0; k--)
+		xmmSum = _mm_add_pd(_mm_mul_pd(xmmSum, xmmS2), _mm_set1_pd(1.0 / (2 * k + 1)));
+
+	return _mm_add_pd(_mm_mul_pd(xmmE, _mm_set1_pd(M_LN2)),
+		_mm_mul_pd(_mm_add_pd(xmmS, xmmS), xmmSum));
+}
+
+/************************************************************************/
+/*                         RCMHAAlphaPairSSE2()                         */
+/************************************************************************/
+/* Pixels n and n + 1. The eigenvalues use the closed form of           */
+/* RCMHermitianEigenvalues(). Only |v_i[0]|^2 of the eigenvectors is    */
+/* needed for alpha, and the eigenvector-eigenvalue identity gives it   */
+/* without the vectors:                                                 */
+/*   |v_i[0]|^2 = (l_i - mu_1)(l_i - mu_2) / ((l_i - l_j)(l_i - l_k))   */
+/* with mu the eigenvalues of the T22, T23, T33 minor. Returns the lane */
+/* mask of the pixels whose eigenvalues are too close for the identity; */
+/* the caller redoes them with the scalar path.                         */
+/************************************************************************/
+
+static int RCMHAAlphaPairSSE2(const double *padfT3, size_t nPlane, size_t n, double *padfHAAlpha)
+{
+	__m128d axmmM[9];
+	for (int m = 0; m < 9; m++)
+		axmmM[m] = _mm_loadu_pd(padfT3 + m * nPlane + n);
+
+	const __m128d xmmZero = _mm_setzero_pd();
+	const __m128d xmmOne = _mm_set1_pd(1.0);
+	const __m128d xmmTwo = _mm_set1_pd(2.0);
+	const __m128d xmmThird = _mm_set1_pd(1.0 / 3.0);
+	const __m128d xmmSign = _mm_set1_pd(-0.0);
+
+	const __m128d xmmN12 = _mm_add_pd(_mm_mul_pd(axmmM[1], axmmM[1]), _mm_mul_pd(axmmM[2], axmmM[2]));
+	const __m128d xmmN13 = _mm_add_pd(_mm_mul_pd(axmmM[3], axmmM[3]), _mm_mul_pd(axmmM[4], axmmM[4]));
+	const __m128d xmmN23 = _mm_add_pd(_mm_mul_pd(axmmM[6], axmmM[6]), _mm_mul_pd(axmmM[7], axmmM[7]));
+
+	/* Eigenvalues, as RCMHermitianEigenvalues() */
+	const __m128d xmmMean = _mm_mul_pd(_mm_add_pd(_mm_add_pd(axmmM[0], axmmM[5]), axmmM[8]), xmmThird);
+	const __m128d a = _mm_sub_pd(axmmM[0], xmmMean);
+	const __m128d b = _mm_sub_pd(axmmM[5], xmmMean);
+	const __m128d c = _mm_sub_pd(axmmM[8], xmmMean);
+	__m128d xmmP2 = _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, a), _mm_mul_pd(b, b)), _mm_mul_pd(c, c));
+	xmmP2 = _mm_add_pd(xmmP2, _mm_mul_pd(xmmTwo, _mm_add_pd(_mm_add_pd(xmmN12, xmmN13), xmmN23)));
+	xmmP2 = _mm_mul_pd(xmmP2, _mm_set1_pd(1.0 / 6.0));
+	/* Equal eigenvalues are left to the scalar path, keep the lanes finite */
+	const __m128d xmmSafeP2 = _mm_max_pd(xmmP2, _mm_set1_pd(1e-300));
+
+	const __m128d xmmRe1223 = _mm_sub_pd(_mm_mul_pd(axmmM[1], axmmM[6]), _mm_mul_pd(axmmM[2], axmmM[7]));
+	const __m128d xmmIm1223 = _mm_add_pd(_mm_mul_pd(axmmM[1], axmmM[7]), _mm_mul_pd(axmmM[2], axmmM[6]));
+	__m128d xmmDet = _mm_mul_pd(_mm_mul_pd(a, b), c);
+	xmmDet = _mm_add_pd(xmmDet, _mm_mul_pd(xmmTwo,
+		_mm_add_pd(_mm_mul_pd(xmmRe1223, axmmM[3]), _mm_mul_pd(xmmIm1223, axmmM[4]))));
+	xmmDet = _mm_sub_pd(xmmDet, _mm_add_pd(_mm_add_pd(_mm_mul_pd(a, xmmN23), _mm_mul_pd(b, xmmN13)),
+		_mm_mul_pd(c, xmmN12)));
+
+	const __m128d xmmP = _mm_sqrt_pd(xmmSafeP2);
+	__m128d xmmR = _mm_div_pd(xmmDet, _mm_mul_pd(_mm_mul_pd(xmmTwo, xmmSafeP2), xmmP));
+	xmmR = _mm_max_pd(_mm_set1_pd(-1.0), _mm_min_pd(xmmOne, xmmR));
+
+	__m128d xmmCosPhi, xmmSinPhi;
+	RCMCosSin(_mm_mul_pd(RCMAcos(xmmR), xmmThird), &xmmCosPhi, &xmmSinPhi);
+
+	/* cos(phi + 2 pi / 3) = -cos(phi) / 2 - sqrt(3) sin(phi) / 2 */
+	const __m128d xmmTwoP = _mm_add_pd(xmmP, xmmP);
+	const __m128d xmmL0 = _mm_add_pd(xmmMean, _mm_mul_pd(xmmTwoP, xmmCosPhi));
+	const __m128d xmmL2 = _mm_sub_pd(xmmMean, _mm_mul_pd(xmmTwoP,
+		_mm_add_pd(_mm_mul_pd(_mm_set1_pd(0.5), xmmCosPhi), _mm_mul_pd(_mm_set1_pd(0.86602540378443865), xmmSinPhi))));
+	const __m128d xmmL1 = _mm_sub_pd(_mm_sub_pd(_mm_mul_pd(_mm_set1_pd(3.0), xmmMean), xmmL0), xmmL2);
+
+	/* Gaps below 1e-3 of the largest magnitude go to the scalar path */
+	const __m128d xmmScale = _mm_mul_pd(_mm_set1_pd(1e-3),
+		_mm_max_pd(_mm_andnot_pd(xmmSign, xmmL0), _mm_andnot_pd(xmmSign, xmmL2)));
+	const __m128d xmmD01 = _mm_sub_pd(xmmL0, xmmL1);
+	const __m128d xmmD12 = _mm_sub_pd(xmmL1, xmmL2);
+	const __m128d xmmD02 = _mm_sub_pd(xmmL0, xmmL2);
+	const int nFallback = _mm_movemask_pd(_mm_or_pd(_mm_cmpngt_pd(xmmD01, xmmScale),
+		_mm_cmpngt_pd(xmmD12, xmmScale)));
+	if (nFallback == 3)
+		return nFallback;
+
+	/* Eigenvalues of the T22, T23, T33 minor */
+	const __m128d xmmHalfDiff = _mm_mul_pd(_mm_set1_pd(0.5), _mm_sub_pd(axmmM[5], axmmM[8]));
+	const __m128d xmmRadius = _mm_sqrt_pd(_mm_add_pd(_mm_mul_pd(xmmHalfDiff, xmmHalfDiff), xmmN23));
+	const __m128d xmmMid = _mm_mul_pd(_mm_set1_pd(0.5), _mm_add_pd(axmmM[5], axmmM[8]));
+	const __m128d xmmMu1 = _mm_add_pd(xmmMid, xmmRadius);
+	const __m128d xmmMu2 = _mm_sub_pd(xmmMid, xmmRadius);
+
+	const __m128d axmmL[3] = { xmmL0, xmmL1, xmmL2 };
+	const __m128d axmmDenom[3] = {
+		_mm_mul_pd(xmmD01, xmmD02),
+		_mm_mul_pd(_mm_sub_pd(xmmZero, xmmD01), xmmD12),
+		_mm_mul_pd(xmmD02, xmmD12) };
+
+	__m128d axmmClamped[3];
+	__m128d xmmSum = xmmZero;
+	for (int i = 0; i < 3; i++) {
+		axmmClamped[i] = _mm_max_pd(xmmZero, axmmL[i]);
+		xmmSum = _mm_add_pd(xmmSum, axmmClamped[i]);
+	}
+	const __m128d xmmPositive = _mm_cmpgt_pd(xmmSum, xmmZero);
+	const __m128d xmmInvSum = _mm_div_pd(xmmOne, RCMSelect(xmmPositive, xmmSum, xmmOne));
+
+	__m128d xmmEntropy = xmmZero, xmmAlpha = xmmZero;
+	for (int i = 0; i < 3; i++) {
+		const __m128d xmmProb = _mm_mul_pd(axmmClamped[i], xmmInvSum);
+		const __m128d xmmLogged = _mm_cmpgt_pd(xmmProb, _mm_set1_pd(1e-300));
+		const __m128d xmmLog = RCMLog(RCMSelect(xmmLogged, xmmProb, xmmOne));
+		xmmEntropy = _mm_sub_pd(xmmEntropy, _mm_and_pd(xmmLogged, _mm_mul_pd(xmmProb, xmmLog)));
+
+		/* |v_i[0]|^2 (the denominator is -(l_1 - l_0)(l_1 - l_2) for i = 1) */
+		const __m128d xmmNumer = _mm_mul_pd(_mm_sub_pd(axmmL[i], xmmMu1), _mm_sub_pd(axmmL[i], xmmMu2));
+		__m128d xmmCos2 = _mm_div_pd(xmmNumer, axmmDenom[i]);
+		xmmCos2 = _mm_max_pd(xmmZero, _mm_min_pd(xmmOne, xmmCos2));
+		xmmAlpha = _mm_add_pd(xmmAlpha, _mm_mul_pd(xmmProb, RCMAcos(_mm_sqrt_pd(xmmCos2))));
+	}
+	xmmEntropy = _mm_mul_pd(xmmEntropy, _mm_set1_pd(1.0 / log(3.0)));
+	xmmEntropy = _mm_max_pd(xmmZero, _mm_min_pd(xmmOne, xmmEntropy));
+	xmmEntropy = _mm_and_pd(xmmPositive, xmmEntropy);
+	xmmAlpha = _mm_and_pd(xmmPositive, _mm_mul_pd(xmmAlpha, _mm_set1_pd(180.0 / M_PI)));
+
+	const __m128d xmmDenomA = _mm_add_pd(axmmClamped[1], axmmClamped[2]);
+	const __m128d xmmHasA = _mm_and_pd(xmmPositive, _mm_cmpgt_pd(xmmDenomA, xmmZero));
+	const __m128d xmmAnisotropy = _mm_and_pd(xmmHasA, _mm_div_pd(
+		_mm_sub_pd(axmmClamped[1], axmmClamped[2]), RCMSelect(xmmHasA, xmmDenomA, xmmOne)));
+
+	_mm_storeu_pd(padfHAAlpha + n, xmmEntropy);
+	_mm_storeu_pd(padfHAAlpha + nPlane + n, xmmAnisotropy);
+	_mm_storeu_pd(padfHAAlpha + 2 * nPlane + n, xmmAlpha);
+	return nFallback;
+}
+
+#endif /* def RCM_HAALPHA_SSE2 */
+
+/************************************************************************/
+/*                         RCMComputeHAAlpha()                          */
+/************************************************************************/
+
+void RCMComputeHAAlpha(const double *padfT3, size_t nPlane, size_t nStart, size_t nEnd,
+	double *padfHAAlpha)
+{
+	size_t n = nStart;
+#ifdef RCM_HAALPHA_SSE2
+	for (; n + 2 <= nEnd; n += 2) {
+		const int nFallback = RCMHAAlphaPairSSE2(padfT3, nPlane, n, padfHAAlpha);
+		if (nFallback & 1)
+			RCMHAAlphaPixel(padfT3, nPlane, n, padfHAAlpha);
+		if (nFallback & 2)
+			RCMHAAlphaPixel(padfT3, nPlane, n + 1, padfHAAlpha);
+	}
+#endif
+	for (; n < nEnd; n++)
+		RCMHAAlphaPixel(padfT3, nPlane, n, padfHAAlpha);
+}
@@ -0,0 +1,96 @@
+#ifndef GDAL_RCM_POLARIMETRY_H_INCLUDED
+#define GDAL_RCM_POLARIMETRY_H_INCLUDED
+
+#include <cstddef>
+
+/************************************************************************/
+/*                          RCMComputeStokes()                          */
+/************************************************************************/
+/* Stokes vector of the compact polarimetry (right circular transmit,   */
+/* H and V receive) channels, averaged over nAzimuthLooks x nRangeLooks */
+/* cells:                                                               */
+/*   S0 = <|H|^2 + |V|^2>        S1 = <|H|^2 - |V|^2>                   */
+/*   S2 = 2 Re<H V*>             S3 = -2 Im<H V*>                       */
+/* pafH and pafV are calibrated I,Q pairs of nXSize * nRangeLooks by    */
+/* nYSize * nAzimuthLooks pixels. padfStokes receives 4 planes of       */
+/* nXSize * nYSize values, S0 first.                                    */
+/************************************************************************/
+
+void RCMComputeStokes(const float *pafH, const float *pafV, int nXSize, int nYSize,
+	int nRangeLooks, int nAzimuthLooks, double *padfStokes);
+
+/************************************************************************/
+/*                   RCMStokesDegreeOfPolarization()                    */
+/************************************************************************/
+/* m = sqrt(S1^2 + S2^2 + S3^2) / S0, 0 where S0 is 0                   */
+/************************************************************************/
+
+double RCMStokesDegreeOfPolarization(double dfS0, double dfS1, double dfS2, double dfS3);
+
+/************************************************************************/
+/*                          RCMStokesMChi()                             */
+/************************************************************************/
+/* m-chi decomposition (Raney, 2007) of a Stokes vector, in power:      */
+/*   sin 2chi = -S3 / (m S0)                                            */
+/*   double bounce = m S0 (1 - sin 2chi) / 2                            */
+/*   volume        = S0 (1 - m)                                         */
+/*   surface       = m S0 (1 + sin 2chi) / 2                            */
+/* The three add up to S0.                                              */
+/************************************************************************/
+
+void RCMStokesMChi(double dfS0, double dfS1, double dfS2, double dfS3,
+	double *pdfDoubleBounce, double *pdfVolume, double *pdfSurface);
+
+/************************************************************************/
+/*                         RCMComputeMatrix3()                          */
+/************************************************************************/
+/* 3x3 covariance (C3) or coherency (T3) matrix of quad polarization    */
+/* channels, averaged over nAzimuthLooks x nRangeLooks cells. HV and VH */
+/* are averaged (reciprocity), then                                     */
+/*   C3: k = [HH, sqrt2 HV, VV]                                         */
+/*   T3: k = [HH + VV, HH - VV, 2 HV] / sqrt2                           */
+/* and the matrix is <k k^H>. The inputs are calibrated I,Q pairs as    */
+/* for RCMComputeStokes(). padfMatrix receives 9 planes of              */
+/* nXSize * nYSize values in the order M11, M12 real, M12 imaginary,    */
+/* M13 real, M13 imaginary, M22, M23 real, M23 imaginary, M33.          */
+/************************************************************************/
+
+void RCMComputeMatrix3(const float *pafHH, const float *pafHV, const float *pafVH,
+	const float *pafVV, int nXSize, int nYSize, int nRangeLooks, int nAzimuthLooks,
+	bool bCoherency, double *padfMatrix);
+
+/************************************************************************/
+/*                      RCMHermitianEigenvalues()                       */
+/************************************************************************/
+/* Closed form eigenvalues of a Hermitian 3x3 matrix given as its upper */
+/* triangle in the RCMComputeMatrix3() order, in descending order.      */
+/************************************************************************/
+
+void RCMHermitianEigenvalues(const double *padfM, double *padfLambda);
+
+/************************************************************************/
+/*                         RCMHermitianEigen()                          */
+/************************************************************************/
+/* Eigenvalues in descending order and their orthonormal eigenvectors,  */
+/* 3 complex components each as re,im pairs (18 values).                */
+/************************************************************************/
+
+void RCMHermitianEigen(const double *padfM, double *padfLambda, double *padfVectors);
+
+/************************************************************************/
+/*                         RCMComputeHAAlpha()                          */
+/************************************************************************/
+/* Cloude-Pottier decomposition of the pixels nStart to nEnd - 1 of the */
+/* 9 T3 planes of nPlane values. padfHAAlpha receives 3 planes of       */
+/* nPlane values: entropy (log base 3), anisotropy (l2-l3)/(l2+l3) and  */
+/* mean alpha angle in degrees. On x86_64, pixels go by pairs through   */
+/* an SSE2 kernel; RCMComputeHAAlphaScalar() is the reference path,     */
+/* compared against it by rcmhaalpha_bench.cpp.                       */
+/************************************************************************/
+
+void RCMComputeHAAlpha(const double *padfT3, size_t nPlane, size_t nStart, size_t nEnd,
+	double *padfHAAlpha);
+void RCMComputeHAAlphaScalar(const double *padfT3, size_t nPlane, size_t nStart, size_t nEnd,
+	double *padfHAAlpha);
+
+#endif /* ndef GDAL_RCM_POLARIMETRY_H_INCLUDED */
@@ -0,0 +1,174 @@
+#include "cpl_port.h"
+#include "rcmspeckle.h"
+
+#include <algorithm>
+#include <cmath>
+
+/************************************************************************/
+/*                      RCMBuildSummedAreaTables()                      */
+/************************************************************************/
+
+void RCMBuildSummedAreaTables(const float *pafIn, int nXSize, int nYSize,
+	double *padfSum, double *padfSum2, double *padfCount)
+{
+	const size_t nStride = static_cast<size_t>(nXSize) + 1;
+
+	for (size_t i = 0; i < nStride; i++) {
+		padfSum[i] = 0.0;
+		padfSum2[i] = 0.0;
+		if (padfCount != NULL)
+			padfCount[i] = 0.0;
+	}
+
+	for (int i = 0; i < nYSize; i++) {
+		const float *pafLine = pafIn + static_cast<size_t>(i) * nXSize;
+		const double *padfAbove = padfSum + i * nStride;
+		const double *padfAbove2 = padfSum2 + i * nStride;
+		double *padfRow = padfSum + (i + 1) * nStride;
+		double *padfRow2 = padfSum2 + (i + 1) * nStride;
+
+		/* Running sum along the row, added to the table of the row above */
+		double dfRun = 0.0, dfRun2 = 0.0;
+		padfRow[0] = 0.0;
+		padfRow2[0] = 0.0;
+		if (padfCount == NULL) {
+			for (int j = 0; j < nXSize; j++) {
+				const double dfValue = pafLine[j];
+				dfRun += dfValue;
+				dfRun2 += dfValue * dfValue;
+				padfRow[j + 1] = padfAbove[j + 1] + dfRun;
+				padfRow2[j + 1] = padfAbove2[j + 1] + dfRun2;
+			}
+			continue;
+		}
+
+		/* Positive values only, and their count */
+		const double *padfAboveCount = padfCount + i * nStride;
+		double *padfRowCount = padfCount + (i + 1) * nStride;
+		double dfRunCount = 0.0;
+		padfRowCount[0] = 0.0;
+		for (int j = 0; j < nXSize; j++) {
+			const double dfValue = pafLine[j];
+			if (dfValue > 0.0) {
+				dfRun += dfValue;
+				dfRun2 += dfValue * dfValue;
+				dfRunCount += 1.0;
+			}
+			padfRow[j + 1] = padfAbove[j + 1] + dfRun;
+			padfRow2[j + 1] = padfAbove2[j + 1] + dfRun2;
+			padfRowCount[j + 1] = padfAboveCount[j + 1] + dfRunCount;
+		}
+	}
+}
+
+/* Minimum mean square error weight of the Lee filter, in intensity */
+static inline float RCMLeeValue(double dfValue, double dfMean, double dfVariance, double dfCu2)
+{
+	if (dfVariance <= 0.0)
+		return static_cast<float>(dfMean);
+
+	const double dfSignalVariance = (dfVariance - dfMean * dfMean * dfCu2) / (1.0 + dfCu2);
+	const double dfWeight = std::max(0.0, std::min(1.0, dfSignalVariance / dfVariance));
+	return static_cast<float>(dfMean + dfWeight * (dfValue - dfMean));
+}
+
+/************************************************************************/
+/*                          RCMSpeckleFilter()                          */
+/************************************************************************/
+
+void RCMSpeckleFilter(eSpeckleFilter eFilter, int nWindow, double dfENL,
+	const float *pafIn, int nInXSize, int nInYSize,
+	const double *padfSum, const double *padfSum2,
+	int iStartRow, int iEndRow, float *pafOut, int nOutLineSpace)
+{
+	const int r = nWindow / 2;
+	const int nOutXSize = nInXSize - 2 * r;
+	const size_t nStride = static_cast<size_t>(nInXSize) + 1;
+	const double dfCu2 = 1.0 / std::max(dfENL, 1e-6);
+	const double dfInvArea = 1.0 / (static_cast<double>(nWindow) * nWindow);
+	(void)nInYSize;
+
+	/* Refined Lee: 3 x 3 grid of sub-window means to find the edge direction */
+	const int nSub = r | 1;
+	const int nSubHalf = nSub / 2;
+	const int nSubStep = (nWindow - nSub) / 2;
+	const double dfInvSubArea = 1.0 / (static_cast<double>(nSub) * nSub);
+
+	for (int i = iStartRow; i < iEndRow; i++) {
+		float *pafLine = pafOut + static_cast<size_t>(i) * nOutLineSpace;
+		const int y = i + r;   /* centre row in the input tile */
+
+		for (int j = 0; j < nOutXSize; j++) {
+			const int x = j + r;
+			const double dfValue = pafIn[static_cast<size_t>(y) * nInXSize + x];
+
+			if (eFilter != SpeckleRefinedLee) {
+				const double dfMean = RCMBoxSum(padfSum, nStride, x - r, y - r, x + r + 1, y + r + 1) * dfInvArea;
+				if (eFilter == SpeckleBoxcar) {
+					pafLine[j] = static_cast<float>(dfMean);
+					continue;
+				}
+
+				const double dfVariance = std::max(0.0,
+					RCMBoxSum(padfSum2, nStride, x - r, y - r, x + r + 1, y + r + 1) * dfInvArea - dfMean * dfMean);
+				pafLine[j] = RCMLeeValue(dfValue, dfMean, dfVariance, dfCu2);
+				continue;
+			}
+
+			double adfSub[3][3];
+			for (int iy = 0; iy < 3; iy++) {
+				for (int ix = 0; ix < 3; ix++) {
+					const int cy = y + (iy - 1) * nSubStep;
+					const int cx = x + (ix - 1) * nSubStep;
+					adfSub[iy][ix] = RCMBoxSum(padfSum, nStride, cx - nSubHalf, cy - nSubHalf,
+						cx + nSubHalf + 1, cy + nSubHalf + 1) * dfInvSubArea;
+				}
+			}
+
+			/* Strongest of the 4 gradients, then the side closer to the centre */
+			const double adfGradient[4] = {
+				fabs(adfSub[1][2] - adfSub[1][0]),   /* vertical edge */
+				fabs(adfSub[0][2] - adfSub[2][0]),   /* edge along the 135 degree diagonal */
+				fabs(adfSub[0][1] - adfSub[2][1]),   /* horizontal edge */
+				fabs(adfSub[0][0] - adfSub[2][2]) }; /* edge along the 45 degree diagonal */
+			const double adfSideA[4] = { adfSub[1][0], adfSub[0][2], adfSub[0][1], adfSub[0][0] };
+			const double adfSideB[4] = { adfSub[1][2], adfSub[2][0], adfSub[2][1], adfSub[2][2] };
+
+			int iDirection = 0;
+			for (int k = 1; k < 4; k++) {
+				if (adfGradient[k] > adfGradient[iDirection])
+					iDirection = k;
+			}
+			const bool bSideA = fabs(adfSideA[iDirection] - adfSub[1][1]) <=
+				fabs(adfSideB[iDirection] - adfSub[1][1]);
+
+			/* Half window on the chosen side, one column range per row */
+			double dfSum = 0.0, dfSum2 = 0.0, dfCount = 0.0;
+			for (int dy = -r; dy <= r; dy++) {
+				int dx0 = -r, dx1 = r;
+				switch (iDirection) {
+				case 0:   /* left or right */
+					if (bSideA) dx1 = 0; else dx0 = 0;
+					break;
+				case 1:   /* top right or bottom left */
+					if (bSideA) dx0 = std::max(-r, dy); else dx1 = std::min(r, dy);
+					break;
+				case 2:   /* top or bottom */
+					if (bSideA ? dy > 0 : dy < 0) continue;
+					break;
+				default:  /* top left or bottom right */
+					if (bSideA) dx1 = std::min(r, -dy); else dx0 = std::max(-r, -dy);
+					break;
+				}
+
+				dfSum += RCMBoxSum(padfSum, nStride, x + dx0, y + dy, x + dx1 + 1, y + dy + 1);
+				dfSum2 += RCMBoxSum(padfSum2, nStride, x + dx0, y + dy, x + dx1 + 1, y + dy + 1);
+				dfCount += dx1 - dx0 + 1;
+			}
+
+			const double dfMean = dfSum / dfCount;
+			const double dfVariance = std::max(0.0, dfSum2 / dfCount - dfMean * dfMean);
+			pafLine[j] = RCMLeeValue(dfValue, dfMean, dfVariance, dfCu2);
+		}
+	}
+}
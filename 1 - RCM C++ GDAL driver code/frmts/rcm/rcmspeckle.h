@@ -0,0 +1,46 @@
+#ifndef GDAL_RCM_SPECKLE_H_INCLUDED
+#define GDAL_RCM_SPECKLE_H_INCLUDED
+
+/* Speckle filters of the calibrated power, SPECKLE_FILTER open option */
+enum eSpeckleFilter { SpeckleNone = 0, SpeckleBoxcar, SpeckleLee, SpeckleRefinedLee };
+
+/************************************************************************/
+/*                     RCMBuildSummedAreaTables()                       */
+/************************************************************************/
+/* Summed area tables of the values and of their squares, built in 2    */
+/* separable passes (running sums along the rows, then down the         */
+/* columns). padfSum and padfSum2 hold (nXSize + 1) * (nYSize + 1)      */
+/* values, the first row and column are 0. When padfCount is not NULL,  */
+/* only the positive values are summed and padfCount receives the table */
+/* of their count.                                                      */
+/************************************************************************/
+
+void RCMBuildSummedAreaTables(const float *pafIn, int nXSize, int nYSize,
+	double *padfSum, double *padfSum2, double *padfCount);
+
+/* Sum of the rows [y0, y1) and columns [x0, x1) of a summed area table */
+static inline double RCMBoxSum(const double *padfSum, size_t nStride,
+	int x0, int y0, int x1, int y1)
+{
+	return padfSum[y1 * nStride + x1] - padfSum[y0 * nStride + x1]
+		- padfSum[y1 * nStride + x0] + padfSum[y0 * nStride + x0];
+}
+
+/************************************************************************/
+/*                          RCMSpeckleFilter()                          */
+/************************************************************************/
+/* Filter the rows iStartRow to iEndRow - 1 of a tile. pafIn is the     */
+/* tile with a halo of nWindow / 2 pixels on every side, nInXSize by    */
+/* nInYSize, and padfSum/padfSum2 its summed area tables. pafOut        */
+/* receives nInXSize - 2 * (nWindow / 2) values per row, nOutLineSpace  */
+/* apart. Boxcar and Lee cost O(1) per pixel whatever the window, the   */
+/* diagonal windows of the refined Lee filter O(nWindow).               */
+/* dfENL is the equivalent number of looks of the intensity.            */
+/************************************************************************/
+
+void RCMSpeckleFilter(eSpeckleFilter eFilter, int nWindow, double dfENL,
+	const float *pafIn, int nInXSize, int nInYSize,
+	const double *padfSum, const double *padfSum2,
+	int iStartRow, int iEndRow, float *pafOut, int nOutLineSpace);
+
+#endif /* ndef GDAL_RCM_SPECKLE_H_INCLUDED */
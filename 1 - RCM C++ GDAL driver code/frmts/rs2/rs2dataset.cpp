@@ -326,10 +326,8 @@ void RS2CalibRasterBand::ReadLUT() {
 		strcat(lut_gains, lut);
     }
 
-#ifdef _TRACE_RCM
-	write_to_file("RS2 ReadLUT m_pszLUTFile=", m_pszLUTFile);
-	write_to_file("   m_nfTable=", lut_gains);
-#endif
+	RCM_TRACE(RCM_TRACE_INFO, "ReadLUT", "RS2 m_pszLUTFile=%s size=%d", m_pszLUTFile, m_nTableSize);
+	RCM_TRACE(RCM_TRACE_DEBUG, "ReadLUT", "m_nfTable=%s", lut_gains);
 
  	poDS->SetMetadataItem(CPLString("LUT_GAINS_").append(bandNumber).c_str(), lut_gains);
 	// Can free this because the function SetMetadataItem takes a copy
@@ -677,11 +675,7 @@ CPLErr RS2CalibRasterBand::IReadBlock( int nBlockXOff, int nBlockYOff,
 #endif        
 		}
 
-#ifdef _TRACE_RCM
-		char msgBlocks[256] = "";
-		sprintf(msgBlocks, "IReadBlock: nBlockXOff=%d and nBlockYOff=%d ", nBlockXOff, nBlockYOff);
-		write_to_file(msgBlocks, "");
-#endif
+		RCM_TRACE(RCM_TRACE_DEBUG, "IReadBlock", "nBlockXOff=%d nBlockYOff=%d", nBlockXOff, nBlockYOff);
 
 		/* calibrate the complex values */
 		for (int i = 0; i < nRequestYSize; i++) {
@@ -794,6 +794,22 @@ double CPL_DLL CPL_STDCALL GDALGetRasterDataReferenceNoiseLevelValue(GDALRasterB
 int CPL_DLL CPL_STDCALL GDALGetRasterDataReferenceNoiseLevelValues(GDALRasterBandH hBand, double **values, char *bandNumber);
 void CPL_DLL CPL_STDCALL GDALBandSetRasterDataLUTPartial(GDALRasterBandH hBand, int pixel_offset, int pixel_width);
 void CPL_DLL CPL_STDCALL GDALDatasetSetRasterDataLUTPartial(GDALDatasetH hBand, GDALDatasetH ds_original, int bands_to_copy[],  int nb_bands, int pixel_offset, int pixel_width);
+int CPL_DLL CPL_STDCALL GDALGetRCMOrbitStateVectors(GDALDatasetH hDataset, int nCount, const double *padfTime, double *padfPosition, double *padfVelocity);
+int CPL_DLL CPL_STDCALL GDALGetRCMDopplerCentroid(GDALDatasetH hDataset, int nCount, const double *padfPixel, const double *padfLine, double *padfDoppler);
+int CPL_DLL CPL_STDCALL GDALGetRCMSlantRange(GDALDatasetH hDataset, int nCount, const double *padfPixel, const double *padfLine, double *padfSlantRange);
+int CPL_DLL CPL_STDCALL GDALGetRCMAzimuthTime(GDALDatasetH hDataset, int nCount, const double *padfLine, double *padfTime);
+void CPL_DLL *GDALCreateRCMTiePointTransformer(GDALDatasetH hDataset);
+void CPL_DLL GDALDestroyRCMTiePointTransformer(void *pTransformArg);
+int CPL_DLL GDALRCMTiePointTransform(void *pTransformArg, int bDstToSrc, int nPointCount, double *x, double *y, double *z, int *panSuccess);
+int CPL_DLL CPL_STDCALL GDALRCMRPCGroundToImage(GDALDatasetH hDataset, int nCount, const double *padfLongitude, const double *padfLatitude, const double *padfHeight, double dfHeight, double *padfPixel, double *padfLine);
+int CPL_DLL CPL_STDCALL GDALRCMRPCImageToGround(GDALDatasetH hDataset, int nCount, const double *padfPixel, const double *padfLine, const double *padfHeight, double dfHeight, double *padfLongitude, double *padfLatitude, int *panSuccess);
+CPLErr CPL_DLL CPL_STDCALL GDALRCMTerrainGeocode(GDALDatasetH hSrcDS, GDALDatasetH hDEMDS, double dfConstantHeight, GDALDatasetH hDstDS, char **papszOptions, GDALProgressFunc pfnProgress, void *pProgressData);
+int CPL_DLL CPL_STDCALL GDALGetRCMBurstIds(GDALDatasetH hDataset, int nCount, const double *padfPixel, const double *padfLine, int *panBurst, int *panBeam);
+const char CPL_DLL * CPL_STDCALL GDALGetRCMBeamName(GDALDatasetH hDataset, int nBeam);
+const double CPL_DLL * CPL_STDCALL GDALGetRCMIncidenceAngleRow(GDALDatasetH hDataset, int *pnCount);
+CPLErr CPL_DLL CPL_STDCALL GDALRCMDetectTargets(GDALDatasetH hSrcDS, int nBand, OGRLayerH hDstLayer, char **papszOptions, GDALProgressFunc pfnProgress, void *pProgressData);
+CPLErr CPL_DLL CPL_STDCALL GDALRCMExportCOG(GDALDatasetH hSrcDS, const char *pszDstFilename, char **papszOptions, GDALProgressFunc pfnProgress, void *pProgressData);
+CPLErr CPL_DLL CPL_STDCALL GDALGetRasterHistogramDB(GDALRasterBandH hBand, double dfMin, double dfMax, int nBuckets, GUIntBig *panHistogram, int bIncludeOutOfRange, int bApproxOK, GDALProgressFunc pfnProgress, void *pProgressData);
 /* End: Roberto July 2018 */
 
 GDALDataType CPL_DLL CPL_STDCALL GDALGetRasterDataType( GDALRasterBandH );
@@ -1,101 +1,346 @@
-#include <time.h>
+#include <stdarg.h>
 #include <stdio.h>
-//#include <conio.h>
 #include <string.h>
-#include "gdal_pam.h"
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "cpl_conv.h"
+#include "cpl_error.h"
 #include "gdal_io_error.h"
 
-char *get_current_time()
+namespace {
+
+struct RCMTraceRecord {
+	long long nTimeNs;
+	const char *pszEvent;
+	int nLevel;
+	char szMsg[RCM_TRACE_MSG_SIZE];
+};
+
+/* One producer, the owning thread, and one consumer at a time, the drain */
+struct RCMTraceRing {
+	std::atomic<unsigned> nHead{0};
+	std::atomic<unsigned> nTail{0};
+	std::atomic<unsigned> nDropped{0};
+	std::atomic<bool> bRetired{false};
+	int nThread = 0;
+	RCMTraceRecord asRecords[RCM_TRACE_RING_SIZE];
+};
+
+/* Marks the ring of a thread as retired when the thread exits, the drain */
+/* then releases it once it is empty */
+struct RCMTraceRingHolder {
+	std::shared_ptr<RCMTraceRing> poRing;
+	~RCMTraceRingHolder() {
+		if (poRing)
+			poRing->bRetired.store(true, std::memory_order_release);
+	}
+};
+
+/************************************************************************/
+/*                              RCMTracer                               */
+/************************************************************************/
+/* Never deleted: the detached flush thread may still be waiting on it  */
+/* while the process exits. RCMTraceFinalizer writes the last records.  */
+/************************************************************************/
+
+class RCMTracer {
+public:
+	explicit RCMTracer(FILE *fp) : m_fp(fp), m_oStart(std::chrono::steady_clock::now()) {}
+
+	long long ElapsedNs() const {
+		return std::chrono::duration_cast<std::chrono::nanoseconds>(
+			std::chrono::steady_clock::now() - m_oStart).count();
+	}
+
+	RCMTraceRing *Register();
+	bool Drain();
+	void Close();
+	void FlushLoop();
+
+private:
+	void WriteRecord(int nThread, const RCMTraceRecord &sRecord);
+
+	FILE *m_fp;
+	const std::chrono::steady_clock::time_point m_oStart;
+
+	std::mutex m_oRingsMutex;   /* only taken when a thread traces for the first time */
+	std::vector<std::shared_ptr<RCMTraceRing> > m_apoRings;
+	int m_nNextThread = 0;
+
+	std::mutex m_oDrainMutex;   /* serializes the consumers, never taken by rcm_trace() */
+	std::mutex m_oWakeMutex;
+	std::condition_variable m_oWake;
+};
+
+RCMTracer *gpoTracer = NULL;
+std::atomic<int> gnTraceState{-1};   /* -1 not initialized, 0 off, 1 on */
+std::once_flag gTraceInitOnce;
+thread_local RCMTraceRingHolder tlsTraceRing;
+
+const char *RCMTraceLevelName(int nLevel)
+{
+	switch (nLevel) {
+	case RCM_TRACE_ERROR: return "ERROR";
+	case RCM_TRACE_WARNING: return "WARNING";
+	case RCM_TRACE_INFO: return "INFO";
+	default: return "DEBUG";
+	}
+}
+
+/* JSON string body of a UTF-8 string: quote, backslash and control    */
+/* characters escaped, the other bytes copied through                  */
+void RCMWriteJSONString(FILE *fp, const char *pszValue)
 {
-	time_t current_time;
-	char* c_time_string;
+	for (const unsigned char *p = reinterpret_cast<const unsigned char *>(pszValue); *p; p++) {
+		if (*p == '"' || *p == '\\')
+			fprintf(fp, "\\%c", *p);
+		else if (*p < 0x20 || *p == 0x7f)
+			fprintf(fp, "\\u%04x", *p);
+		else if (*p >= 0xc0) {
+			/* Drop a sequence cut by the truncation of the message */
+			const int nLength = *p >= 0xf0 ? 4 : *p >= 0xe0 ? 3 : 2;
+			int i = 1;
+			while (i < nLength && (p[i] & 0xc0) == 0x80)
+				i++;
+			if (i < nLength && p[i] == 0)
+				break;
+			fwrite(p, 1, i, fp);
+			p += i - 1;
+		}
+		else
+			fputc(*p, fp);
+	}
+}
+
+RCMTraceRing *RCMTracer::Register()
+{
+	std::shared_ptr<RCMTraceRing> poRing = std::make_shared<RCMTraceRing>();
+	{
+		std::lock_guard<std::mutex> oLock(m_oRingsMutex);
+		poRing->nThread = m_nNextThread++;
+		m_apoRings.push_back(poRing);
+	}
+	tlsTraceRing.poRing = poRing;
+	return poRing.get();
+}
 
-	/* Obtain current time. */
-	current_time = time(NULL);
+void RCMTracer::WriteRecord(int nThread, const RCMTraceRecord &sRecord)
+{
+	fprintf(m_fp, "{\"t_ns\":%lld,\"thread\":%d,\"level\":\"%s\",\"event\":\"",
+		sRecord.nTimeNs, nThread, RCMTraceLevelName(sRecord.nLevel));
+	RCMWriteJSONString(m_fp, sRecord.pszEvent);
+	fputs("\",\"msg\":\"", m_fp);
+	RCMWriteJSONString(m_fp, sRecord.szMsg);
+	fputs("\"}\n", m_fp);
+}
 
-	/* Convert to local time format. */
-	c_time_string = ctime(&current_time);
+/************************************************************************/
+/*                               Drain()                                */
+/************************************************************************/
+/* Write the pending records of every ring, returns false once closed.  */
+/************************************************************************/
 
-	for (int i = 0; i < strlen(c_time_string); i++)
+bool RCMTracer::Drain()
+{
+	std::lock_guard<std::mutex> oDrainLock(m_oDrainMutex);
+	if (m_fp == NULL)
+		return false;
+
+	std::vector<std::shared_ptr<RCMTraceRing> > apoRings;
 	{
-		if (c_time_string[i] == '\n' || c_time_string[i] == '\r') c_time_string[i] = ' ';
+		std::lock_guard<std::mutex> oLock(m_oRingsMutex);
+		apoRings = m_apoRings;
 	}
 
-	return c_time_string;
+	bool bRetiredRings = false;
+	for (size_t i = 0; i < apoRings.size(); i++) {
+		RCMTraceRing *poRing = apoRings[i].get();
+
+		/* Read before the head, so that no record of a retired ring is missed */
+		const bool bRetired = poRing->bRetired.load(std::memory_order_acquire);
+		bRetiredRings |= bRetired;
+
+		const unsigned nHead = poRing->nHead.load(std::memory_order_acquire);
+		unsigned nTail = poRing->nTail.load(std::memory_order_relaxed);
+		for (; nTail != nHead; nTail++)
+			WriteRecord(poRing->nThread, poRing->asRecords[nTail & (RCM_TRACE_RING_SIZE - 1)]);
+		poRing->nTail.store(nTail, std::memory_order_release);
+
+		const unsigned nDropped = poRing->nDropped.exchange(0, std::memory_order_relaxed);
+		if (nDropped > 0) {
+			RCMTraceRecord sRecord;
+			sRecord.nTimeNs = ElapsedNs();
+			sRecord.pszEvent = "dropped";
+			sRecord.nLevel = RCM_TRACE_WARNING;
+			snprintf(sRecord.szMsg, sizeof(sRecord.szMsg), "%u records lost, ring buffer full", nDropped);
+			WriteRecord(poRing->nThread, sRecord);
+		}
+	}
+	fflush(m_fp);
+
+	if (bRetiredRings) {
+		std::lock_guard<std::mutex> oLock(m_oRingsMutex);
+		for (size_t i = 0; i < m_apoRings.size(); ) {
+			RCMTraceRing *poRing = m_apoRings[i].get();
+			if (poRing->bRetired.load(std::memory_order_acquire) &&
+				poRing->nTail.load(std::memory_order_relaxed) ==
+				poRing->nHead.load(std::memory_order_acquire)) {
+				m_apoRings.erase(m_apoRings.begin() + i);
+			}
+			else {
+				i++;
+			}
+		}
+	}
+
+	return true;
 }
 
-void write_to_file_error(const char *header, const char *value)
+void RCMTracer::Close()
 {
-	/* Convert to local time format. */
-	//char *c_time_string = get_current_time();
+	gnTraceState.store(0, std::memory_order_release);
+	Drain();
 
-	//FILE *pFile2 = fopen("gdal_error.log", "a");
-	//if (value == NULL)
-	//{
-	//	fprintf(pFile2, "%s: %s\n", c_time_string, header);
-	//}
-	//else
-	//{
-	//	fprintf(pFile2, "%s: %s %s\n", c_time_string, header, value);
-	//}
-	//fclose(pFile2);
+	std::lock_guard<std::mutex> oDrainLock(m_oDrainMutex);
+	if (m_fp != NULL) {
+		fclose(m_fp);
+		m_fp = NULL;
+	}
+	m_oWake.notify_one();
+}
+
+void RCMTracer::FlushLoop()
+{
+	std::unique_lock<std::mutex> oLock(m_oWakeMutex);
+	for (;;) {
+		m_oWake.wait_for(oLock, std::chrono::milliseconds(RCM_TRACE_FLUSH_MS));
+		oLock.unlock();
+		if (!Drain())
+			return;
+		oLock.lock();
+	}
 }
 
+void RCMTraceInit()
+{
+#if RCM_TRACE_LEVEL >= RCM_TRACE_DEBUG
+	const char *pszFile = CPLGetConfigOption("GDAL_RCM_TRACE_FILE", "gdal_trace.log");
+#else
+	const char *pszFile = CPLGetConfigOption("GDAL_RCM_TRACE_FILE", NULL);
+#endif
+	if (pszFile == NULL || pszFile[0] == '\0') {
+		gnTraceState.store(0, std::memory_order_release);
+		return;
+	}
 
+	FILE *fp = fopen(pszFile, "a");
+	if (fp == NULL) {
+		CPLError(CE_Warning, CPLE_OpenFailed, "Cannot open trace file %s", pszFile);
+		gnTraceState.store(0, std::memory_order_release);
+		return;
+	}
 
-void write_to_file(const char *header, const char *value)
+	gpoTracer = new RCMTracer(fp);
+	std::thread(&RCMTracer::FlushLoop, gpoTracer).detach();
+	gnTraceState.store(1, std::memory_order_release);
+}
+
+/* Writes the records still in the rings when the process exits */
+struct RCMTraceFinalizer {
+	~RCMTraceFinalizer() {
+		if (gpoTracer != NULL)
+			gpoTracer->Close();
+	}
+} gTraceFinalizer;
+
+} // namespace
+
+/************************************************************************/
+/*                          rcm_trace_enabled()                         */
+/************************************************************************/
+
+bool rcm_trace_enabled()
 {
-	/* Convert to local time format. */
-	char *c_time_string = get_current_time();
-	//CPLDebug(header, value);
+	const int nState = gnTraceState.load(std::memory_order_acquire);
+	if (nState >= 0)
+		return nState != 0;
 
-	FILE *pFile2 = fopen("gdal_trace.log", "a");
-	fprintf(pFile2, "%s: %s %f\n", c_time_string, header, value);
-	fclose(pFile2);
+	std::call_once(gTraceInitOnce, RCMTraceInit);
+	return gnTraceState.load(std::memory_order_acquire) != 0;
 }
 
-#ifdef _TRACE_RCM
+/************************************************************************/
+/*                              rcm_trace()                             */
+/************************************************************************/
 
-void write_to_file_dbl(const char *header, const double value)
+void rcm_trace(int nLevel, const char *pszEvent, const char *pszFormat, ...)
 {
-	///* Convert to local time format. */
-	//char *c_time_string = get_current_time();
+	if (!rcm_trace_enabled())
+		return;
+
+	RCMTraceRing *poRing = tlsTraceRing.poRing.get();
+	if (poRing == NULL)
+		poRing = gpoTracer->Register();
+
+	const unsigned nHead = poRing->nHead.load(std::memory_order_relaxed);
+	if (nHead - poRing->nTail.load(std::memory_order_acquire) >= RCM_TRACE_RING_SIZE) {
+		poRing->nDropped.fetch_add(1, std::memory_order_relaxed);
+		return;
+	}
+
+	RCMTraceRecord &sRecord = poRing->asRecords[nHead & (RCM_TRACE_RING_SIZE - 1)];
+	sRecord.nTimeNs = gpoTracer->ElapsedNs();
+	sRecord.pszEvent = pszEvent;
+	sRecord.nLevel = nLevel;
 
-	//char str_value[5000];
-	//sprintf(str_value, "%f", value);
-	//CPLDebug(header, str_value);
+	va_list args;
+	va_start(args, pszFormat);
+	vsnprintf(sRecord.szMsg, sizeof(sRecord.szMsg), pszFormat, args);
+	va_end(args);
 
-	//FILE *pFile2 = fopen("gdal_trace.log", "a");
-	//fprintf(pFile2, "%s: %s %f\n", c_time_string, header, value);
-	//fclose(pFile2);
+	poRing->nHead.store(nHead + 1, std::memory_order_release);
 }
 
-void write_to_file_flt(const char *header, const float value)
+/************************************************************************/
+/*                           rcm_trace_flush()                          */
+/************************************************************************/
+
+void rcm_trace_flush()
 {
-	///* Convert to local time format. */
-	//char *c_time_string = get_current_time();
+	if (rcm_trace_enabled())
+		gpoTracer->Drain();
+}
 
-	//char str_value[5000];
-	//sprintf(str_value, "%f", value);
-	//CPLDebug(header, str_value);
+void write_to_file_error(const char *header, const char *value)
+{
+	RCM_TRACE(RCM_TRACE_ERROR, "error", "%s%s", header, value != NULL ? value : "");
+}
 
-	//FILE *pFile2 = fopen("gdal_trace.log", "a");
-	//fprintf(pFile2, "%s: %s %f\n", c_time_string, header, value);
-	//fclose(pFile2);
+void write_to_file(const char *header, const char *value)
+{
+	RCM_TRACE(RCM_TRACE_DEBUG, "trace", "%s%s", header, value != NULL ? value : "");
 }
 
+#if RCM_TRACE_LEVEL >= RCM_TRACE_DEBUG
 
-void write_to_file_int(const char *header, const int value)
+void write_to_file_dbl(const char *header, const double value)
 {
-	///* Convert to local time format. */
-	//char *c_time_string = get_current_time();
+	RCM_TRACE(RCM_TRACE_DEBUG, "trace", "%s%.17g", header, value);
+}
 
-	//char str_value[5000];
-	//sprintf(str_value, "%d", value);
-	//CPLDebug(header, str_value);
+void write_to_file_flt(const char *header, const float value)
+{
+	RCM_TRACE(RCM_TRACE_DEBUG, "trace", "%s%.9g", header, value);
+}
 
-	//FILE *pFile2 = fopen("gdal_trace.log", "a");
-	//fprintf(pFile2, "%s: %s %d\n", c_time_string, header, value);
-	//fclose(pFile2);
+void write_to_file_int(const char *header, const int value)
+{
+	RCM_TRACE(RCM_TRACE_DEBUG, "trace", "%s%d", header, value);
 }
+
 #endif
@@ -1,13 +1,66 @@
-#define _NO_TRACE_RCM
+#ifndef GDAL_IO_ERROR_H_INCLUDED
+#define GDAL_IO_ERROR_H_INCLUDED
 
-char *get_current_time();
+/************************************************************************/
+/*                         RS2 and RCM tracing                          */
+/************************************************************************/
+/* Each thread appends fixed size records to its own ring buffer, with  */
+/* no lock and no allocation. A background thread drains the buffers    */
+/* every RCM_TRACE_FLUSH_MS and appends them to the trace file as JSON   */
+/* lines:                                                               */
+/*   {"t_ns":..,"thread":..,"level":"DEBUG","event":"..","msg":".."}    */
+/* t_ns comes from a monotonic clock (nanoseconds since the first       */
+/* trace). Records that find their ring buffer full are counted and     */
+/* reported as a "dropped" record instead of blocking the caller.       */
+/*                                                                      */
+/* RCM_TRACE_LEVEL selects at compile time the levels that are kept,    */
+/* the others compile to nothing. It defaults to RCM_TRACE_INFO; build  */
+/* with -DRCM_TRACE_LEVEL=4 (RCM_TRACE_DEBUG) for the DEBUG records. At */
+/* run time the records are only written when the GDAL_RCM_TRACE_FILE   */
+/* configuration option names a file, gdal_trace.log by default at the  */
+/* DEBUG level.                                                         */
+/************************************************************************/
+
+#define RCM_TRACE_ERROR 1
+#define RCM_TRACE_WARNING 2
+#define RCM_TRACE_INFO 3
+#define RCM_TRACE_DEBUG 4
+
+#ifndef RCM_TRACE_LEVEL
+#define RCM_TRACE_LEVEL RCM_TRACE_INFO
+#endif
+
+#define RCM_TRACE_RING_SIZE 1024   /* records per thread, a power of 2 */
+#define RCM_TRACE_MSG_SIZE 232     /* longer messages are truncated */
+#define RCM_TRACE_FLUSH_MS 200
+
+/* True when the trace file is open, a single relaxed atomic load */
+bool rcm_trace_enabled();
+
+/* pszEvent must be a string literal, only its address is stored */
+void rcm_trace(int nLevel, const char *pszEvent, const char *pszFormat, ...)
+#if defined(__GNUC__)
+	__attribute__((format(printf, 3, 4)))
+#endif
+	;
+
+/* Write every pending record, then return */
+void rcm_trace_flush();
+
+#define RCM_TRACE(level, event, ...) \
+	do { \
+		if ((level) <= RCM_TRACE_LEVEL && rcm_trace_enabled()) \
+			rcm_trace((level), (event), __VA_ARGS__); \
+	} while (0)
+
+/* Previous interface, kept for the RS2 driver */
 
 void write_to_file_error(const char *header, const char *value);
 
 void write_to_file(const char *header, const char *value);
 
 
-#ifdef _TRACE_RCM
+#if RCM_TRACE_LEVEL >= RCM_TRACE_DEBUG
 
 void write_to_file_dbl(const char *header, const double value);
 
@@ -16,3 +69,5 @@ void write_to_file_flt(const char *header, const float value);
 void write_to_file_int(const char *header, const int value);
 
 #endif
+
+#endif /* ndef GDAL_IO_ERROR_H_INCLUDED */
@@ -83,7 +83,8 @@ typedef enum eCalibration_t {
 	Gamma,
 	Beta0,
 	Uncalib,
-	None
+	None,
+	Gamma0Ellipsoid		/* derived from Sigma0 and the ellipsoid incidence angle */
 } eCalibration;
 
 const int max_space_for_string = 32;
@@ -1046,6 +1046,11 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
     void           SetFlushBlockErr( CPLErr eErr );
     CPLErr         UnreferenceBlock( GDALRasterBlock* poBlock );
     void           SetValidPercent( GUIntBig nSampleCount, GUIntBig nValidCount );
+    CPLErr         ComputeHistogram( double dfMin, double dfMax,
+                                     int nBuckets, GUIntBig *panHistogram,
+                                     int bIncludeOutOfRange, int bApproxOK,
+                                     bool bDB,
+                                     GDALProgressFunc, void *pProgressData );
 
   protected:
 //! @cond Doxygen_Suppress
@@ -1217,6 +1222,11 @@ class CPL_DLL GDALRasterBand : public GDALMajorObject
                           int bIncludeOutOfRange, int bApproxOK,
                           GDALProgressFunc, void *pProgressData );
 
+    CPLErr          GetHistogramDB( double dfMin, double dfMax,
+                          int nBuckets, GUIntBig * panHistogram,
+                          int bIncludeOutOfRange, int bApproxOK,
+                          GDALProgressFunc, void *pProgressData );
+
     virtual CPLErr GetDefaultHistogram( double *pdfMin, double *pdfMax,
                                         int *pnBuckets, GUIntBig ** ppanHistogram,
                                         int bForce,
@@ -7775,3 +7775,241 @@ void CPL_DLL CPL_STDCALL GDALDatasetSetRasterDataLUTPartial(GDALDatasetH hDS, GD
 	}
 }
 /* Roberto's Fix done */
+
+/**
+* \brief Interpolate the RCM orbit position and velocity at nCount epochs
+*
+* padfTime are seconds since 1970-01-01T00:00:00Z. padfPosition and
+* padfVelocity receive nCount x,y,z triplets in metres and metres per
+* second, and either may be NULL. Sorted epochs are the fastest.
+*
+* @return nCount, or 0 if the dataset is not RCM or has no state vectors.
+*/
+int CPL_DLL CPL_STDCALL GDALGetRCMOrbitStateVectors(GDALDatasetH hDS, int nCount, const double *padfTime, double *padfPosition, double *padfVelocity)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMOrbitStateVectors", 0);
+	VALIDATE_POINTER1(padfTime, "GDALGetRCMOrbitStateVectors", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || !rcmDataset->GetOrbit()->IsValid() || nCount <= 0)
+		return 0;
+
+	rcmDataset->GetOrbit()->Evaluate(nCount, padfTime, padfPosition, padfVelocity);
+
+	return nCount;
+}
+
+/**
+* \brief Evaluate the RCM Doppler centroid at nCount image coordinates
+*
+* padfPixel and padfLine are pixel/line coordinates of the dataset, the
+* Doppler centroid in Hz is written to padfDoppler. Only SLC and MLC
+* products carry the slant range geometry needed for the evaluation.
+*
+* @return nCount, or 0 if the dataset is not RCM or the evaluation failed.
+*/
+int CPL_DLL CPL_STDCALL GDALGetRCMDopplerCentroid(GDALDatasetH hDS, int nCount, const double *padfPixel, const double *padfLine, double *padfDoppler)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMDopplerCentroid", 0);
+	VALIDATE_POINTER1(padfPixel, "GDALGetRCMDopplerCentroid", 0);
+	VALIDATE_POINTER1(padfLine, "GDALGetRCMDopplerCentroid", 0);
+	VALIDATE_POINTER1(padfDoppler, "GDALGetRCMDopplerCentroid", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || nCount <= 0)
+		return 0;
+
+	if (rcmDataset->GetDopplerCentroid(nCount, padfPixel, padfLine, padfDoppler) != CE_None)
+		return 0;
+
+	return nCount;
+}
+
+/**
+* \brief Evaluate the RCM slant range at nCount image coordinates
+*
+* padfPixel and padfLine are pixel/line coordinates of the dataset, the
+* slant range in metres is written to padfSlantRange. Ground range
+* products go through the slantRangeToGroundRange polynomials
+* interpolated at the zero Doppler time of each line.
+*
+* @return nCount, or 0 if the dataset is not RCM or the evaluation failed.
+*/
+int CPL_DLL CPL_STDCALL GDALGetRCMSlantRange(GDALDatasetH hDS, int nCount, const double *padfPixel, const double *padfLine, double *padfSlantRange)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMSlantRange", 0);
+	VALIDATE_POINTER1(padfPixel, "GDALGetRCMSlantRange", 0);
+	VALIDATE_POINTER1(padfLine, "GDALGetRCMSlantRange", 0);
+	VALIDATE_POINTER1(padfSlantRange, "GDALGetRCMSlantRange", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || nCount <= 0)
+		return 0;
+
+	if (rcmDataset->GetSlantRanges(nCount, padfPixel, padfLine, padfSlantRange) != CE_None)
+		return 0;
+
+	return nCount;
+}
+
+/**
+* \brief Zero Doppler azimuth time of nCount RCM image lines
+*
+* padfLine are line coordinates of the dataset, the time in seconds since
+* 1970-01-01T00:00:00Z is written to padfTime. The time follows the
+* sampled line spacing time and the line time ordering of the product.
+*
+* @return nCount, or 0 if the dataset is not RCM or is geocoded.
+*/
+int CPL_DLL CPL_STDCALL GDALGetRCMAzimuthTime(GDALDatasetH hDS, int nCount, const double *padfLine, double *padfTime)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMAzimuthTime", 0);
+	VALIDATE_POINTER1(padfLine, "GDALGetRCMAzimuthTime", 0);
+	VALIDATE_POINTER1(padfTime, "GDALGetRCMAzimuthTime", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || !rcmDataset->HasLineTimes() || nCount <= 0)
+		return 0;
+
+	for (int i = 0; i < nCount; i++)
+		padfTime[i] = rcmDataset->GetLineAzimuthTime(padfLine[i]);
+
+	return nCount;
+}
+
+/**
+* \brief Project nCount ground points into an RCM image with its rational
+* functions
+*
+* padfHeight may be NULL to use dfHeight for every point. padfPixel and
+* padfLine receive the image coordinates, integer values being pixel
+* centres.
+*
+* @return nCount, or 0 if the dataset is not RCM or has no rational functions.
+*/
+int CPL_DLL CPL_STDCALL GDALRCMRPCGroundToImage(GDALDatasetH hDS, int nCount, const double *padfLongitude, const double *padfLatitude, const double *padfHeight, double dfHeight, double *padfPixel, double *padfLine)
+{
+	VALIDATE_POINTER1(hDS, "GDALRCMRPCGroundToImage", 0);
+	VALIDATE_POINTER1(padfLongitude, "GDALRCMRPCGroundToImage", 0);
+	VALIDATE_POINTER1(padfLatitude, "GDALRCMRPCGroundToImage", 0);
+	VALIDATE_POINTER1(padfPixel, "GDALRCMRPCGroundToImage", 0);
+	VALIDATE_POINTER1(padfLine, "GDALRCMRPCGroundToImage", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || !rcmDataset->GetRPCModel()->IsValid() || nCount <= 0)
+		return 0;
+
+	rcmDataset->GetRPCModel()->Forward(nCount, padfLongitude, padfLatitude, padfHeight, dfHeight,
+		padfPixel, padfLine);
+
+	return nCount;
+}
+
+/**
+* \brief Locate nCount RCM image points on the ground with its rational
+* functions
+*
+* padfHeight may be NULL to use dfHeight for every point. The rational
+* functions are inverted iteratively, panSuccess (may be NULL) tells which
+* points converged.
+*
+* @return the number of converged points, 0 if the dataset is not RCM or
+* has no rational functions.
+*/
+int CPL_DLL CPL_STDCALL GDALRCMRPCImageToGround(GDALDatasetH hDS, int nCount, const double *padfPixel, const double *padfLine, const double *padfHeight, double dfHeight, double *padfLongitude, double *padfLatitude, int *panSuccess)
+{
+	VALIDATE_POINTER1(hDS, "GDALRCMRPCImageToGround", 0);
+	VALIDATE_POINTER1(padfPixel, "GDALRCMRPCImageToGround", 0);
+	VALIDATE_POINTER1(padfLine, "GDALRCMRPCImageToGround", 0);
+	VALIDATE_POINTER1(padfLongitude, "GDALRCMRPCImageToGround", 0);
+	VALIDATE_POINTER1(padfLatitude, "GDALRCMRPCImageToGround", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || !rcmDataset->GetRPCModel()->IsValid() || nCount <= 0)
+		return 0;
+
+	return rcmDataset->GetRPCModel()->Inverse(nCount, padfPixel, padfLine, padfHeight, dfHeight,
+		padfLongitude, padfLatitude, panSuccess);
+}
+
+/**
+* \brief ScanSAR burst number and beam index of nCount RCM image points
+*
+* padfPixel/padfLine are pixel/line coordinates of the dataset, rounded
+* to the nearest full resolution pixel. panBurst receives the burst
+* number and panBeam, if not NULL, the 1 based beam index named by
+* GDALGetRCMBeamName(). Both are 0 outside every burst.
+*
+* @return nCount, or 0 if the dataset is not RCM or has no burst map.
+*/
+int CPL_DLL CPL_STDCALL GDALGetRCMBurstIds(GDALDatasetH hDS, int nCount, const double *padfPixel, const double *padfLine, int *panBurst, int *panBeam)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMBurstIds", 0);
+	VALIDATE_POINTER1(padfPixel, "GDALGetRCMBurstIds", 0);
+	VALIDATE_POINTER1(padfLine, "GDALGetRCMBurstIds", 0);
+	VALIDATE_POINTER1(panBurst, "GDALGetRCMBurstIds", 0);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL || nCount <= 0)
+		return 0;
+
+	if (rcmDataset->GetBurstIds(nCount, padfPixel, padfLine, panBurst, panBeam) != CE_None)
+		return 0;
+
+	return nCount;
+}
+
+/**
+* \brief Name of a beam index returned by GDALGetRCMBurstIds()
+*
+* @return the beam name, such as "DVWF1", or NULL if the index is unknown.
+*/
+const char CPL_DLL * CPL_STDCALL GDALGetRCMBeamName(GDALDatasetH hDS, int nBeam)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMBeamName", NULL);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (rcmDataset == NULL)
+		return NULL;
+
+	return rcmDataset->GetBurstMap()->GetBeamName(nBeam);
+}
+
+/**
+* \brief Incidence angles of one line of an RCM dataset, without a copy
+*
+* Unlike GDALGetRasterGetIncidenceAngles(), which copies the full
+* resolution table, this returns the angle in degrees of each of the
+* GetRasterXSize() pixels of the dataset, at the centre of the looks when
+* multilooked. The angle is the same on every line. The array belongs to
+* the dataset and stays valid until it is closed; do not free it.
+*
+* @return the angles, or NULL if the dataset is not RCM or has no
+* incidence angle table. *pnCount receives the number of angles.
+*/
+const double CPL_DLL * CPL_STDCALL GDALGetRCMIncidenceAngleRow(GDALDatasetH hDS, int *pnCount)
+{
+	VALIDATE_POINTER1(hDS, "GDALGetRCMIncidenceAngleRow", NULL);
+
+	RCMDataset *rcmDataset = dynamic_cast<RCMDataset*>(static_cast<GDALDataset *>(hDS));
+
+	if (pnCount != NULL)
+		*pnCount = 0;
+
+	if (rcmDataset == NULL)
+		return NULL;
+
+	const double *padfAngles = rcmDataset->GetIncidenceAngleRow();
+	if (padfAngles != NULL && pnCount != NULL)
+		*pnCount = rcmDataset->GetRasterXSize();
+
+	return padfAngles;
+}
@@ -49,6 +49,7 @@
 #include "cpl_string.h"
 #include "cpl_virtualmem.h"
 #include "cpl_vsi.h"
+#include "cpl_worker_thread_pool.h"
 #include "gdal.h"
 #include "gdal_rat.h"
 #include "gdal_priv_templates.hpp"
@@ -1594,6 +1595,9 @@ int CPL_STDCALL GDALGetCalibration(GDALRasterBandH hBand)
 			case eCalibration::Gamma:
 				calib_number = 3;
 				break;
+			case eCalibration::Gamma0Ellipsoid:
+				calib_number = 4;
+				break;
 			default:
 				calib_number = 0;
 				break;
@@ -3812,6 +3816,463 @@ static inline void ComputeFloatNoDataValue( GDALDataType eDataType,
     }
 }
 
+/************************************************************************/
+/*                 Float32 / CInt16 / CFloat32 kernels                  */
+/************************************************************************/
+
+// Statistics and histogram of the blocks of GDT_Float32, GDT_CInt16 and
+// GDT_CFloat32 bands, such as the calibrated and complex bands of SAR
+// drivers. The statistics take the real part of a complex pixel, as
+// GetPixelValue() does, or its magnitude with GDAL_STATS_COMPLEX=MAGNITUDE,
+// recorded as STATISTICS_COMPLEX=MAGNITUDE next to the stored statistics.
+// The histogram always takes the magnitude, and GetHistogramDB() bins
+// 10*log10 of the intensity (value, or squared magnitude), with dfMin and
+// dfMax in dB. Pixels are converted to double 2 at a time with SSE2 on
+// x86_64. The blocks of a batch are shared by GDAL_NUM_THREADS threads,
+// the I/O stays on the calling thread.
+
+#if defined(__x86_64__) || defined(_M_X64)
+#define GDAL_FLOAT_STATS_SSE2
+#include <emmintrin.h>
+#endif
+
+namespace {
+
+struct GDALFloatStats
+{
+    GUIntBig nSampleCount = 0;
+    GUIntBig nValidCount = 0;
+    double dfMin = std::numeric_limits<double>::infinity();
+    double dfMax = -std::numeric_limits<double>::infinity();
+    double dfMean = 0.0;
+    double dfM2 = 0.0;   // Sum of squared differences to dfMean
+
+    // Pairwise update of Chan et al. Algebraically the Welford update, the
+    // results agree with the sequential loop to rounding.
+    void Merge( const GDALFloatStats& other )
+    {
+        nSampleCount += other.nSampleCount;
+        if( other.nValidCount == 0 )
+            return;
+
+        const double dfCount = static_cast<double>(nValidCount);
+        const double dfOtherCount = static_cast<double>(other.nValidCount);
+        const double dfTotal = dfCount + dfOtherCount;
+        const double dfDelta = other.dfMean - dfMean;
+
+        dfMean += dfDelta * dfOtherCount / dfTotal;
+        dfM2 += other.dfM2 + dfDelta * dfDelta * dfCount * dfOtherCount / dfTotal;
+        nValidCount += other.nValidCount;
+        dfMin = std::min(dfMin, other.dfMin);
+        dfMax = std::max(dfMax, other.dfMax);
+    }
+};
+
+struct GDALFloatKernelJob
+{
+    // Block
+    const void *pData = nullptr;
+    GDALDataType eDataType = GDT_Unknown;
+    int nXCheck = 0;
+    int nYCheck = 0;
+    int nBlockXSize = 0;
+
+    // Pixel value
+    bool bMagnitude = false;
+    bool bGotNoDataValue = false;
+    double dfNoDataValue = 0.0;
+    bool bGotFloatNoDataValue = false;
+    float fNoDataValue = 0.0f;
+
+    // Statistics result
+    GDALFloatStats sStats;
+
+    // Histogram, private to the job
+    std::vector<GUIntBig> anHistogram;
+    double dfHistMin = 0.0;
+    double dfHistScale = 0.0;
+    bool bIncludeOutOfRange = false;
+    bool bDB = false;
+};
+
+// Value of pixel i as double, NaN when invalid for the statistics
+static inline double GDALFloatKernelValue( const GDALFloatKernelJob& sJob,
+                                           const void *pLine, int i )
+{
+    switch( sJob.eDataType )
+    {
+        case GDT_Float32:
+            return static_cast<const float *>(pLine)[i];
+        case GDT_CInt16:
+        {
+            const double dfReal = static_cast<const GInt16 *>(pLine)[2 * i];
+            if( !sJob.bMagnitude )
+                return dfReal;
+            const double dfImag = static_cast<const GInt16 *>(pLine)[2 * i + 1];
+            return sqrt( dfReal * dfReal + dfImag * dfImag );
+        }
+        default:
+        {
+            const double dfReal = static_cast<const float *>(pLine)[2 * i];
+            if( !sJob.bMagnitude )
+                return dfReal;
+            const double dfImag = static_cast<const float *>(pLine)[2 * i + 1];
+            return sqrt( dfReal * dfReal + dfImag * dfImag );
+        }
+    }
+}
+
+// Values of a line of nXCheck pixels into padfValues
+static void GDALFloatKernelLine( const GDALFloatKernelJob& sJob,
+                                 const void *pLine, double *padfValues )
+{
+    int i = 0;
+#ifdef GDAL_FLOAT_STATS_SSE2
+    const int nPairs = sJob.nXCheck / 2;
+    switch( sJob.eDataType )
+    {
+        case GDT_Float32:
+        {
+            const float *pafLine = static_cast<const float *>(pLine);
+            for( ; i < 2 * nPairs; i += 2 )
+            {
+                const __m128 v = _mm_castsi128_ps(
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(pafLine + i)));
+                _mm_storeu_pd(padfValues + i, _mm_cvtps_pd(v));
+            }
+            break;
+        }
+        case GDT_CInt16:
+        {
+            const GInt16 *panLine = static_cast<const GInt16 *>(pLine);
+            for( ; i < 2 * nPairs; i += 2 )
+            {
+                // re0 im0 re1 im1 sign extended to 32 bit
+                const __m128i v16 =
+                    _mm_loadl_epi64(reinterpret_cast<const __m128i *>(panLine + 2 * i));
+                const __m128i v32 = _mm_srai_epi32(_mm_unpacklo_epi16(v16, v16), 16);
+                const __m128d re = _mm_cvtepi32_pd(
+                    _mm_shuffle_epi32(v32, _MM_SHUFFLE(3, 1, 2, 0)));
+                if( !sJob.bMagnitude )
+                {
+                    _mm_storeu_pd(padfValues + i, re);
+                    continue;
+                }
+                const __m128d im = _mm_cvtepi32_pd(
+                    _mm_shuffle_epi32(v32, _MM_SHUFFLE(2, 0, 3, 1)));
+                _mm_storeu_pd(padfValues + i, _mm_sqrt_pd(
+                    _mm_add_pd(_mm_mul_pd(re, re), _mm_mul_pd(im, im))));
+            }
+            break;
+        }
+        default:
+        {
+            const float *pafLine = static_cast<const float *>(pLine);
+            for( ; i < 2 * nPairs; i += 2 )
+            {
+                // re0 im0 re1 im1
+                const __m128 v = _mm_loadu_ps(pafLine + 2 * i);
+                const __m128d re = _mm_cvtps_pd(
+                    _mm_shuffle_ps(v, v, _MM_SHUFFLE(3, 1, 2, 0)));
+                if( !sJob.bMagnitude )
+                {
+                    _mm_storeu_pd(padfValues + i, re);
+                    continue;
+                }
+                const __m128d im = _mm_cvtps_pd(
+                    _mm_shuffle_ps(v, v, _MM_SHUFFLE(2, 0, 3, 1)));
+                _mm_storeu_pd(padfValues + i, _mm_sqrt_pd(
+                    _mm_add_pd(_mm_mul_pd(re, re), _mm_mul_pd(im, im))));
+            }
+            break;
+        }
+    }
+#endif
+    for( ; i < sJob.nXCheck; i++ )
+        padfValues[i] = GDALFloatKernelValue(sJob, pLine, i);
+}
+
+static inline bool GDALFloatKernelIsNoData( const GDALFloatKernelJob& sJob,
+                                            double dfValue )
+{
+    if( sJob.bGotFloatNoDataValue )
+        return ARE_REAL_EQUAL(static_cast<float>(dfValue), sJob.fNoDataValue);
+    return sJob.bGotNoDataValue && ARE_REAL_EQUAL(dfValue, sJob.dfNoDataValue);
+}
+
+/************************************************************************/
+/*                       GDALFloatStatsBlock()                          */
+/************************************************************************/
+
+static void GDALFloatStatsBlock( void *pData )
+{
+    GDALFloatKernelJob& sJob = *static_cast<GDALFloatKernelJob *>(pData);
+    const int nPixelSize = GDALGetDataTypeSizeBytes(sJob.eDataType);
+    const bool bNoData = sJob.bGotNoDataValue || sJob.bGotFloatNoDataValue;
+
+    std::vector<double> adfValues(sJob.nXCheck);
+    GDALFloatStats sStats;
+
+    // Sums of the differences to the first valid value, which keeps the
+    // sum of squares accurate when the mean is large against the spread.
+    bool bHaveShift = false;
+    double dfShift = 0.0;
+    double dfSum = 0.0;
+    double dfSum2 = 0.0;
+    double dfMin = std::numeric_limits<double>::infinity();
+    double dfMax = -dfMin;
+    GUIntBig nValid = 0;
+
+    for( int iY = 0; iY < sJob.nYCheck; iY++ )
+    {
+        const GByte *pabyLine = static_cast<const GByte *>(sJob.pData) +
+            static_cast<size_t>(iY) * sJob.nBlockXSize * nPixelSize;
+        GDALFloatKernelLine(sJob, pabyLine, adfValues.data());
+
+        int iX = 0;
+        if( !bHaveShift )
+        {
+            for( ; iX < sJob.nXCheck; iX++ )
+            {
+                const double dfValue = adfValues[iX];
+                if( CPLIsNan(dfValue) || (bNoData && GDALFloatKernelIsNoData(sJob, dfValue)) )
+                    continue;
+                dfShift = dfValue;
+                bHaveShift = true;
+                break;
+            }
+        }
+
+#ifdef GDAL_FLOAT_STATS_SSE2
+        if( !bNoData && bHaveShift )
+        {
+            const __m128d shift = _mm_set1_pd(dfShift);
+            const __m128d one = _mm_set1_pd(1.0);
+            const __m128d inf = _mm_set1_pd(std::numeric_limits<double>::infinity());
+            const __m128d minusInf = _mm_set1_pd(-std::numeric_limits<double>::infinity());
+            __m128d sum = _mm_setzero_pd();
+            __m128d sum2 = _mm_setzero_pd();
+            __m128d count = _mm_setzero_pd();
+            __m128d vmin = inf;
+            __m128d vmax = minusInf;
+            for( ; iX + 1 < sJob.nXCheck; iX += 2 )
+            {
+                const __m128d v = _mm_loadu_pd(adfValues.data() + iX);
+                const __m128d valid = _mm_cmpord_pd(v, v);
+                const __m128d d = _mm_and_pd(valid, _mm_sub_pd(v, shift));
+                sum = _mm_add_pd(sum, d);
+                sum2 = _mm_add_pd(sum2, _mm_mul_pd(d, d));
+                count = _mm_add_pd(count, _mm_and_pd(valid, one));
+                vmin = _mm_min_pd(vmin, _mm_or_pd(_mm_and_pd(valid, v), _mm_andnot_pd(valid, inf)));
+                vmax = _mm_max_pd(vmax, _mm_or_pd(_mm_and_pd(valid, v), _mm_andnot_pd(valid, minusInf)));
+            }
+
+            double adfSum[2], adfSum2[2], adfCount[2], adfMin[2], adfMax[2];
+            _mm_storeu_pd(adfSum, sum);
+            _mm_storeu_pd(adfSum2, sum2);
+            _mm_storeu_pd(adfCount, count);
+            _mm_storeu_pd(adfMin, vmin);
+            _mm_storeu_pd(adfMax, vmax);
+            dfSum += adfSum[0] + adfSum[1];
+            dfSum2 += adfSum2[0] + adfSum2[1];
+            nValid += static_cast<GUIntBig>(adfCount[0] + adfCount[1]);
+            dfMin = std::min(dfMin, std::min(adfMin[0], adfMin[1]));
+            dfMax = std::max(dfMax, std::max(adfMax[0], adfMax[1]));
+        }
+#endif
+
+        for( ; iX < sJob.nXCheck; iX++ )
+        {
+            const double dfValue = adfValues[iX];
+            if( CPLIsNan(dfValue) || (bNoData && GDALFloatKernelIsNoData(sJob, dfValue)) )
+                continue;
+            const double dfDelta = dfValue - dfShift;
+            dfSum += dfDelta;
+            dfSum2 += dfDelta * dfDelta;
+            nValid++;
+            dfMin = std::min(dfMin, dfValue);
+            dfMax = std::max(dfMax, dfValue);
+        }
+    }
+
+    sStats.nSampleCount = static_cast<GUIntBig>(sJob.nXCheck) * sJob.nYCheck;
+    sStats.nValidCount = nValid;
+    if( nValid > 0 )
+    {
+        const double dfCount = static_cast<double>(nValid);
+        sStats.dfMin = dfMin;
+        sStats.dfMax = dfMax;
+        sStats.dfMean = dfShift + dfSum / dfCount;
+        sStats.dfM2 = std::max(0.0, dfSum2 - dfSum * dfSum / dfCount);
+    }
+    sJob.sStats = sStats;
+}
+
+/************************************************************************/
+/*                      GDALFloatHistogramBlock()                       */
+/************************************************************************/
+
+static void GDALFloatHistogramBlock( void *pData )
+{
+    GDALFloatKernelJob& sJob = *static_cast<GDALFloatKernelJob *>(pData);
+    const int nPixelSize = GDALGetDataTypeSizeBytes(sJob.eDataType);
+    const bool bComplex = sJob.eDataType != GDT_Float32;
+    const int nBuckets = static_cast<int>(sJob.anHistogram.size());
+    GUIntBig *panHistogram = sJob.anHistogram.data();
+
+    std::vector<double> adfValues(sJob.nXCheck);
+    for( int iY = 0; iY < sJob.nYCheck; iY++ )
+    {
+        const GByte *pabyLine = static_cast<const GByte *>(sJob.pData) +
+            static_cast<size_t>(iY) * sJob.nBlockXSize * nPixelSize;
+        GDALFloatKernelLine(sJob, pabyLine, adfValues.data());
+
+        for( int iX = 0; iX < sJob.nXCheck; iX++ )
+        {
+            double dfValue = adfValues[iX];
+            if( CPLIsNan(dfValue) || GDALFloatKernelIsNoData(sJob, dfValue) )
+                continue;
+
+            if( sJob.bDB )
+            {
+                // Power in dB, 20*log10 of a magnitude
+                dfValue = dfValue > 0.0 ?
+                    (bComplex ? 20.0 : 10.0) * log10(dfValue) :
+                    -std::numeric_limits<double>::infinity();
+            }
+
+            const double dfIndex = floor((dfValue - sJob.dfHistMin) * sJob.dfHistScale);
+            if( dfIndex < 0 )
+            {
+                if( sJob.bIncludeOutOfRange )
+                    ++panHistogram[0];
+            }
+            else if( dfIndex >= nBuckets )
+            {
+                if( sJob.bIncludeOutOfRange )
+                    ++panHistogram[nBuckets - 1];
+            }
+            else
+            {
+                ++panHistogram[static_cast<int>(dfIndex)];
+            }
+        }
+    }
+}
+
+/************************************************************************/
+/*                      GDALFloatKernelBlocks()                         */
+/************************************************************************/
+
+// Run pfnKernel on every nSampleRate-th block, one batch of asJobs.size()
+// blocks at a time. The blocks are locked and read on the calling thread,
+// their statistics merged in block order into psStats if not null.
+static CPLErr GDALFloatKernelBlocks( GDALRasterBand *poBand,
+                                     int nBlocksPerRow, int nBlocksPerColumn,
+                                     int nSampleRate,
+                                     std::vector<GDALFloatKernelJob>& asJobs,
+                                     CPLWorkerThreadPool *poPool,
+                                     void (*pfnKernel)(void *),
+                                     GDALFloatStats *psStats,
+                                     const char *pszMessage,
+                                     GDALProgressFunc pfnProgress,
+                                     void *pProgressData )
+{
+    int nBlockXSize = 0;
+    int nBlockYSize = 0;
+    poBand->GetBlockSize(&nBlockXSize, &nBlockYSize);
+
+    const int nBlocks = nBlocksPerRow * nBlocksPerColumn;
+    const int nBatch = static_cast<int>(asJobs.size());
+    std::vector<GDALRasterBlock *> apoBlocks(nBatch);
+
+    for( int iSampleBlock = 0; iSampleBlock < nBlocks; )
+    {
+        int nJobs = 0;
+        CPLErr eErr = CE_None;
+        for( ; nJobs < nBatch && iSampleBlock < nBlocks;
+             nJobs++, iSampleBlock += nSampleRate )
+        {
+            const int iYBlock = iSampleBlock / nBlocksPerRow;
+            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
+
+            apoBlocks[nJobs] = poBand->GetLockedBlockRef( iXBlock, iYBlock );
+            if( apoBlocks[nJobs] == nullptr )
+            {
+                eErr = CE_Failure;
+                break;
+            }
+
+            GDALFloatKernelJob& sJob = asJobs[nJobs];
+            sJob.pData = apoBlocks[nJobs]->GetDataRef();
+            sJob.nBlockXSize = nBlockXSize;
+            poBand->GetActualBlockSize(iXBlock, iYBlock, &sJob.nXCheck, &sJob.nYCheck);
+        }
+
+        if( eErr == CE_None )
+        {
+            for( int i = 0; i < nJobs; i++ )
+            {
+                if( poPool != nullptr && nJobs > 1 )
+                    poPool->SubmitJob(pfnKernel, &asJobs[i]);
+                else
+                    pfnKernel(&asJobs[i]);
+            }
+            if( poPool != nullptr && nJobs > 1 )
+                poPool->WaitCompletion();
+
+            for( int i = 0; psStats != nullptr && i < nJobs; i++ )
+                psStats->Merge(asJobs[i].sStats);
+        }
+
+        for( int i = 0; i < nJobs; i++ )
+            apoBlocks[i]->DropLock();
+
+        if( eErr != CE_None )
+            return eErr;
+
+        if( !pfnProgress( std::min(iSampleBlock, nBlocks) / static_cast<double>(nBlocks),
+                          pszMessage, pProgressData ) )
+        {
+            CPLError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+            return CE_Failure;
+        }
+    }
+
+    return CE_None;
+}
+
+// Worker threads of GDAL_NUM_THREADS, nullptr if only one
+static CPLWorkerThreadPool *GDALCreateFloatKernelPool( int& nThreads )
+{
+    nThreads = RCMGetThreadCount(nullptr);
+    if( nThreads == 1 )
+        return nullptr;
+
+    CPLWorkerThreadPool *poPool = new CPLWorkerThreadPool();
+    if( !poPool->Setup(nThreads, nullptr, nullptr) )
+    {
+        delete poPool;
+        nThreads = 1;
+        return nullptr;
+    }
+    return poPool;
+}
+
+} // namespace
+
+// "MAGNITUDE" when the statistics of this data type are those of the
+// magnitude (GDAL_STATS_COMPLEX=MAGNITUDE), nullptr for the real part or
+// real data. Stored as STATISTICS_COMPLEX so that cached statistics are
+// only reused in the same mode.
+static const char *GDALGetStatsComplexMode( GDALDataType eDataType )
+{
+    if( (eDataType == GDT_CInt16 || eDataType == GDT_CFloat32) &&
+        EQUAL(CPLGetConfigOption("GDAL_STATS_COMPLEX", "REAL"), "MAGNITUDE") )
+        return "MAGNITUDE";
+    return nullptr;
+}
+
 /************************************************************************/
 /*                            GetHistogram()                            */
 /************************************************************************/
@@ -3838,6 +4299,10 @@ static inline void ComputeFloatNoDataValue( GDALDataType eDataType,
  * in generating histogram based luts for instance.  Generally bApproxOK is
  * much faster than an exactly computed histogram.
  *
+ * Complex pixels are binned by magnitude. GetHistogramDB() bins the
+ * intensity in dB instead. Float32, CInt16 and CFloat32 blocks are
+ * processed by GDAL_NUM_THREADS threads.
+ *
  * This method is the same as the C functions GDALGetRasterHistogram() and
  * GDALGetRasterHistogramEx().
  *
@@ -3861,6 +4326,55 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                                      GDALProgressFunc pfnProgress,
                                      void *pProgressData )
 
+{
+    return ComputeHistogram( dfMin, dfMax, nBuckets, panHistogram,
+                             bIncludeOutOfRange, bApproxOK, false,
+                             pfnProgress, pProgressData );
+}
+
+/************************************************************************/
+/*                           GetHistogramDB()                           */
+/************************************************************************/
+
+/**
+ * \brief Compute raster histogram of the intensity in dB.
+ *
+ * Same as GetHistogram(), but 10*log10 of the intensity (the value of a
+ * real pixel, the squared magnitude of a complex one) is binned, and dfMin
+ * and dfMax are in dB. Pixels with no positive intensity are below the range.
+ *
+ * Unlike GetHistogram() this method is not virtual: the result is never
+ * served from nor saved to a driver or PAM histogram cache, where it would
+ * be mistaken for a linear histogram with the same bounds.
+ *
+ * This method is the same as the C function GDALGetRasterHistogramDB().
+ *
+ * @return CE_None on success, or CE_Failure if something goes wrong.
+ */
+
+CPLErr GDALRasterBand::GetHistogramDB( double dfMin, double dfMax,
+                                       int nBuckets, GUIntBig *panHistogram,
+                                       int bIncludeOutOfRange, int bApproxOK,
+                                       GDALProgressFunc pfnProgress,
+                                       void *pProgressData )
+
+{
+    return ComputeHistogram( dfMin, dfMax, nBuckets, panHistogram,
+                             bIncludeOutOfRange, bApproxOK, true,
+                             pfnProgress, pProgressData );
+}
+
+/************************************************************************/
+/*                          ComputeHistogram()                          */
+/************************************************************************/
+
+CPLErr GDALRasterBand::ComputeHistogram( double dfMin, double dfMax,
+                                         int nBuckets, GUIntBig *panHistogram,
+                                         int bIncludeOutOfRange, int bApproxOK,
+                                         bool bDB,
+                                         GDALProgressFunc pfnProgress,
+                                         void *pProgressData )
+
 {
     CPLAssert( nullptr != panHistogram );
 
@@ -3877,6 +4391,13 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
         // does?
         GDALRasterBand *poBestOverview = GetRasterSampleOverview( 0 );
 
+        if( poBestOverview != this && bDB )
+        {
+            return poBestOverview->GetHistogramDB( dfMin, dfMax, nBuckets,
+                                                   panHistogram,
+                                                   bIncludeOutOfRange, bApproxOK,
+                                                   pfnProgress, pProgressData );
+        }
         if( poBestOverview != this )
         {
             return poBestOverview->GetHistogram( dfMin, dfMax, nBuckets,
@@ -3917,6 +4438,9 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
     const bool bSignedByte =
         pszPixelType != nullptr && EQUAL(pszPixelType, "SIGNEDBYTE");
 
+    // Complex values are magnitudes, their power is 20*log10
+    const double dfDBFactor = GDALDataTypeIsComplex(eDataType) ? 20.0 : 10.0;
+
     if ( bApproxOK && HasArbitraryOverviews() )
     {
 /* -------------------------------------------------------------------- */
@@ -4051,6 +4575,17 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                     bGotNoDataValue && ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
                     continue;
 
+                if( bDB )
+                {
+                    if( !(dfValue > 0.0) )
+                    {
+                        if( bIncludeOutOfRange )
+                            panHistogram[0]++;
+                        continue;
+                    }
+                    dfValue = dfDBFactor * log10(dfValue);
+                }
+
                 const int nIndex =
                     static_cast<int>(floor((dfValue - dfMin) * dfScale));
 
@@ -4097,6 +4632,49 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
               nSampleRate += 1;
         }
 
+/* -------------------------------------------------------------------- */
+/*      Float32 and complex blocks go to the threaded kernels.          */
+/* -------------------------------------------------------------------- */
+        if( eDataType == GDT_Float32 || eDataType == GDT_CInt16 ||
+            eDataType == GDT_CFloat32 )
+        {
+            int nThreads = 1;
+            CPLWorkerThreadPool *poPool = GDALCreateFloatKernelPool(nThreads);
+
+            std::vector<GDALFloatKernelJob> asJobs(nThreads);
+            for( auto& sJob : asJobs )
+            {
+                sJob.eDataType = eDataType;
+                sJob.bMagnitude = true;
+                sJob.bGotNoDataValue = CPL_TO_BOOL(bGotNoDataValue);
+                sJob.dfNoDataValue = dfNoDataValue;
+                sJob.bGotFloatNoDataValue = bGotFloatNoDataValue;
+                sJob.fNoDataValue = fNoDataValue;
+                sJob.anHistogram.assign(nBuckets, 0);
+                sJob.dfHistMin = dfMin;
+                sJob.dfHistScale = dfScale;
+                sJob.bIncludeOutOfRange = CPL_TO_BOOL(bIncludeOutOfRange);
+                sJob.bDB = bDB;
+            }
+
+            const CPLErr eErr = GDALFloatKernelBlocks(
+                this, nBlocksPerRow, nBlocksPerColumn, nSampleRate, asJobs,
+                poPool, GDALFloatHistogramBlock, nullptr,
+                "Compute Histogram", pfnProgress, pProgressData );
+            delete poPool;
+            if( eErr != CE_None )
+                return eErr;
+
+            for( const auto& sJob : asJobs )
+            {
+                for( int i = 0; i < nBuckets; i++ )
+                    panHistogram[i] += sJob.anHistogram[i];
+            }
+
+            pfnProgress( 1.0, "Compute Histogram", pProgressData );
+            return CE_None;
+        }
+
 /* -------------------------------------------------------------------- */
 /*      Read the blocks, and add to histogram.                          */
 /* -------------------------------------------------------------------- */
@@ -4123,7 +4701,7 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
             GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
 
             // this is a special case for a common situation.
-            if( eDataType == GDT_Byte && !bSignedByte
+            if( eDataType == GDT_Byte && !bSignedByte && !bDB
                 && dfScale == 1.0 && (dfMin >= -0.5 && dfMin <= 0.5)
                 && nYCheck == nBlockYSize && nXCheck == nBlockXSize
                 && nBuckets == 256 )
@@ -4236,6 +4814,17 @@ CPLErr GDALRasterBand::GetHistogram( double dfMin, double dfMax,
                         ARE_REAL_EQUAL(dfValue, dfNoDataValue) )
                         continue;
 
+                    if( bDB )
+                    {
+                        if( !(dfValue > 0.0) )
+                        {
+                            if( bIncludeOutOfRange )
+                                ++panHistogram[0];
+                            continue;
+                        }
+                        dfValue = dfDBFactor * log10(dfValue);
+                    }
+
                     const int nIndex =
                         static_cast<int>(floor((dfValue - dfMin) * dfScale));
 
@@ -4364,6 +4953,35 @@ GDALGetRasterHistogramEx( GDALRasterBandH hBand,
                                  pfnProgress, pProgressData );
 }
 
+/************************************************************************/
+/*                      GDALGetRasterHistogramDB()                      */
+/************************************************************************/
+
+/**
+ * \brief Compute raster histogram of the intensity in dB.
+ *
+ * @see GDALRasterBand::GetHistogramDB()
+ */
+
+CPLErr CPL_STDCALL
+GDALGetRasterHistogramDB( GDALRasterBandH hBand,
+                          double dfMin, double dfMax,
+                          int nBuckets, GUIntBig *panHistogram,
+                          int bIncludeOutOfRange, int bApproxOK,
+                          GDALProgressFunc pfnProgress,
+                          void *pProgressData )
+
+{
+    VALIDATE_POINTER1( hBand, "GDALGetRasterHistogramDB", CE_Failure );
+    VALIDATE_POINTER1( panHistogram, "GDALGetRasterHistogramDB", CE_Failure );
+
+    GDALRasterBand *poBand = GDALRasterBand::FromHandle(hBand);
+
+    return poBand->GetHistogramDB( dfMin, dfMax, nBuckets, panHistogram,
+                                   bIncludeOutOfRange, bApproxOK,
+                                   pfnProgress, pProgressData );
+}
+
 /************************************************************************/
 /*                        GetDefaultHistogram()                         */
 /************************************************************************/
@@ -4703,7 +5321,16 @@ CPLErr GDALRasterBand::GetStatistics( int bApproxOK, int bForce,
 /* -------------------------------------------------------------------- */
 /*      Do we already have metadata items for the requested values?     */
 /* -------------------------------------------------------------------- */
-    if( (pdfMin == nullptr || GetMetadataItem("STATISTICS_MINIMUM") != nullptr)
+    // Statistics of the magnitude are only reused in that mode, and
+    // those of the real part outside of it.
+    const char *pszStoredMode = GetMetadataItem("STATISTICS_COMPLEX");
+    const char *pszMode = GDALGetStatsComplexMode(eDataType);
+    const bool bSameMode =
+        pszStoredMode == nullptr ? pszMode == nullptr :
+        pszMode != nullptr && EQUAL(pszStoredMode, pszMode);
+
+    if( bSameMode
+     && (pdfMin == nullptr || GetMetadataItem("STATISTICS_MINIMUM") != nullptr)
      && (pdfMax == nullptr || GetMetadataItem("STATISTICS_MAXIMUM") != nullptr)
      && (pdfMean == nullptr || GetMetadataItem("STATISTICS_MEAN") != nullptr)
      && (pdfStdDev == nullptr || GetMetadataItem("STATISTICS_STDDEV") != nullptr) )
@@ -5802,6 +6429,13 @@ void GDALRasterBand::SetValidPercent(GUIntBig nSampleCount, GUIntBig nValidCount
  * Once computed, the statistics will generally be "set" back on the
  * raster band using SetStatistics().
  *
+ * The statistics of a complex band are those of the real part, or with the
+ * GDAL_STATS_COMPLEX=MAGNITUDE configuration option those of the magnitude
+ * for CInt16 and CFloat32 bands. The latter are stored with a
+ * STATISTICS_COMPLEX=MAGNITUDE item, and GetStatistics() only returns
+ * stored statistics computed in the current mode. Float32, CInt16 and
+ * CFloat32 blocks are processed by GDAL_NUM_THREADS threads.
+ *
  * This method is the same as the C function GDALComputeRasterStatistics().
  *
  * @param bApproxOK If TRUE statistics may be computed based on overviews
@@ -5854,6 +6488,8 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
                 if( pdfMin && pdfMax && pdfMean && pdfStdDev )
                 {
                     SetMetadataItem( "STATISTICS_APPROXIMATE", "YES" );
+                    SetMetadataItem( "STATISTICS_COMPLEX",
+                                     GDALGetStatsComplexMode(eDataType) );
                     SetStatistics( *pdfMin,*pdfMax, *pdfMean, *pdfStdDev );
                 }
 
@@ -6161,71 +6797,115 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         }
 #endif
 
-        for( int iSampleBlock = 0;
-             iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
-             iSampleBlock += nSampleRate )
+/* -------------------------------------------------------------------- */
+/*      Float32 and complex blocks go to the threaded kernels.          */
+/* -------------------------------------------------------------------- */
+        if( eDataType == GDT_Float32 || eDataType == GDT_CInt16 ||
+            eDataType == GDT_CFloat32 )
         {
-            const int iYBlock = iSampleBlock / nBlocksPerRow;
-            const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
-
-            GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
-            if( poBlock == nullptr )
-                return CE_Failure;
+            int nThreads = 1;
+            CPLWorkerThreadPool *poPool = GDALCreateFloatKernelPool(nThreads);
+            const bool bMagnitude =
+                GDALGetStatsComplexMode(eDataType) != nullptr;
 
-            void* const pData = poBlock->GetDataRef();
+            std::vector<GDALFloatKernelJob> asJobs(nThreads);
+            for( auto& sJob : asJobs )
+            {
+                sJob.eDataType = eDataType;
+                sJob.bMagnitude = bMagnitude;
+                sJob.bGotNoDataValue = CPL_TO_BOOL(bGotNoDataValue);
+                sJob.dfNoDataValue = dfNoDataValue;
+                sJob.bGotFloatNoDataValue = bGotFloatNoDataValue;
+                sJob.fNoDataValue = fNoDataValue;
+            }
 
-            int nXCheck = 0, nYCheck = 0;
-            GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+            GDALFloatStats sStats;
+            const CPLErr eErr = GDALFloatKernelBlocks(
+                this, nBlocksPerRow, nBlocksPerColumn, nSampleRate, asJobs,
+                poPool, GDALFloatStatsBlock, &sStats,
+                "Compute Statistics", pfnProgress, pProgressData );
+            delete poPool;
+            if( eErr != CE_None )
+                return eErr;
 
-            // This isn't the fastest way to do this, but is easier for now.
-            for( int iY = 0; iY < nYCheck; iY++ )
+            nSampleCount = sStats.nSampleCount;
+            nValidCount = sStats.nValidCount;
+            if( nValidCount > 0 )
             {
-                for( int iX = 0; iX < nXCheck; iX++ )
-                {
-                    const int iOffset = iX + iY * nBlockXSize;
-                    bool bValid = true;
-                    double dfValue = GetPixelValue( eDataType,
-                                                    bSignedByte,
-                                                    pData,
-                                                    iOffset,
-                                                    CPL_TO_BOOL(bGotNoDataValue),
-                                                    dfNoDataValue,
-                                                    bGotFloatNoDataValue,
-                                                    fNoDataValue,
-                                                    bValid );
+                dfMin = sStats.dfMin;
+                dfMax = sStats.dfMax;
+                dfMean = sStats.dfMean;
+                dfM2 = sStats.dfM2;
+            }
+        }
+        else
+        {
+            for( int iSampleBlock = 0;
+                 iSampleBlock < nBlocksPerRow * nBlocksPerColumn;
+                 iSampleBlock += nSampleRate )
+            {
+                const int iYBlock = iSampleBlock / nBlocksPerRow;
+                const int iXBlock = iSampleBlock - nBlocksPerRow * iYBlock;
 
-                    nSampleCount++;
-                    if( !bValid )
-                        continue;
+                GDALRasterBlock * const poBlock = GetLockedBlockRef( iXBlock, iYBlock );
+                if( poBlock == nullptr )
+                    return CE_Failure;
 
-                    if( bFirstValue )
-                    {
-                        dfMin = dfValue;
-                        dfMax = dfValue;
-                        bFirstValue = false;
-                    }
-                    else
+                void* const pData = poBlock->GetDataRef();
+
+                int nXCheck = 0, nYCheck = 0;
+                GetActualBlockSize(iXBlock, iYBlock, &nXCheck, &nYCheck);
+
+                // This isn't the fastest way to do this, but is easier for now.
+                for( int iY = 0; iY < nYCheck; iY++ )
+                {
+                    for( int iX = 0; iX < nXCheck; iX++ )
                     {
-                        dfMin = std::min(dfMin, dfValue);
-                        dfMax = std::max(dfMax, dfValue);
-                    }
+                        const int iOffset = iX + iY * nBlockXSize;
+                        bool bValid = true;
+                        double dfValue = GetPixelValue( eDataType,
+                                                        bSignedByte,
+                                                        pData,
+                                                        iOffset,
+                                                        CPL_TO_BOOL(bGotNoDataValue),
+                                                        dfNoDataValue,
+                                                        bGotFloatNoDataValue,
+                                                        fNoDataValue,
+                                                        bValid );
+
+                        nSampleCount++;
+                        if( !bValid )
+                            continue;
+
+                        if( bFirstValue )
+                        {
+                            dfMin = dfValue;
+                            dfMax = dfValue;
+                            bFirstValue = false;
+                        }
+                        else
+                        {
+                            dfMin = std::min(dfMin, dfValue);
+                            dfMax = std::max(dfMax, dfValue);
+                        }
 
-                    nValidCount++;
-                    const double dfDelta = dfValue - dfMean;
-                    dfMean += dfDelta / nValidCount;
-                    dfM2 += dfDelta * (dfValue - dfMean);
+                        nValidCount++;
+                        const double dfDelta = dfValue - dfMean;
+                        dfMean += dfDelta / nValidCount;
+                        dfM2 += dfDelta * (dfValue - dfMean);
+                    }
                 }
-            }
 
-            poBlock->DropLock();
+                poBlock->DropLock();
 
-            if ( !pfnProgress(
-                     iSampleBlock
-                         / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
-                     "Compute Statistics", pProgressData) )
-            {
-                ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
-                return CE_Failure;
+                if ( !pfnProgress(
+                         iSampleBlock
+                             / static_cast<double>(nBlocksPerRow*nBlocksPerColumn),
+                         "Compute Statistics", pProgressData) )
+                {
+                    ReportError( CE_Failure, CPLE_UserInterrupt, "User terminated" );
+                    return CE_Failure;
+                }
             }
         }
     }
@@ -6252,6 +6932,8 @@ GDALRasterBand::ComputeStatistics( int bApproxOK,
         {
             SetMetadataItem( "STATISTICS_APPROXIMATE",  nullptr );
         }
+        SetMetadataItem( "STATISTICS_COMPLEX",
+                         GDALGetStatsComplexMode(eDataType) );
         SetStatistics( dfMin, dfMax, dfMean, dfStdDev );
     }
 